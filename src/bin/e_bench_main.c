@@ -0,0 +1,782 @@
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <limits.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <ftw.h>
+#include <dirent.h>
+
+#include <Eina.h>
+#include <wayland-client.h>
+#include "xdg-shell-client-protocol.h"
+
+/* enlightenment_bench
+ *
+ * starts enlightenment on the wl_buffer (memory buffer) backend in a private
+ * XDG_RUNTIME_DIR and HOME, connects N synthetic wl_shm clients that commit a
+ * scripted damage pattern and reports frames/s, commit -> frame done latency
+ * percentiles and the compositor's RSS. no gpu or seat is needed so this can
+ * run on any build box.
+ *
+ * enlightenment is run directly, not through enlightenment_start: the
+ * launcher forks (and maybe re-execs through dbus-launch) so its pid is not
+ * the compositor's, for measuring or for stopping it. the HOME is seeded
+ * with a copy of a system profile so there is no first run wizard.
+ */
+
+#define POPUP_W      160
+#define POPUP_H      120
+#define POPUP_LIFE   4
+#define SCROLL_LINE  16
+
+typedef enum
+{
+   BENCH_PATTERN_VIDEO,
+   BENCH_PATTERN_SCROLL,
+   BENCH_PATTERN_POPUP
+} Bench_Pattern;
+
+typedef struct _Bench_Buffer  Bench_Buffer;
+typedef struct _Bench_Surface Bench_Surface;
+typedef struct _Bench_Client  Bench_Client;
+
+struct _Bench_Buffer
+{
+   struct wl_buffer *buffer;
+   uint32_t *data;
+   int busy;
+};
+
+struct _Bench_Surface
+{
+   Bench_Client *client;
+   struct wl_surface *surface;
+   struct xdg_surface *xdg_surface;
+   struct xdg_toplevel *xdg_toplevel;
+   struct wl_callback *frame_cb;
+   struct wl_shm_pool *pool;
+   Bench_Buffer buffers[2];
+   void *map;
+   size_t map_size;
+   int w, h;
+   int configured;
+   double commit_time;
+};
+
+struct _Bench_Client
+{
+   struct wl_display *display;
+   struct wl_registry *registry;
+   struct wl_compositor *compositor;
+   struct wl_shm *shm;
+   struct xdg_wm_base *wm_base;
+   Bench_Surface *main;
+   Bench_Surface *popups[POPUP_LIFE];
+   unsigned int frame;
+   int dead;
+};
+
+static Bench_Pattern pattern = BENCH_PATTERN_VIDEO;
+static int surface_w = 800, surface_h = 600;
+static double *latencies = NULL;
+static size_t latencies_num = 0, latencies_size = 0;
+static unsigned long long frames = 0;
+static int running = 1;
+
+static void _bench_surface_draw_commit(Bench_Surface *bs);
+
+static double
+_bench_time_get(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (double)ts.tv_sec + ((double)ts.tv_nsec / 1000000000.0);
+}
+
+static void
+_bench_latency_add(double l)
+{
+   if (latencies_num == latencies_size)
+     {
+        double *tmp;
+        size_t size = latencies_size ? latencies_size * 2 : 4096;
+
+        tmp = realloc(latencies, size * sizeof(double));
+        if (!tmp) return;
+        latencies = tmp;
+        latencies_size = size;
+     }
+   latencies[latencies_num++] = l;
+}
+
+static int
+_bench_latency_cmp(const void *a, const void *b)
+{
+   double da = *(const double *)a, db = *(const double *)b;
+
+   if (da < db) return -1;
+   if (da > db) return 1;
+   return 0;
+}
+
+static double
+_bench_latency_percentile(double p)
+{
+   size_t i;
+
+   if (!latencies_num) return 0.0;
+   i = (size_t)(p * (double)(latencies_num - 1));
+   return latencies[i];
+}
+
+static int
+_bench_shm_fd_new(size_t size)
+{
+   char path[PATH_MAX];
+   const char *dir;
+   int fd;
+
+   dir = getenv("XDG_RUNTIME_DIR");
+   if (!dir) dir = "/tmp";
+   snprintf(path, sizeof(path), "%s/e-bench-shm-XXXXXX", dir);
+   fd = mkostemp(path, O_CLOEXEC);
+   if (fd < 0) return -1;
+   unlink(path);
+   if (ftruncate(fd, size) < 0)
+     {
+        close(fd);
+        return -1;
+     }
+   return fd;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+static void
+_bench_buffer_cb_release(void *data, struct wl_buffer *buffer EINA_UNUSED)
+{
+   Bench_Buffer *bb = data;
+
+   bb->busy = 0;
+}
+
+static const struct wl_buffer_listener _bench_buffer_listener =
+{
+   _bench_buffer_cb_release
+};
+
+static void
+_bench_frame_cb_done(void *data, struct wl_callback *cb, uint32_t t EINA_UNUSED)
+{
+   Bench_Surface *bs = data;
+   Bench_Client *bc = bs->client;
+   int i;
+
+   wl_callback_destroy(cb);
+   bs->frame_cb = NULL;
+   _bench_latency_add(_bench_time_get() - bs->commit_time);
+   frames++;
+   if (!running) return;
+
+   bc->frame++;
+   if (pattern == BENCH_PATTERN_POPUP)
+     {
+        Bench_Surface *popup;
+
+        /* storm of short lived toplevels: one new, the oldest goes away */
+        popup = bc->popups[bc->frame % POPUP_LIFE];
+        if (popup)
+          {
+             for (i = 0; i < 2; i++)
+               if (popup->buffers[i].buffer) wl_buffer_destroy(popup->buffers[i].buffer);
+             if (popup->frame_cb) wl_callback_destroy(popup->frame_cb);
+             xdg_toplevel_destroy(popup->xdg_toplevel);
+             xdg_surface_destroy(popup->xdg_surface);
+             wl_surface_destroy(popup->surface);
+             wl_shm_pool_destroy(popup->pool);
+             munmap(popup->map, popup->map_size);
+             free(popup);
+          }
+        bc->popups[bc->frame % POPUP_LIFE] = NULL;
+     }
+   _bench_surface_draw_commit(bs);
+}
+
+static const struct wl_callback_listener _bench_frame_listener =
+{
+   _bench_frame_cb_done
+};
+
+static void
+_bench_xdg_surface_cb_configure(void *data, struct xdg_surface *xdg_surface, uint32_t serial)
+{
+   Bench_Surface *bs = data;
+
+   xdg_surface_ack_configure(xdg_surface, serial);
+   if (bs->configured) return;
+   bs->configured = 1;
+   _bench_surface_draw_commit(bs);
+}
+
+static const struct xdg_surface_listener _bench_xdg_surface_listener =
+{
+   _bench_xdg_surface_cb_configure
+};
+
+static void
+_bench_xdg_toplevel_cb_configure(void *data EINA_UNUSED, struct xdg_toplevel *xdg_toplevel EINA_UNUSED,
+                                 int32_t w EINA_UNUSED, int32_t h EINA_UNUSED,
+                                 struct wl_array *states EINA_UNUSED)
+{
+   /* we always keep our scripted size */
+}
+
+static void
+_bench_xdg_toplevel_cb_close(void *data, struct xdg_toplevel *xdg_toplevel EINA_UNUSED)
+{
+   Bench_Surface *bs = data;
+
+   bs->client->dead = 1;
+}
+
+static const struct xdg_toplevel_listener _bench_xdg_toplevel_listener =
+{
+   _bench_xdg_toplevel_cb_configure,
+   _bench_xdg_toplevel_cb_close
+};
+
+static Bench_Surface *
+_bench_surface_new(Bench_Client *bc, int w, int h, const char *title)
+{
+   Bench_Surface *bs;
+   size_t stride = w * 4;
+   int fd, i;
+
+   bs = calloc(1, sizeof(Bench_Surface));
+   if (!bs) return NULL;
+   bs->client = bc;
+   bs->w = w;
+   bs->h = h;
+   bs->map_size = stride * h * 2;
+   fd = _bench_shm_fd_new(bs->map_size);
+   if (fd < 0) goto err;
+   bs->map = mmap(NULL, bs->map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+   if (bs->map == MAP_FAILED)
+     {
+        close(fd);
+        goto err;
+     }
+   bs->pool = wl_shm_create_pool(bc->shm, fd, bs->map_size);
+   close(fd);
+   for (i = 0; i < 2; i++)
+     {
+        bs->buffers[i].data = (uint32_t *)((char *)bs->map + (i * stride * h));
+        bs->buffers[i].buffer =
+          wl_shm_pool_create_buffer(bs->pool, i * stride * h, w, h, stride,
+                                    WL_SHM_FORMAT_XRGB8888);
+        wl_buffer_add_listener(bs->buffers[i].buffer, &_bench_buffer_listener, &bs->buffers[i]);
+        memset(bs->buffers[i].data, 0x40, stride * h);
+     }
+
+   bs->surface = wl_compositor_create_surface(bc->compositor);
+   bs->xdg_surface = xdg_wm_base_get_xdg_surface(bc->wm_base, bs->surface);
+   xdg_surface_add_listener(bs->xdg_surface, &_bench_xdg_surface_listener, bs);
+   bs->xdg_toplevel = xdg_surface_get_toplevel(bs->xdg_surface);
+   xdg_toplevel_add_listener(bs->xdg_toplevel, &_bench_xdg_toplevel_listener, bs);
+   xdg_toplevel_set_title(bs->xdg_toplevel, title);
+   wl_surface_commit(bs->surface);
+   return bs;
+err:
+   free(bs);
+   return NULL;
+}
+
+static void
+_bench_surface_draw_commit(Bench_Surface *bs)
+{
+   Bench_Buffer *bb = NULL;
+   Bench_Client *bc = bs->client;
+   unsigned int col;
+   int i, x, y, rx, ry, rw, rh;
+
+   for (i = 0; i < 2; i++)
+     {
+        if (bs->buffers[i].busy) continue;
+        bb = &bs->buffers[i];
+        break;
+     }
+   /* both buffers still held by the compositor: just ask for the next frame */
+   if (!bb) bb = &bs->buffers[bc->frame & 1];
+
+   col = 0xff000000 | ((bc->frame * 0x030507) & 0x00ffffff);
+   if ((pattern == BENCH_PATTERN_SCROLL) && (bs == bc->main))
+     {
+        /* terminal-ish: scroll a region up by one line, draw a new line */
+        rx = bs->w / 8;
+        ry = bs->h / 8;
+        rw = bs->w / 2;
+        rh = bs->h / 2;
+        for (y = ry; y < ry + rh - SCROLL_LINE; y++)
+          memmove(bb->data + (y * bs->w) + rx,
+                  bb->data + ((y + SCROLL_LINE) * bs->w) + rx, rw * 4);
+        for (y = ry + rh - SCROLL_LINE; y < ry + rh; y++)
+          for (x = rx; x < rx + rw; x++)
+            bb->data[(y * bs->w) + x] = ((x / 8) & 1) ? col : 0xff000000;
+     }
+   else
+     {
+        rx = ry = 0;
+        rw = bs->w;
+        rh = bs->h;
+        for (i = 0; i < bs->w * bs->h; i++)
+          bb->data[i] = col;
+     }
+
+   wl_surface_attach(bs->surface, bb->buffer, 0, 0);
+   wl_surface_damage_buffer(bs->surface, rx, ry, rw, rh);
+   if (bs == bc->main)
+     {
+        bs->frame_cb = wl_surface_frame(bs->surface);
+        wl_callback_add_listener(bs->frame_cb, &_bench_frame_listener, bs);
+     }
+   bb->busy = 1;
+   bs->commit_time = _bench_time_get();
+   wl_surface_commit(bs->surface);
+
+   if ((pattern == BENCH_PATTERN_POPUP) && (bs == bc->main) &&
+       (!bc->popups[bc->frame % POPUP_LIFE]))
+     bc->popups[bc->frame % POPUP_LIFE] =
+       _bench_surface_new(bc, POPUP_W, POPUP_H, "bench popup");
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+static void
+_bench_wm_base_cb_ping(void *data EINA_UNUSED, struct xdg_wm_base *wm_base, uint32_t serial)
+{
+   xdg_wm_base_pong(wm_base, serial);
+}
+
+static const struct xdg_wm_base_listener _bench_wm_base_listener =
+{
+   _bench_wm_base_cb_ping
+};
+
+static void
+_bench_registry_cb_global(void *data, struct wl_registry *registry, uint32_t id,
+                          const char *interface, uint32_t version EINA_UNUSED)
+{
+   Bench_Client *bc = data;
+
+   if (!strcmp(interface, "wl_compositor"))
+     bc->compositor = wl_registry_bind(registry, id, &wl_compositor_interface, 4);
+   else if (!strcmp(interface, "wl_shm"))
+     bc->shm = wl_registry_bind(registry, id, &wl_shm_interface, 1);
+   else if (!strcmp(interface, "xdg_wm_base"))
+     {
+        bc->wm_base = wl_registry_bind(registry, id, &xdg_wm_base_interface, 1);
+        xdg_wm_base_add_listener(bc->wm_base, &_bench_wm_base_listener, bc);
+     }
+}
+
+static void
+_bench_registry_cb_global_remove(void *data EINA_UNUSED, struct wl_registry *registry EINA_UNUSED,
+                                 uint32_t id EINA_UNUSED)
+{
+}
+
+static const struct wl_registry_listener _bench_registry_listener =
+{
+   _bench_registry_cb_global,
+   _bench_registry_cb_global_remove
+};
+
+static Bench_Client *
+_bench_client_new(const char *socket, int num)
+{
+   Bench_Client *bc;
+   char title[64];
+
+   bc = calloc(1, sizeof(Bench_Client));
+   if (!bc) return NULL;
+   bc->display = wl_display_connect(socket);
+   if (!bc->display)
+     {
+        free(bc);
+        return NULL;
+     }
+   bc->registry = wl_display_get_registry(bc->display);
+   wl_registry_add_listener(bc->registry, &_bench_registry_listener, bc);
+   wl_display_roundtrip(bc->display);
+   if ((!bc->compositor) || (!bc->shm) || (!bc->wm_base))
+     {
+        fprintf(stderr, "enlightenment_bench: client %d missing globals\n", num);
+        wl_display_disconnect(bc->display);
+        free(bc);
+        return NULL;
+     }
+   snprintf(title, sizeof(title), "bench client %d", num);
+   bc->main = _bench_surface_new(bc, surface_w, surface_h, title);
+   wl_display_flush(bc->display);
+   return bc;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+static long
+_bench_rss_get(pid_t pid, const char *key)
+{
+   char buf[256], path[64];
+   FILE *f;
+   long kb = -1;
+   size_t len = strlen(key);
+
+   snprintf(path, sizeof(path), "/proc/%d/status", (int)pid);
+   f = fopen(path, "r");
+   if (!f) return -1;
+   while (fgets(buf, sizeof(buf), f))
+     {
+        if (strncmp(buf, key, len)) continue;
+        kb = strtol(buf + len, NULL, 10);
+        break;
+     }
+   fclose(f);
+   return kb;
+}
+
+static int
+_bench_file_copy(const char *src, const char *dst)
+{
+   char buf[65536];
+   ssize_t n;
+   int in, out, ret = 0;
+
+   in = open(src, O_RDONLY);
+   if (in < 0) return 0;
+   out = open(dst, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+   if (out >= 0)
+     {
+        while ((n = read(in, buf, sizeof(buf))) > 0)
+          if (write(out, buf, n) != n) break;
+        ret = (n == 0);
+        close(out);
+     }
+   close(in);
+   return ret;
+}
+
+/* copy the system profile's configs into HOME as the "bench" profile */
+static int
+_bench_home_seed(const char *home, const char *profile)
+{
+   DIR *dir;
+   struct dirent *de;
+   char src[PATH_MAX], dst[PATH_MAX + 256], path[PATH_MAX + 256];
+   const char *dirs[] = { ".e", ".e/e", ".e/e/config", ".e/e/config/bench" };
+   unsigned int i;
+   int n = 0;
+
+   for (i = 0; i < EINA_C_ARRAY_LENGTH(dirs); i++)
+     {
+        snprintf(dst, sizeof(dst), "%s/%s", home, dirs[i]);
+        if ((mkdir(dst, 0700) < 0) && (errno != EEXIST)) return 0;
+     }
+   snprintf(src, sizeof(src), "%s/data/config/%s", PACKAGE_DATA_DIR, profile);
+   dir = opendir(src);
+   if (!dir) return 0;
+   while ((de = readdir(dir)))
+     {
+        if (!eina_str_has_extension(de->d_name, ".cfg")) continue;
+        snprintf(path, sizeof(path), "%s/%s", src, de->d_name);
+        snprintf(dst, sizeof(dst), "%s/.e/e/config/bench/%s", home, de->d_name);
+        if (!_bench_file_copy(path, dst))
+          {
+             n = 0;
+             break;
+          }
+        n++;
+     }
+   closedir(dir);
+   return n > 0;
+}
+
+static int
+_bench_rm_cb(const char *path, const struct stat *st EINA_UNUSED, int flag EINA_UNUSED, struct FTW *ftw EINA_UNUSED)
+{
+   remove(path);
+   return 0;
+}
+
+static void
+_bench_dir_rm(const char *path)
+{
+   nftw(path, _bench_rm_cb, 16, FTW_DEPTH | FTW_PHYS);
+}
+
+static pid_t
+_bench_e_start(const char *runtime_dir, const char *home)
+{
+   char buf[PATH_MAX];
+   pid_t pid;
+
+   pid = fork();
+   if (pid) return pid;
+   /* own process group so stopping it also gets anything it spawned */
+   setpgid(0, 0);
+   setenv("XDG_RUNTIME_DIR", runtime_dir, 1);
+   setenv("HOME", home, 1);
+   setenv("E_CONF_PROFILE", "bench", 1);
+   setenv("E_WL_FORCE", "buffer", 1);
+   /* e refuses to run without this; there is no launcher to restart it or
+    * to signal, so E_START_MANAGER stays unset */
+   setenv("E_START", "enlightenment_bench", 1);
+   unsetenv("E_START_MANAGER");
+   /* the user dir is $E_HOME/e whatever the build's xdg setting */
+   snprintf(buf, sizeof(buf), "%s/.e", home);
+   setenv("E_HOME", buf, 1);
+   unsetenv("DISPLAY");
+   unsetenv("WAYLAND_DISPLAY");
+   execlp("enlightenment", "enlightenment", (char *)NULL);
+   fprintf(stderr, "enlightenment_bench: cannot exec enlightenment: %s\n",
+           strerror(errno));
+   _exit(-1);
+}
+
+static void
+_bench_e_stop(pid_t pid)
+{
+   double t0;
+
+   kill(-pid, SIGTERM);
+   t0 = _bench_time_get();
+   while (waitpid(pid, NULL, WNOHANG) == 0)
+     {
+        if (_bench_time_get() - t0 > 5.0)
+          {
+             kill(-pid, SIGKILL);
+             waitpid(pid, NULL, 0);
+             break;
+          }
+        usleep(50000);
+     }
+}
+
+static void
+_bench_usage(void)
+{
+   printf("Usage: enlightenment_bench [OPTIONS]\n"
+          "  -clients N         number of synthetic clients (default 4)\n"
+          "  -pattern PATTERN   video | scroll | popup (default video)\n"
+          "  -size WxH          client surface size (default 800x600)\n"
+          "  -time SECONDS      measurement duration (default 10)\n"
+          "  -warmup SECONDS    time to wait for the compositor (default 10)\n"
+          "  -profile PROFILE   system profile to seed the config from (default standard)\n");
+}
+
+static void
+_bench_cb_signal(int sig EINA_UNUSED)
+{
+   running = 0;
+}
+
+int
+main(int argc, char **argv)
+{
+   Bench_Client **clients = NULL;
+   struct pollfd *fds = NULL;
+   char base[PATH_MAX], runtime_dir[PATH_MAX + 8], home[PATH_MAX + 8];
+   char socket_path[PATH_MAX + 32];
+   const char *profile = "standard";
+   double duration = 10.0, warmup = 10.0, t0, t;
+   long rss, rss_peak;
+   int num = 4, i, connected = 0, ret = 1;
+   pid_t pid;
+
+   for (i = 1; i < argc; i++)
+     {
+        if ((!strcmp(argv[i], "-clients")) && (i < argc - 1))
+          num = atoi(argv[++i]);
+        else if ((!strcmp(argv[i], "-pattern")) && (i < argc - 1))
+          {
+             i++;
+             if (!strcmp(argv[i], "video")) pattern = BENCH_PATTERN_VIDEO;
+             else if (!strcmp(argv[i], "scroll")) pattern = BENCH_PATTERN_SCROLL;
+             else if (!strcmp(argv[i], "popup")) pattern = BENCH_PATTERN_POPUP;
+             else
+               {
+                  _bench_usage();
+                  return 1;
+               }
+          }
+        else if ((!strcmp(argv[i], "-size")) && (i < argc - 1))
+          {
+             if (sscanf(argv[++i], "%dx%d", &surface_w, &surface_h) != 2)
+               {
+                  _bench_usage();
+                  return 1;
+               }
+          }
+        else if ((!strcmp(argv[i], "-time")) && (i < argc - 1))
+          duration = atof(argv[++i]);
+        else if ((!strcmp(argv[i], "-warmup")) && (i < argc - 1))
+          warmup = atof(argv[++i]);
+        else if ((!strcmp(argv[i], "-profile")) && (i < argc - 1))
+          profile = argv[++i];
+        else
+          {
+             _bench_usage();
+             return (!strcmp(argv[i], "-h")) || (!strcmp(argv[i], "-help")) ? 0 : 1;
+          }
+     }
+   if ((num < 1) || (surface_w < 1) || (surface_h < 1) || (duration <= 0.0))
+     {
+        _bench_usage();
+        return 1;
+     }
+
+   snprintf(base, sizeof(base), "/tmp/e-bench-XXXXXX");
+   if (!mkdtemp(base))
+     {
+        perror("enlightenment_bench: mkdtemp");
+        return 1;
+     }
+   snprintf(runtime_dir, sizeof(runtime_dir), "%s/run", base);
+   snprintf(home, sizeof(home), "%s/home", base);
+   if ((mkdir(runtime_dir, 0700) < 0) || (mkdir(home, 0700) < 0) ||
+       (!_bench_home_seed(home, profile)))
+     {
+        fprintf(stderr, "enlightenment_bench: cannot seed profile '%s' from %s\n",
+                profile, PACKAGE_DATA_DIR);
+        _bench_dir_rm(base);
+        return 1;
+     }
+   setenv("XDG_RUNTIME_DIR", runtime_dir, 1);
+   signal(SIGINT, _bench_cb_signal);
+   signal(SIGPIPE, SIG_IGN);
+
+   pid = _bench_e_start(runtime_dir, home);
+   if (pid < 0)
+     {
+        perror("enlightenment_bench: fork");
+        _bench_dir_rm(base);
+        return 1;
+     }
+   /* also here, so there is no window where the group doesn't exist yet */
+   setpgid(pid, pid);
+
+   /* the first wayland socket in a fresh runtime dir is always wayland-0 */
+   snprintf(socket_path, sizeof(socket_path), "%s/wayland-0", runtime_dir);
+   t0 = _bench_time_get();
+   while (access(socket_path, F_OK))
+     {
+        if ((_bench_time_get() - t0 > warmup) || (waitpid(pid, NULL, WNOHANG) == pid))
+          {
+             fprintf(stderr, "enlightenment_bench: compositor did not come up\n");
+             goto out;
+          }
+        usleep(50000);
+     }
+   /* give e time to finish startup (modules, first frame) */
+   sleep(1);
+
+   clients = calloc(num, sizeof(Bench_Client *));
+   fds = calloc(num, sizeof(struct pollfd));
+   if ((!clients) || (!fds)) goto out;
+   for (i = 0; i < num; i++)
+     {
+        clients[i] = _bench_client_new("wayland-0", i);
+        if (clients[i]) connected++;
+     }
+   if (!connected)
+     {
+        fprintf(stderr, "enlightenment_bench: no client could connect\n");
+        goto out;
+     }
+
+   rss_peak = 0;
+   t0 = _bench_time_get();
+   /* ignore the mapping frames: only count what happens in the window */
+   frames = 0;
+   latencies_num = 0;
+   while (running)
+     {
+        int n = 0;
+
+        t = _bench_time_get();
+        if (t - t0 >= duration) break;
+        for (i = 0; i < num; i++)
+          {
+             if ((!clients[i]) || (clients[i]->dead)) continue;
+             while (wl_display_prepare_read(clients[i]->display) != 0)
+               wl_display_dispatch_pending(clients[i]->display);
+             wl_display_flush(clients[i]->display);
+             fds[n].fd = wl_display_get_fd(clients[i]->display);
+             fds[n].events = POLLIN;
+             fds[n].revents = 0;
+             n++;
+          }
+        if (!n) break;
+        if (poll(fds, n, 100) < 0)
+          {
+             if (errno != EINTR) break;
+          }
+        for (i = 0, n = 0; i < num; i++)
+          {
+             if ((!clients[i]) || (clients[i]->dead)) continue;
+             if (fds[n].revents & POLLIN)
+               wl_display_read_events(clients[i]->display);
+             else
+               wl_display_cancel_read(clients[i]->display);
+             if (fds[n].revents & (POLLERR | POLLHUP))
+               clients[i]->dead = 1;
+             else
+               wl_display_dispatch_pending(clients[i]->display);
+             n++;
+          }
+        rss = _bench_rss_get(pid, "VmRSS:");
+        if (rss > rss_peak) rss_peak = rss;
+     }
+   t = _bench_time_get() - t0;
+   rss = _bench_rss_get(pid, "VmRSS:");
+
+   qsort(latencies, latencies_num, sizeof(double), _bench_latency_cmp);
+   printf("pattern: %s clients: %d/%d size: %dx%d time: %1.2fs\n",
+          (pattern == BENCH_PATTERN_VIDEO) ? "video" :
+          (pattern == BENCH_PATTERN_SCROLL) ? "scroll" : "popup",
+          connected, num, surface_w, surface_h, t);
+   printf("frames: %llu (%1.1f frames/s, %1.1f per client)\n",
+          frames, (double)frames / t, (double)frames / t / connected);
+   printf("latency (ms): p50 %1.2f p90 %1.2f p99 %1.2f max %1.2f\n",
+          _bench_latency_percentile(0.50) * 1000.0,
+          _bench_latency_percentile(0.90) * 1000.0,
+          _bench_latency_percentile(0.99) * 1000.0,
+          _bench_latency_percentile(1.00) * 1000.0);
+   printf("compositor rss (KiB): %ld (peak %ld)\n", rss, rss_peak);
+
+   ret = 0;
+out:
+   if (clients)
+     {
+        for (i = 0; i < num; i++)
+          if (clients[i]) wl_display_disconnect(clients[i]->display);
+     }
+   _bench_e_stop(pid);
+   _bench_dir_rm(base);
+   free(latencies);
+   free(clients);
+   free(fds);
+   return ret;
+}
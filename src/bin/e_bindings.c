@@ -1,5 +1,38 @@
 #include "e.h"
 
+/* key and mouse bindings are dispatched through per-context tables keyed
+ * by key name/button, then modifier mask. each bucket holds the bindings in
+ * list order with their actions already looked up, so an event only visits
+ * the bindings it could match. tables are rebuilt lazily when bindings or
+ * actions change. */
+#define E_BINDINGS_DISPATCH_MODS    (E_BINDING_MODIFIER_ALTGR << 1)
+#define E_BINDINGS_DISPATCH_SOURCES 8
+
+typedef struct _E_Bindings_Dispatch      E_Bindings_Dispatch;
+typedef struct _E_Bindings_Dispatch_Slot E_Bindings_Dispatch_Slot;
+typedef struct _E_Bindings_Dispatch_Iter E_Bindings_Dispatch_Iter;
+
+struct _E_Bindings_Dispatch
+{
+   void        *binding;
+   E_Action    *act;
+   unsigned int pos;
+};
+
+struct _E_Bindings_Dispatch_Slot
+{
+   Eina_Inarray *mod[E_BINDINGS_DISPATCH_MODS];
+   Eina_Inarray *any; // any_mod bindings
+   Eina_Inarray *other; // modifier bits no event can carry
+};
+
+struct _E_Bindings_Dispatch_Iter
+{
+   Eina_Inarray *src[E_BINDINGS_DISPATCH_SOURCES];
+   unsigned int  idx[E_BINDINGS_DISPATCH_SOURCES];
+   unsigned int  count;
+};
+
 /* local subsystem functions */
 static void               _e_bindings_mouse_free(E_Binding_Mouse *bind);
 static void               _e_bindings_key_free(E_Binding_Key *bind);
@@ -9,6 +42,12 @@ static void               _e_bindings_wheel_free(E_Binding_Wheel *bind);
 static void               _e_bindings_acpi_free(E_Binding_Acpi *bind);
 static void               _e_bindings_swipe_free(E_Binding_Swipe *bind);
 static Eina_Bool          _e_bindings_edge_cb_timer(void *data);
+static void               _e_bindings_dispatch_free(void);
+static void               _e_bindings_key_dispatch_update(void);
+static void               _e_bindings_mouse_dispatch_update(void);
+static void               _e_bindings_key_dispatch_iter_init(E_Bindings_Dispatch_Iter *it, E_Binding_Context ctxt, const char *key, const char *keyname, E_Binding_Modifier mod);
+static void               _e_bindings_mouse_dispatch_iter_init(E_Bindings_Dispatch_Iter *it, E_Binding_Context ctxt, int button, E_Binding_Modifier mod);
+static E_Bindings_Dispatch *_e_bindings_dispatch_iter_next(E_Bindings_Dispatch_Iter *it);
 
 /* local subsystem globals */
 
@@ -25,6 +64,13 @@ static unsigned int bindings_disabled = 0;
 static E_Bindings_Swipe_Live_Update live_update;
 static E_Bindings_Swipe_Live_Update live_update_data;
 
+static Eina_Hash *key_dispatch[E_BINDING_CONTEXT_LAST];
+static Eina_Hash *mouse_dispatch[E_BINDING_CONTEXT_LAST];
+static Eina_Hash *mouse_dispatch_pos = NULL;
+static unsigned int mouse_dispatch_count = 0;
+static Eina_Bool key_dispatch_dirty = EINA_TRUE;
+static Eina_Bool mouse_dispatch_dirty = EINA_TRUE;
+
 EINTERN E_Action *(*e_binding_key_list_cb)(E_Binding_Context, Ecore_Event_Key*, E_Binding_Modifier, E_Binding_Key **);
 
 typedef struct _E_Binding_Edge_Data E_Binding_Edge_Data;
@@ -106,10 +152,18 @@ e_bindings_shutdown(void)
    E_FREE_LIST(wheel_bindings, _e_bindings_wheel_free);
    E_FREE_LIST(acpi_bindings, _e_bindings_acpi_free);
    E_FREE_LIST(swipe_bindings, _e_bindings_swipe_free);
+   _e_bindings_dispatch_free();
 
    return 1;
 }
 
+EINTERN void
+e_bindings_actions_changed(void)
+{
+   key_dispatch_dirty = EINA_TRUE;
+   mouse_dispatch_dirty = EINA_TRUE;
+}
+
 E_API int
 e_bindings_modifiers_to_ecore_convert(E_Binding_Modifier modifiers)
 {
@@ -311,6 +365,7 @@ e_bindings_mouse_reset(void)
    Eina_List *l;
 
    E_FREE_LIST(mouse_bindings, _e_bindings_mouse_free);
+   mouse_dispatch_dirty = EINA_TRUE;
 
    EINA_LIST_FOREACH(e_bindings->mouse_bindings, l, ebm)
      e_bindings_mouse_add(ebm->context, ebm->button, ebm->modifiers,
@@ -325,6 +380,7 @@ e_bindings_key_reset(void)
 
    e_comp_canvas_keys_ungrab();
    E_FREE_LIST(key_bindings, _e_bindings_key_free);
+   key_dispatch_dirty = EINA_TRUE;
 
    EINA_LIST_FOREACH(e_bindings->key_bindings, l, ebk)
      e_bindings_key_add(ebk->context, ebk->key, ebk->modifiers,
@@ -368,6 +424,7 @@ e_bindings_mouse_add(E_Binding_Context ctxt, int button, E_Binding_Modifier mod,
    if (action) binding->action = eina_stringshare_add(action);
    if (params) binding->params = eina_stringshare_add(params);
    mouse_bindings = eina_list_append(mouse_bindings, binding);
+   mouse_dispatch_dirty = EINA_TRUE;
 }
 
 E_API void
@@ -389,6 +446,7 @@ e_bindings_mouse_del(E_Binding_Context ctxt, int button, E_Binding_Modifier mod,
           {
              _e_bindings_mouse_free(binding);
              mouse_bindings = eina_list_remove_list(mouse_bindings, l);
+             mouse_dispatch_dirty = EINA_TRUE;
              break;
           }
      }
@@ -445,33 +503,35 @@ e_bindings_mouse_ungrab(E_Binding_Context ctxt, Ecore_X_Window win)
 E_API E_Action *
 e_bindings_mouse_button_find(E_Binding_Context ctxt, E_Binding_Event_Mouse_Button *ev, E_Binding_Mouse **bind_ret)
 {
+   E_Bindings_Dispatch_Iter it;
+   E_Bindings_Dispatch *d;
    E_Binding_Mouse *binding;
-   Eina_List *start = NULL, *l;
+   unsigned int start = 0;
    E_Action *act = NULL;
 
+   _e_bindings_mouse_dispatch_update();
    if (bind_ret && *bind_ret)
-     start = eina_list_data_find_list(mouse_bindings, *bind_ret);
-   if (start)
      {
-        start = start->next;
-        if (!start)
+        /* resume after the binding returned last time */
+        start = (uintptr_t)eina_hash_find(mouse_dispatch_pos, bind_ret);
+        if (start == mouse_dispatch_count)
           {
              *bind_ret = NULL;
              return NULL;
           }
      }
-   EINA_LIST_FOREACH(start ?: mouse_bindings, l, binding)
+   _e_bindings_mouse_dispatch_iter_init(&it, ctxt, ev->button, ev->modifiers);
+   while ((d = _e_bindings_dispatch_iter_next(&it)))
      {
-        if ((binding->button == (int)ev->button) &&
-            ((binding->any_mod) || (binding->mod == ev->modifiers)))
-          {
-             if (!e_bindings_context_match(binding->ctxt, ctxt)) continue;
-             if (act && (binding->ctxt == E_BINDING_CONTEXT_ANY)) continue;
-             act = e_action_find(binding->action);
-             if (bind_ret) *bind_ret = binding;
-             if (!act) continue;
-             if (binding->ctxt != E_BINDING_CONTEXT_ANY) break;
-          }
+        if (d->pos < start) continue;
+        binding = d->binding;
+        if ((!binding->any_mod) && (binding->mod != ev->modifiers)) continue;
+        if (!e_bindings_context_match(binding->ctxt, ctxt)) continue;
+        if (act && (binding->ctxt == E_BINDING_CONTEXT_ANY)) continue;
+        act = d->act;
+        if (bind_ret) *bind_ret = binding;
+        if (!act) continue;
+        if (binding->ctxt != E_BINDING_CONTEXT_ANY) break;
      }
    return act;
 }
@@ -635,6 +695,7 @@ e_bindings_key_add(E_Binding_Context ctxt, const char *key, E_Binding_Modifier m
    if (action) binding->action = eina_stringshare_add(action);
    if (params) binding->params = eina_stringshare_add(params);
    key_bindings = eina_list_append(key_bindings, binding);
+   key_dispatch_dirty = EINA_TRUE;
 }
 
 E_API E_Binding_Key *
@@ -654,19 +715,37 @@ e_bindings_key_get(const char *action)
 E_API E_Binding_Key *
 e_bindings_key_find(const char *key, E_Binding_Modifier mod, int any_mod)
 {
+   E_Bindings_Dispatch_Slot *slot;
+   E_Bindings_Dispatch *d, *found = NULL;
    E_Binding_Key *binding;
-   Eina_List *l;
+   Eina_Inarray *arr;
+   int i;
 
    if (!key) return NULL;
 
-   EINA_LIST_FOREACH(key_bindings, l, binding)
+   _e_bindings_key_dispatch_update();
+   for (i = 0; i < E_BINDING_CONTEXT_LAST; i++)
      {
-        if ((binding->key) && (!strcmp(key, binding->key)) &&
-            (binding->mod == mod) && (binding->any_mod == any_mod))
-          return binding;
+        if (!key_dispatch[i]) continue;
+        slot = eina_hash_find(key_dispatch[i], key);
+        if (!slot) continue;
+        if (any_mod) arr = slot->any;
+        else if ((unsigned int)mod < E_BINDINGS_DISPATCH_MODS) arr = slot->mod[mod];
+        else arr = slot->other;
+        if (!arr) continue;
+        EINA_INARRAY_FOREACH(arr, d)
+          {
+             if (found && (d->pos >= found->pos)) break;
+             binding = d->binding;
+             if ((binding->mod == mod) && (binding->any_mod == any_mod))
+               {
+                  found = d;
+                  break;
+               }
+          }
      }
 
-   return NULL;
+   return found ? found->binding : NULL;
 }
 
 E_API void
@@ -688,6 +767,7 @@ e_bindings_key_del(E_Binding_Context ctxt, const char *key, E_Binding_Modifier m
           {
              _e_bindings_key_free(binding);
              key_bindings = eina_list_remove_list(key_bindings, l);
+             key_dispatch_dirty = EINA_TRUE;
              break;
           }
      }
@@ -783,8 +863,9 @@ E_API E_Action *
 e_bindings_key_event_find(E_Binding_Context ctxt, Ecore_Event_Key *ev, E_Binding_Key **bind_ret)
 {
    E_Binding_Modifier mod = 0;
+   E_Bindings_Dispatch_Iter it;
+   E_Bindings_Dispatch *d;
    E_Binding_Key *binding;
-   Eina_List *l;
    E_Action *act = NULL;
 
    mod = e_bindings_modifiers_from_ecore(ev->modifiers);
@@ -794,18 +875,18 @@ e_bindings_key_event_find(E_Binding_Context ctxt, Ecore_Event_Key *ev, E_Binding
         if (act) return act;
         if (bind_ret) *bind_ret = NULL;
      }
-   EINA_LIST_FOREACH(key_bindings, l, binding)
+   _e_bindings_key_dispatch_update();
+   _e_bindings_key_dispatch_iter_init(&it, ctxt, ev->key, ev->keyname, mod);
+   while ((d = _e_bindings_dispatch_iter_next(&it)))
      {
-        if ((binding->key) && ((!strcmp(binding->key, ev->key)) || (!strcmp(binding->key, ev->keyname))) &&
-            ((binding->any_mod) || (binding->mod == mod)))
-          {
-             if (!e_bindings_context_match(binding->ctxt, ctxt)) continue;
-             if (act && (binding->ctxt == E_BINDING_CONTEXT_ANY)) continue;
-             act = e_action_find(binding->action);
-             if (bind_ret) *bind_ret = binding;
-             if (!act) continue;
-             if (binding->ctxt != E_BINDING_CONTEXT_ANY) break;
-          }
+        binding = d->binding;
+        if ((!binding->any_mod) && (binding->mod != mod)) continue;
+        if (!e_bindings_context_match(binding->ctxt, ctxt)) continue;
+        if (act && (binding->ctxt == E_BINDING_CONTEXT_ANY)) continue;
+        act = d->act;
+        if (bind_ret) *bind_ret = binding;
+        if (!act) continue;
+        if (binding->ctxt != E_BINDING_CONTEXT_ANY) break;
      }
    return act;
 }
@@ -1613,6 +1694,214 @@ _e_bindings_edge_cb_timer(void *data)
    return ECORE_CALLBACK_CANCEL;
 }
 
+static void
+_e_bindings_dispatch_slot_free(void *data)
+{
+   E_Bindings_Dispatch_Slot *slot = data;
+   unsigned int i;
+
+   for (i = 0; i < E_BINDINGS_DISPATCH_MODS; i++)
+     if (slot->mod[i]) eina_inarray_free(slot->mod[i]);
+   if (slot->any) eina_inarray_free(slot->any);
+   if (slot->other) eina_inarray_free(slot->other);
+   free(slot);
+}
+
+static void
+_e_bindings_dispatch_slot_append(E_Bindings_Dispatch_Slot *slot, E_Bindings_Dispatch *d, E_Binding_Modifier mod, Eina_Bool any_mod)
+{
+   Eina_Inarray **arr;
+
+   if (any_mod) arr = &slot->any;
+   else if ((unsigned int)mod < E_BINDINGS_DISPATCH_MODS) arr = &slot->mod[mod];
+   else arr = &slot->other;
+   if (!*arr) *arr = eina_inarray_new(sizeof(E_Bindings_Dispatch), 4);
+   eina_inarray_push(*arr, d);
+}
+
+static void
+_e_bindings_dispatch_free(void)
+{
+   int i;
+
+   for (i = 0; i < E_BINDING_CONTEXT_LAST; i++)
+     {
+        E_FREE_FUNC(key_dispatch[i], eina_hash_free);
+        E_FREE_FUNC(mouse_dispatch[i], eina_hash_free);
+     }
+   E_FREE_FUNC(mouse_dispatch_pos, eina_hash_free);
+   mouse_dispatch_count = 0;
+   key_dispatch_dirty = EINA_TRUE;
+   mouse_dispatch_dirty = EINA_TRUE;
+}
+
+static void
+_e_bindings_key_dispatch_update(void)
+{
+   E_Bindings_Dispatch_Slot *slot;
+   E_Bindings_Dispatch d;
+   E_Binding_Key *binding;
+   Eina_List *l;
+   unsigned int pos = 0;
+   int i;
+
+   if (!key_dispatch_dirty) return;
+   for (i = 0; i < E_BINDING_CONTEXT_LAST; i++)
+     E_FREE_FUNC(key_dispatch[i], eina_hash_free);
+   EINA_LIST_FOREACH(key_bindings, l, binding)
+     {
+        /* a binding without a key never matches, and one with an unknown
+         * context can't match any context an event is delivered in */
+        if (!binding->key) continue;
+        if (((int)binding->ctxt < 0) || (binding->ctxt >= E_BINDING_CONTEXT_LAST)) continue;
+        if (!key_dispatch[binding->ctxt])
+          key_dispatch[binding->ctxt] = eina_hash_string_superfast_new(_e_bindings_dispatch_slot_free);
+        slot = eina_hash_find(key_dispatch[binding->ctxt], binding->key);
+        if (!slot)
+          {
+             slot = E_NEW(E_Bindings_Dispatch_Slot, 1);
+             eina_hash_add(key_dispatch[binding->ctxt], binding->key, slot);
+          }
+        d.binding = binding;
+        d.act = e_action_find(binding->action);
+        d.pos = pos++;
+        _e_bindings_dispatch_slot_append(slot, &d, binding->mod, binding->any_mod);
+     }
+   key_dispatch_dirty = EINA_FALSE;
+}
+
+static void
+_e_bindings_mouse_dispatch_update(void)
+{
+   E_Bindings_Dispatch_Slot *slot;
+   E_Bindings_Dispatch d;
+   E_Binding_Mouse *binding;
+   Eina_List *l;
+   unsigned int pos = 0;
+   int i;
+
+   if (!mouse_dispatch_dirty) return;
+   for (i = 0; i < E_BINDING_CONTEXT_LAST; i++)
+     E_FREE_FUNC(mouse_dispatch[i], eina_hash_free);
+   E_FREE_FUNC(mouse_dispatch_pos, eina_hash_free);
+   mouse_dispatch_pos = eina_hash_pointer_new(NULL);
+   EINA_LIST_FOREACH(mouse_bindings, l, binding)
+     {
+        pos++;
+        /* stored off by one so a missing binding reads back as 0 */
+        eina_hash_add(mouse_dispatch_pos, &binding, (void *)(uintptr_t)pos);
+        if (((int)binding->ctxt < 0) || (binding->ctxt >= E_BINDING_CONTEXT_LAST)) continue;
+        if (!mouse_dispatch[binding->ctxt])
+          mouse_dispatch[binding->ctxt] = eina_hash_int32_new(_e_bindings_dispatch_slot_free);
+        slot = eina_hash_find(mouse_dispatch[binding->ctxt], &binding->button);
+        if (!slot)
+          {
+             slot = E_NEW(E_Bindings_Dispatch_Slot, 1);
+             eina_hash_add(mouse_dispatch[binding->ctxt], &binding->button, slot);
+          }
+        d.binding = binding;
+        d.act = e_action_find(binding->action);
+        d.pos = pos - 1;
+        _e_bindings_dispatch_slot_append(slot, &d, binding->mod, binding->any_mod);
+     }
+   mouse_dispatch_count = pos;
+   mouse_dispatch_dirty = EINA_FALSE;
+}
+
+static void
+_e_bindings_dispatch_iter_add(E_Bindings_Dispatch_Iter *it, Eina_Inarray *arr)
+{
+   unsigned int i;
+
+   if ((!arr) || (!eina_inarray_count(arr))) return;
+   for (i = 0; i < it->count; i++)
+     if (it->src[i] == arr) return;
+   if (it->count == E_BINDINGS_DISPATCH_SOURCES) return;
+   it->src[it->count] = arr;
+   it->idx[it->count] = 0;
+   it->count++;
+}
+
+static void
+_e_bindings_dispatch_iter_slot_add(E_Bindings_Dispatch_Iter *it, E_Bindings_Dispatch_Slot *slot, E_Binding_Modifier mod)
+{
+   if (!slot) return;
+   if ((unsigned int)mod < E_BINDINGS_DISPATCH_MODS)
+     _e_bindings_dispatch_iter_add(it, slot->mod[mod]);
+   else
+     _e_bindings_dispatch_iter_add(it, slot->other);
+   _e_bindings_dispatch_iter_add(it, slot->any);
+}
+
+/* the tables an event in ctxt has to look at: its own context's and, as
+ * e_bindings_context_match() allows, the ANY context's */
+static int
+_e_bindings_dispatch_contexts_get(E_Binding_Context ctxt, E_Binding_Context *ctxts)
+{
+   int n = 0;
+
+   if ((ctxt != E_BINDING_CONTEXT_UNKNOWN) &&
+       ((int)ctxt >= 0) && (ctxt < E_BINDING_CONTEXT_LAST))
+     ctxts[n++] = ctxt;
+   if ((ctxt != E_BINDING_CONTEXT_ZONE) && (ctxt != E_BINDING_CONTEXT_ANY))
+     ctxts[n++] = E_BINDING_CONTEXT_ANY;
+   return n;
+}
+
+static void
+_e_bindings_key_dispatch_iter_init(E_Bindings_Dispatch_Iter *it, E_Binding_Context ctxt, const char *key, const char *keyname, E_Binding_Modifier mod)
+{
+   E_Binding_Context ctxts[2];
+   int i, n;
+
+   it->count = 0;
+   n = _e_bindings_dispatch_contexts_get(ctxt, ctxts);
+   for (i = 0; i < n; i++)
+     {
+        if (!key_dispatch[ctxts[i]]) continue;
+        if (key)
+          _e_bindings_dispatch_iter_slot_add(it, eina_hash_find(key_dispatch[ctxts[i]], key), mod);
+        if (keyname)
+          _e_bindings_dispatch_iter_slot_add(it, eina_hash_find(key_dispatch[ctxts[i]], keyname), mod);
+     }
+}
+
+static void
+_e_bindings_mouse_dispatch_iter_init(E_Bindings_Dispatch_Iter *it, E_Binding_Context ctxt, int button, E_Binding_Modifier mod)
+{
+   E_Binding_Context ctxts[2];
+   int i, n;
+
+   it->count = 0;
+   n = _e_bindings_dispatch_contexts_get(ctxt, ctxts);
+   for (i = 0; i < n; i++)
+     {
+        if (!mouse_dispatch[ctxts[i]]) continue;
+        _e_bindings_dispatch_iter_slot_add(it, eina_hash_find(mouse_dispatch[ctxts[i]], &button), mod);
+     }
+}
+
+/* merge the buckets back into binding list order */
+static E_Bindings_Dispatch *
+_e_bindings_dispatch_iter_next(E_Bindings_Dispatch_Iter *it)
+{
+   E_Bindings_Dispatch *d, *best = NULL;
+   unsigned int i, best_i = 0;
+
+   for (i = 0; i < it->count; i++)
+     {
+        if (it->idx[i] >= eina_inarray_count(it->src[i])) continue;
+        d = eina_inarray_nth(it->src[i], it->idx[i]);
+        if ((!best) || (d->pos < best->pos))
+          {
+             best = d;
+             best_i = i;
+          }
+     }
+   if (best) it->idx[best_i]++;
+   return best;
+}
+
 E_API void
 e_bindings_swipe_add(E_Binding_Context ctxt, double direction, double length, unsigned int fingers, double error, const char *action, const char *params)
 {
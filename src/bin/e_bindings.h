@@ -143,6 +143,7 @@ struct _E_Binding_Swipe
 
 EINTERN int         e_bindings_init(void);
 EINTERN int         e_bindings_shutdown(void);
+EINTERN void        e_bindings_actions_changed(void);
 
 E_API void        e_bindings_mouse_reset(void);
 E_API void        e_bindings_key_reset(void);
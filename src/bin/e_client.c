@@ -54,6 +54,10 @@ static Eina_Rectangle action_orig = {0, 0, 0, 0};
 
 static E_Client_Layout_Cb _e_client_layout_cb = NULL;
 
+/* clients with pending changes, the idler only evaluates these */
+static Eina_List *_e_client_changed = NULL;
+static unsigned int _e_client_idler_processed = 0;
+
 EINTERN void e_client_focused_set(E_Client *ec);
 
 static Eina_Inlist *_e_client_hooks[E_CLIENT_HOOK_LAST] = {NULL};
@@ -461,6 +465,11 @@ _e_client_revert_focus(E_Client *ec)
 static void
 _e_client_free(E_Client *ec)
 {
+   if (ec->on_changed_list)
+     {
+        _e_client_changed = eina_list_remove(_e_client_changed, ec);
+        ec->on_changed_list = 0;
+     }
    if (ec->restore_zone_id)
      {
         eina_stringshare_del(ec->restore_zone_id);
@@ -2450,11 +2459,21 @@ EINTERN void
 e_client_idler_before(void)
 {
    const Eina_List *l;
+   Eina_List *changed;
    E_Client *ec;
 
+   _e_client_idler_processed = 0;
    if ((!eina_hash_population(clients_hash[0])) && (!eina_hash_population(clients_hash[1]))) return;
+   if (!_e_client_changed) return;
 
-   EINA_LIST_FOREACH(e_comp->clients, l, ec)
+   /* take the queue - clients stay flagged as queued while we work on
+    * them so setting changed during eval doesn't add them twice */
+   changed = _e_client_changed;
+   _e_client_changed = NULL;
+   EINA_LIST_FOREACH(changed, l, ec)
+     e_object_ref(E_OBJECT(ec));
+
+   EINA_LIST_FOREACH(changed, l, ec)
      {
         Eina_Stringshare *title;
         // pass 1 - eval0. fetch properties on new or on change and
@@ -2480,7 +2499,7 @@ e_client_idler_before(void)
         _e_client_hook_call(E_CLIENT_HOOK_EVAL_POST_FRAME_ASSIGN, ec);
      }
 
-   E_CLIENT_FOREACH(ec)
+   EINA_LIST_FOREACH(changed, l, ec)
      {
         if (ec->ignored) continue;
         // pass 2 - show windows needing show
@@ -2505,16 +2524,18 @@ e_client_idler_before(void)
                     _e_client_move_lost_window_to_center(ec);
                }
           }
-        // handle window stack
-        if (!ec->stack.prev && ec->stack.next)
+        // handle window stack - any change in a stack re-lays it from its bottom
+        if (ec->stack.prev || ec->stack.next)
           {
-             if (ec->stack.ignore == 0)
+             E_Client *ecs = e_client_stack_bottom_get(ec);
+
+             if (ecs->stack.ignore == 0)
                {
-                  Eina_List *ll, *list = e_client_stack_list_prepare(ec);
+                  Eina_List *ll, *list = e_client_stack_list_prepare(ecs);
                   E_Client *child, *bottom, *moving = NULL, *rel;
                   int x, y;
 
-                  bottom = rel = e_client_stack_bottom_get(ec);
+                  bottom = rel = ecs;
                   EINA_LIST_FOREACH(list, ll, child)
                     {
                        if (child->moving)
@@ -2527,7 +2548,7 @@ e_client_idler_before(void)
                     {
                        Evas_Coord ox, oy;
 
-                       evas_object_geometry_get(ec->frame, &ox, &oy, NULL, NULL);
+                       evas_object_geometry_get(ecs->frame, &ox, &oy, NULL, NULL);
                        rel = moving;
                     }
                   EINA_LIST_FOREACH(list, ll, child)
@@ -2546,7 +2567,7 @@ e_client_idler_before(void)
                             child->pre_cb.x = x;
                             child->pre_cb.y = y;
                             child->changes.pos = 1;
-                            child->changed = 1;
+                            EC_CHANGED(child);
                          }
                     }
                   e_client_stack_list_finish(list);
@@ -2557,8 +2578,16 @@ e_client_idler_before(void)
    if (_e_client_layout_cb)
      _e_client_layout_cb();
 
+   /* pick up anything queued by the passes above, eg. stacked children
+    * that were just moved, so they get evaluated in this same pass */
+   EINA_LIST_FREE(_e_client_changed, ec)
+     {
+        e_object_ref(E_OBJECT(ec));
+        changed = eina_list_append(changed, ec);
+     }
+
    // pass 3 - hide windows needing hide and eval (main eval)
-   E_CLIENT_FOREACH(ec)
+   EINA_LIST_FOREACH(changed, l, ec)
      {
         if (ec->ignored || e_object_is_del(E_OBJECT(ec))) continue;
 
@@ -2580,6 +2609,31 @@ e_client_idler_before(void)
                evas_object_hide(ec->frame);
           }
      }
+
+   /* whatever still has work pending stays queued for the next pass */
+   EINA_LIST_FREE(changed, ec)
+     {
+        _e_client_idler_processed++;
+        ec->on_changed_list = 0;
+        if ((!ec->ignored) && (!e_object_is_del(E_OBJECT(ec))) &&
+            ((ec->changed) || (ec->changes.visible)))
+          e_client_changed_queue(ec);
+        e_object_unref(E_OBJECT(ec));
+     }
+}
+
+E_API void
+e_client_changed_queue(E_Client *ec)
+{
+   if (ec->on_changed_list) return;
+   ec->on_changed_list = 1;
+   _e_client_changed = eina_list_append(_e_client_changed, ec);
+}
+
+E_API unsigned int
+e_client_idler_processed_get(void)
+{
+   return _e_client_idler_processed;
 }
 
 
@@ -2643,6 +2697,7 @@ e_client_unignore(E_Client *ec)
    if (!ec->ignored) return;
 
    ec->ignored = 0;
+   if (ec->changed) e_client_changed_queue(ec);
    if (!e_client_util_ignored_get(ec))
      {
         if (starting)
@@ -734,6 +734,7 @@ struct E_Client
    Eina_Bool keyboard_resizing E_BITFIELD;
 
    Eina_Bool on_post_updates E_BITFIELD; // client is on the post update list
+   Eina_Bool on_changed_list E_BITFIELD; // client is queued for the next eval
 };
 
 #define e_client_focus_policy_click(ec) \
@@ -746,10 +747,15 @@ struct E_Client
      if (e_object_is_del(E_OBJECT(EC))) \
        EINA_LOG_CRIT("CHANGED SET ON DELETED CLIENT!"); \
      EC->changed = 1; \
+     e_client_changed_queue(EC); \
      INF("%s:%d - EC CHANGED: %p", __FILE__, __LINE__, EC); \
   } while (0)
 #else
-# define EC_CHANGED(EC) EC->changed = 1
+# define EC_CHANGED(EC) \
+  do { \
+     EC->changed = 1; \
+     e_client_changed_queue(EC); \
+  } while (0)
 #endif
 
 #define E_CLIENT_FOREACH(EC) \
@@ -779,6 +785,8 @@ E_API extern int E_EVENT_CLIENT_UNFULLSCREEN;
 
 
 EINTERN void e_client_idler_before(void);
+E_API void e_client_changed_queue(E_Client *ec);
+E_API unsigned int e_client_idler_processed_get(void);
 EINTERN Eina_Bool e_client_init(void);
 EINTERN void e_client_shutdown(void);
 E_API E_Client *e_client_new(E_Pixmap *cp, int first_map, int internal);
@@ -473,7 +473,7 @@ _e_comp_fps_draw_span(unsigned int *pix, int stride, int w, int y, int col, int
 E_API void
 e_comp_fps_update(void)
 {
-   char buf[128];
+   char buf[256];
    double fps, comp_fps;
    Evas_Coord x = 0, y = 0, w = 0, h = 0;
    Evas_Coord gx = 0, gy = 0, gw = 0, gh = 0;
@@ -496,7 +496,17 @@ e_comp_fps_update(void)
         fps = _e_comp_frame_event_fps_calc(E_COMP_FRAME_EVENT_HANDLE_DAMAGE);
         comp_fps = _e_comp_frame_event_fps_calc(E_COMP_FRAME_EVENT_RENDER_END);
 
-        snprintf(buf, sizeof(buf), "FPS: (in) %1.1f (out) %1.1f", fps, comp_fps);
+        if (e_comp_profile_enabled_get())
+          snprintf(buf, sizeof(buf),
+                   "FPS: (in) %1.1f (out) %1.1f | ms/frame: dmg %1.2f upd %1.2f cli %1.2f rnd %1.2f swp %1.2f",
+                   fps, comp_fps,
+                   e_comp_profile_phase_average_get(E_COMP_PROFILE_PHASE_DAMAGE) * 1000.0,
+                   e_comp_profile_phase_average_get(E_COMP_PROFILE_PHASE_UPDATE) * 1000.0,
+                   e_comp_profile_phase_average_get(E_COMP_PROFILE_PHASE_CLIENT_RENDER) * 1000.0,
+                   e_comp_profile_phase_average_get(E_COMP_PROFILE_PHASE_RENDER) * 1000.0,
+                   e_comp_profile_phase_average_get(E_COMP_PROFILE_PHASE_SWAP) * 1000.0);
+        else
+          snprintf(buf, sizeof(buf), "FPS: (in) %1.1f (out) %1.1f", fps, comp_fps);
         evas_object_text_text_set(e_comp->canvas->fps_fg, buf);
 
         evas_object_geometry_get(e_comp->canvas->fps_fg, NULL, NULL, &w, &h);
@@ -622,6 +632,7 @@ _e_comp_cb_update(void)
    E_Client *ec;
    Eina_List *l;
    //   static int doframeinfo = -1;
+   E_COMP_PROFILE_BEGIN(tu);
 
    if (!e_comp) return EINA_FALSE;
    DBG("UPDATE ALL");
@@ -636,9 +647,12 @@ _e_comp_cb_update(void)
    e_comp->updates = NULL;
    EINA_LIST_FREE(l, ec)
      {
+        E_COMP_PROFILE_BEGIN(t);
+
         /* clear update flag */
         e_comp_object_render_update_del(ec->frame);
         _e_comp_client_update(ec);
+        E_COMP_PROFILE_END(t, E_COMP_PROFILE_PHASE_DAMAGE, ec, 0, 0);
      }
    e_comp->updating = 0;
    _e_comp_fps_update();
@@ -651,6 +665,7 @@ _e_comp_cb_update(void)
         e_comp_frame_event_add(info, t);
         e_comp_fps_update();
      }
+   E_COMP_PROFILE_END(tu, E_COMP_PROFILE_PHASE_UPDATE, NULL, 0, 0);
    /*
       if (doframeinfo == -1)
       {
@@ -1259,6 +1274,7 @@ e_comp_init(void)
                                NULL, NULL, 0);
       actions = eina_list_append(actions, act);
    }
+   e_comp_profile_init();
 
    e_comp_new();
    e_comp->comp_type = E_PIXMAP_TYPE_NONE;
@@ -1614,6 +1630,7 @@ e_comp_shutdown(void)
    E_FREE_LIST(handlers, ecore_event_handler_del);
    E_FREE_LIST(actions, e_object_del);
    E_FREE_LIST(hooks, e_client_hook_del);
+   e_comp_profile_shutdown();
 
    gl_avail = EINA_FALSE;
    e_comp_cfdata_config_free(conf);
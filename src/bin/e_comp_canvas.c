@@ -4,6 +4,8 @@ static Eina_List *handlers;
 static Ecore_Timer *timer_post_screensaver_lock = NULL;
 static Ecore_Timer *timer_post_screensaver_on = NULL;
 static Ecore_Timer *timer_pointer_freeze = NULL;
+static double render_track_t0 = 0.0;
+static double render_track_flush_t0 = 0.0;
 
 static void
 _e_comp_canvas_cb_del()
@@ -74,8 +76,9 @@ _e_comp_canvas_render_track_pre(void *data EINA_UNUSED, Evas *e EINA_UNUSED, voi
 {
    int info[4] = { 0, 0, 0, 0 };
 
+   render_track_t0 = ecore_time_get();
    info[0] = E_COMP_FRAME_EVENT_RENDER_BEGIN;
-   e_comp_frame_event_add(info, ecore_time_get());
+   e_comp_frame_event_add(info, render_track_t0);
 }
 
 static void
@@ -83,8 +86,11 @@ _e_comp_canvas_render_track_post(void *data EINA_UNUSED, Evas *e EINA_UNUSED, vo
 {
    int info[4] = { 0, 0, 0, 0 };
 
+   double t = ecore_time_get();
+
    info[0] = E_COMP_FRAME_EVENT_RENDER_END;
-   e_comp_frame_event_add(info, ecore_time_get());
+   e_comp_frame_event_add(info, t);
+   e_comp_profile_span_add(E_COMP_PROFILE_PHASE_RENDER, render_track_t0, t, NULL, 0, 0);
 }
 
 static void
@@ -92,8 +98,9 @@ _e_comp_canvas_render_track_flush_pre(void *data EINA_UNUSED, Evas *e EINA_UNUSE
 {
    int info[4] = { 0, 0, 0, 0 };
 
+   render_track_flush_t0 = ecore_time_get();
    info[0] = E_COMP_FRAME_EVENT_RENDER2_BEGIN;
-   e_comp_frame_event_add(info, ecore_time_get());
+   e_comp_frame_event_add(info, render_track_flush_t0);
 }
 
 static void
@@ -101,8 +108,12 @@ _e_comp_canvas_render_track_flush_post(void *data EINA_UNUSED, Evas *e EINA_UNUS
 {
    int info[4] = { 0, 0, 0, 0 };
 
+   double t = ecore_time_get();
+
    info[0] = E_COMP_FRAME_EVENT_RENDER2_END;
-   e_comp_frame_event_add(info, ecore_time_get());
+   e_comp_frame_event_add(info, t);
+   e_comp_profile_span_add(E_COMP_PROFILE_PHASE_SWAP, render_track_flush_t0, t, NULL, 0, 0);
+   e_comp_profile_frame_end();
 }
 
 static void
@@ -21,6 +21,8 @@
 
 #define UPDATE_MAX 512 // same as evas
 #define FAILURE_MAX 2 // seems reasonable
+#define RENDER_BAND_WASTE_NUM 3 // merged band may be up to 3/2 of the damaged area
+#define RENDER_BAND_WASTE_DEN 2
 #define SMART_NAME     "e_comp_object"
 
 /* for non-util functions */
@@ -146,6 +148,13 @@ struct E_Comp_Object_Mover
 static Eina_Inlist *_e_comp_object_movers = NULL;
 static Evas_Smart *_e_comp_smart = NULL;
 
+/* scratch space for coalesced render bands; only used from the main loop */
+static Eina_Rectangle *_e_comp_object_render_bands = NULL;
+static unsigned int _e_comp_object_render_bands_size = 0;
+/* the whole pixmap, for when the scratch space can't grow */
+static Eina_Rectangle _e_comp_object_render_band_full;
+static E_Comp_Object_Render_Stats _e_comp_object_render_stats;
+
 /* sekrit functionzzz */
 EINTERN void e_client_focused_set(E_Client *ec);
 
@@ -4153,15 +4162,89 @@ e_comp_object_dirty(Evas_Object *obj)
    e_comp_object_render(obj);
 }
 
-E_API Eina_Bool
-e_comp_object_render(Evas_Object *obj)
+/* merge the pending damage rects into as few horizontal bands as possible so
+ * each band costs a single fetch from the display server and a single
+ * conversion pass. rects are only merged when the resulting bounding box
+ * doesn't waste more than RENDER_BAND_WASTE of the actually damaged area.
+ */
+static Eina_Rectangle *
+_e_comp_object_render_bands_build(Eina_Iterator *it, int pw, int ph, unsigned int *num, unsigned int *rects)
+{
+   Eina_Rectangle *r, *b = NULL;
+   long long b_pixels = 0;
+
+   *num = *rects = 0;
+   EINA_ITERATOR_FOREACH(it, r)
+     {
+        Eina_Rectangle rr = *r;
+        int x1, y1, x2, y2;
+        long long area;
+
+        E_RECTS_CLIP_TO_RECT(rr.x, rr.y, rr.w, rr.h, 0, 0, pw, ph);
+        if ((rr.w < 1) || (rr.h < 1)) continue;
+        (*rects)++;
+        area = (long long)rr.w * rr.h;
+        if (b && (rr.y <= b->y + b->h) && (rr.y + rr.h >= b->y))
+          {
+             x1 = MIN(b->x, rr.x);
+             y1 = MIN(b->y, rr.y);
+             x2 = MAX(b->x + b->w, rr.x + rr.w);
+             y2 = MAX(b->y + b->h, rr.y + rr.h);
+             if ((long long)(x2 - x1) * (y2 - y1) * RENDER_BAND_WASTE_DEN <=
+                 (b_pixels + area) * RENDER_BAND_WASTE_NUM)
+               {
+                  EINA_RECTANGLE_SET(b, x1, y1, x2 - x1, y2 - y1);
+                  b_pixels += area;
+                  continue;
+               }
+          }
+        if (*num == _e_comp_object_render_bands_size)
+          {
+             Eina_Rectangle *tmp;
+             unsigned int size = *num ? *num * 2 : 32;
+
+             tmp = realloc(_e_comp_object_render_bands, size * sizeof(Eina_Rectangle));
+             if (!tmp)
+               {
+                  /* dropping the rest of the damage would leave stale
+                   * pixels behind, so redo everything instead */
+                  EINA_RECTANGLE_SET(&_e_comp_object_render_band_full,
+                                     0, 0, pw, ph);
+                  *num = 1;
+                  return &_e_comp_object_render_band_full;
+               }
+             _e_comp_object_render_bands = tmp;
+             _e_comp_object_render_bands_size = size;
+          }
+        b = &_e_comp_object_render_bands[(*num)++];
+        *b = rr;
+        b_pixels = area;
+     }
+   return _e_comp_object_render_bands;
+}
+
+E_API void
+e_comp_object_render_stats_get(E_Comp_Object_Render_Stats *stats)
+{
+   EINA_SAFETY_ON_NULL_RETURN(stats);
+   *stats = _e_comp_object_render_stats;
+}
+
+E_API void
+e_comp_object_render_stats_reset(void)
+{
+   memset(&_e_comp_object_render_stats, 0, sizeof(E_Comp_Object_Render_Stats));
+}
+
+static Eina_Bool
+_e_comp_object_render(Evas_Object *obj)
 {
    Eina_Iterator *it = NULL;
-   Eina_Rectangle *r;
+   Eina_Rectangle *r, *bands;
    Eina_List *l;
    Evas_Object *o;
    int stride, pw, ph;
-   unsigned int *pix, *srcpix;
+   unsigned int *pix, *srcpix, i, num, rects;
    Eina_Bool ret = EINA_FALSE;
 
    API_ENTRY EINA_FALSE;
@@ -4194,12 +4277,20 @@ e_comp_object_render(Evas_Object *obj)
      }
 
    it = eina_tiler_iterator_new(cw->pending_updates);
+   if (!it)
+     {
+        pix = NULL;
+        goto end;
+     }
+   bands = _e_comp_object_render_bands_build(it, pw, ph, &num, &rects);
+   _e_comp_object_render_stats.rects += rects;
+   _e_comp_object_render_stats.bands += num;
    if (e_pixmap_image_is_argb(cw->ec->pixmap))
      {
         pix = e_pixmap_image_data_get(cw->ec->pixmap);
-        EINA_ITERATOR_FOREACH(it, r)
+        for (i = 0; i < num; i++)
           {
-             E_RECTS_CLIP_TO_RECT(r->x, r->y, r->w, r->h, 0, 0, pw, ph);
+             r = &bands[i];
              /* get pixmap data from rect region on display server into memory */
              ret = e_pixmap_image_draw(cw->ec->pixmap, r);
              if (!ret)
@@ -4210,23 +4301,24 @@ e_comp_object_render(Evas_Object *obj)
                   else
                     {
                        DELD(cw->ec, 2);
+                       eina_iterator_free(it);
                        e_object_del(E_OBJECT(cw->ec));
                        return EINA_FALSE;
                     }
                   break;
                }
+             _e_comp_object_render_stats.pixels += (unsigned long long)r->w * r->h;
              RENDER_DEBUG("UPDATE [%p] %i %i %ix%i", cw->ec, r->x, r->y, r->w, r->h);
           }
-        if (!it) pix = NULL;
         goto end;
      }
 
    pix = evas_object_image_data_get(cw->obj, EINA_TRUE);
    stride = evas_object_image_stride_get(cw->obj);
    srcpix = e_pixmap_image_data_get(cw->ec->pixmap);
-   EINA_ITERATOR_FOREACH(it, r)
+   for (i = 0; i < num; i++)
      {
-        E_RECTS_CLIP_TO_RECT(r->x, r->y, r->w, r->h, 0, 0, pw, ph);
+        r = &bands[i];
         ret = e_pixmap_image_draw(cw->ec->pixmap, r);
         if (!ret)
           {
@@ -4236,15 +4328,16 @@ e_comp_object_render(Evas_Object *obj)
              else
                {
                   DELD(cw->ec, 3);
+                  eina_iterator_free(it);
                   e_object_del(E_OBJECT(cw->ec));
                   return EINA_FALSE;
                }
              break;
           }
         e_pixmap_image_data_argb_convert(cw->ec->pixmap, pix, srcpix, r, stride);
+        _e_comp_object_render_stats.pixels += (unsigned long long)r->w * r->h;
         RENDER_DEBUG("UPDATE [%p]: %d %d %dx%d -- pix = %p", cw->ec, r->x, r->y, r->w, r->h, pix);
      }
-   if (!it) pix = NULL;
 end:
    eina_iterator_free(it);
    evas_object_image_data_set(cw->obj, cw->blanked ? NULL : pix);
@@ -4256,6 +4349,28 @@ end:
    return ret;
 }
 
+E_API Eina_Bool
+e_comp_object_render(Evas_Object *obj)
+{
+   E_Comp_Object_Render_Stats prev = _e_comp_object_render_stats;
+   double t0, t;
+   Eina_Bool ret;
+
+   t0 = ecore_time_get();
+   ret = _e_comp_object_render(obj);
+   t = ecore_time_get() - t0;
+   _e_comp_object_render_stats.renders++;
+   _e_comp_object_render_stats.time += t;
+   if (t > _e_comp_object_render_stats.time_max)
+     _e_comp_object_render_stats.time_max = t;
+   if (e_comp_profile_enabled_get())
+     e_comp_profile_span_add(E_COMP_PROFILE_PHASE_CLIENT_RENDER, t0, t0 + t,
+                             e_comp_object_client_get(obj),
+                             _e_comp_object_render_stats.pixels - prev.pixels,
+                             _e_comp_object_render_stats.rects - prev.rects);
+   return ret;
+}
+
 E_API Evas_Object *
 e_comp_object_agent_add(Evas_Object *obj)
 {
@@ -4356,6 +4471,90 @@ e_comp_object_util_mirror_add(Evas_Object *obj)
    return o;
 }
 
+/* downscale the current contents of a client into a plain image object;
+ * every destination pixel is a box average of at most
+ * SNAPSHOT_SAMPLES x SNAPSHOT_SAMPLES source pixels so the cost is bounded
+ * by the size of the snapshot rather than the size of the window.
+ * returns EINA_FALSE if there are no cpu-side pixels (native surfaces).
+ */
+#define SNAPSHOT_SAMPLES 4
+
+E_API Eina_Bool
+e_comp_object_util_mirror_snapshot(Evas_Object *obj, Evas_Object *img, int w, int h)
+{
+   unsigned int *src, *dst;
+   int sw, sh, sstride, dstride, x, y, i, j;
+   int xs[SNAPSHOT_SAMPLES], nx, ny;
+
+   API_ENTRY EINA_FALSE;
+   EINA_SAFETY_ON_NULL_RETURN_VAL(img, EINA_FALSE);
+
+   if ((!cw->ec) || cw->native || cw->blanked || cw->ec->input_only) return EINA_FALSE;
+   if ((w < 1) || (h < 1)) return EINA_FALSE;
+   /* nothing renders hidden clients for us */
+   if ((cw->real_hid || (!cw->visible)) && cw->pending_updates &&
+       (!eina_tiler_empty(cw->pending_updates)))
+     e_comp_object_render(obj);
+
+   evas_object_image_size_get(cw->obj, &sw, &sh);
+   if ((sw < 1) || (sh < 1)) return EINA_FALSE;
+   src = evas_object_image_data_get(cw->obj, EINA_FALSE);
+   if (!src) return EINA_FALSE;
+   sstride = evas_object_image_stride_get(cw->obj) / 4;
+   if (w > sw) w = sw;
+   if (h > sh) h = sh;
+
+   evas_object_image_colorspace_set(img, EVAS_COLORSPACE_ARGB8888);
+   evas_object_image_alpha_set(img, evas_object_image_alpha_get(cw->obj));
+   evas_object_image_size_set(img, w, h);
+   dst = evas_object_image_data_get(img, EINA_TRUE);
+   if (!dst)
+     {
+        evas_object_image_data_set(cw->obj, src);
+        return EINA_FALSE;
+     }
+   dstride = evas_object_image_stride_get(img) / 4;
+
+   for (y = 0; y < h; y++)
+     {
+        int y1 = (y * sh) / h, y2 = ((y + 1) * sh) / h;
+        unsigned int *d = dst + (y * dstride);
+
+        if (y2 <= y1) y2 = y1 + 1;
+        ny = MIN(y2 - y1, SNAPSHOT_SAMPLES);
+        for (x = 0; x < w; x++)
+          {
+             int x1 = (x * sw) / w, x2 = ((x + 1) * sw) / w;
+             unsigned int a = 0, r = 0, g = 0, b = 0, n;
+
+             if (x2 <= x1) x2 = x1 + 1;
+             nx = MIN(x2 - x1, SNAPSHOT_SAMPLES);
+             for (i = 0; i < nx; i++)
+               xs[i] = x1 + ((i * (x2 - x1)) / nx);
+             for (j = 0; j < ny; j++)
+               {
+                  unsigned int *s = src + ((y1 + ((j * (y2 - y1)) / ny)) * sstride);
+
+                  for (i = 0; i < nx; i++)
+                    {
+                       unsigned int p = s[xs[i]];
+
+                       a += p >> 24;
+                       r += (p >> 16) & 0xff;
+                       g += (p >> 8) & 0xff;
+                       b += p & 0xff;
+                    }
+               }
+             n = nx * ny;
+             d[x] = ((a / n) << 24) | ((r / n) << 16) | ((g / n) << 8) | (b / n);
+          }
+     }
+   evas_object_image_data_set(cw->obj, src);
+   evas_object_image_data_set(img, dst);
+   evas_object_image_data_update_add(img, 0, 0, w, h);
+   return EINA_TRUE;
+}
+
 //////////////////////////////////////////////////////
 
 E_API Eina_Bool
@@ -6,6 +6,7 @@ typedef Eina_Bool (*E_Comp_Object_Key_Cb)(void *, Ecore_Event_Key *);
 typedef Eina_Bool (*E_Comp_Object_Mover_Cb) (void *data, Evas_Object *comp_object, const char *signal);
 
 typedef struct E_Comp_Object_Mover E_Comp_Object_Mover;
+typedef struct E_Comp_Object_Render_Stats E_Comp_Object_Render_Stats;
 
 typedef enum
 {
@@ -26,6 +27,17 @@ struct E_Event_Comp_Object
    Evas_Object *comp_object;
 };
 
+/* cumulative counters for e_comp_object_render() */
+struct E_Comp_Object_Render_Stats
+{
+   unsigned long long renders; // number of client renders
+   unsigned long long rects; // damage rects seen
+   unsigned long long bands; // coalesced bands fetched from the display server
+   unsigned long long pixels; // pixels fetched + converted
+   double time; // total time spent rendering
+   double time_max; // slowest single render
+};
+
 struct E_Comp_Object_Frame
 {
    int l, r, t, b;
@@ -39,6 +51,7 @@ E_API void e_comp_object_zoomap_set(Evas_Object *obj, Eina_Bool enabled);
 E_API Eina_Bool e_comp_object_mirror_visibility_check(Evas_Object *obj);
 E_API Evas_Object *e_comp_object_client_add(E_Client *ec);
 E_API Evas_Object *e_comp_object_util_mirror_add(Evas_Object *obj);
+E_API Eina_Bool e_comp_object_util_mirror_snapshot(Evas_Object *obj, Evas_Object *img, int w, int h);
 E_API void e_comp_object_util_type_set(Evas_Object *obj, E_Comp_Object_Type type);
 E_API Evas_Object *e_comp_object_util_add(Evas_Object *obj, E_Comp_Object_Type type);
 E_API Evas_Object *e_comp_object_util_get(Evas_Object *obj);
@@ -84,6 +97,8 @@ E_API Evas_Object *e_comp_object_agent_add(Evas_Object *obj);
 E_API void e_comp_object_blank(Evas_Object *obj, Eina_Bool set);
 E_API void e_comp_object_dirty(Evas_Object *obj);
 E_API Eina_Bool e_comp_object_render(Evas_Object *obj);
+E_API void e_comp_object_render_stats_get(E_Comp_Object_Render_Stats *stats);
+E_API void e_comp_object_render_stats_reset(void);
 E_API Eina_Bool e_comp_object_effect_allowed_get(Evas_Object *obj);
 E_API Eina_Bool e_comp_object_effect_set(Evas_Object *obj, const char *effect);
 E_API void e_comp_object_effect_params_set(Evas_Object *obj, int id, int *params, unsigned int count);
@@ -0,0 +1,224 @@
+#include "e.h"
+
+/* per-frame compositor profiler
+ *
+ * every interesting phase of a compositor frame is recorded as a span into a
+ * fixed-size ring. all producers (update job, comp object render, evas render
+ * callbacks) run on the main loop, so the ring is single-producer and needs
+ * no locking. the ring can be dumped in chrome trace format (chrome://tracing
+ * or perfetto) with the "comp_profile_dump" action or over dbus.
+ */
+
+#define AVERAGE_FRAMES 60
+
+static E_Comp_Profile_Span _spans[E_COMP_PROFILE_SPAN_COUNT];
+static unsigned int _span_now = 0;
+static unsigned int _span_count = 0;
+static unsigned int _frame = 0;
+static Eina_Bool _enabled = EINA_FALSE;
+static Eina_List *actions = NULL;
+
+static const char *_phase_names[] =
+{
+   "damage",
+   "update",
+   "client_render",
+   "render",
+   "swap",
+};
+
+static void
+_e_comp_profile_clear(void)
+{
+   unsigned int i;
+
+   for (i = 0; i < E_COMP_PROFILE_SPAN_COUNT; i++)
+     eina_stringshare_replace(&_spans[i].client, NULL);
+   memset(_spans, 0, sizeof(_spans));
+   _span_now = _span_count = 0;
+}
+
+static void
+_e_comp_profile_json_string(FILE *f, const char *str)
+{
+   const unsigned char *p;
+
+   fputc('"', f);
+   for (p = (const unsigned char *)str; p && *p; p++)
+     {
+        if ((*p == '"') || (*p == '\\'))
+          fprintf(f, "\\%c", *p);
+        else if (*p < 0x20)
+          fprintf(f, "\\u%04x", *p);
+        else
+          fputc(*p, f);
+     }
+   fputc('"', f);
+}
+
+static void
+_e_comp_profile_act_toggle_go(E_Object *obj EINA_UNUSED, const char *params EINA_UNUSED)
+{
+   e_comp_profile_enabled_set(!_enabled);
+}
+
+static void
+_e_comp_profile_act_dump_go(E_Object *obj EINA_UNUSED, const char *params)
+{
+   char buf[PATH_MAX];
+
+   if ((params) && (params[0]))
+     eina_strlcpy(buf, params, sizeof(buf));
+   else
+     e_user_dir_snprintf(buf, sizeof(buf), "comp-profile-%lld.json",
+                         (long long)ecore_time_unix_get());
+   if (e_comp_profile_dump(buf))
+     INF("COMP PROFILE: dumped to %s", buf);
+}
+
+EINTERN int
+e_comp_profile_init(void)
+{
+   E_Action *act;
+
+   if (getenv("E_COMP_PROFILE")) _enabled = EINA_TRUE;
+
+   act = e_action_add("comp_profile_toggle");
+   act->func.go = _e_comp_profile_act_toggle_go;
+   e_action_predef_name_set(N_("Compositor"),
+                            N_("Toggle frame profiler"), "comp_profile_toggle",
+                            NULL, NULL, 0);
+   actions = eina_list_append(actions, act);
+   act = e_action_add("comp_profile_dump");
+   act->func.go = _e_comp_profile_act_dump_go;
+   e_action_predef_name_set(N_("Compositor"),
+                            N_("Dump frame profile"), "comp_profile_dump",
+                            NULL, "syntax: file to write chrome trace json to (default in user dir)", 1);
+   actions = eina_list_append(actions, act);
+   return 1;
+}
+
+EINTERN int
+e_comp_profile_shutdown(void)
+{
+   E_FREE_LIST(actions, e_object_del);
+   _e_comp_profile_clear();
+   _enabled = EINA_FALSE;
+   return 1;
+}
+
+E_API void
+e_comp_profile_enabled_set(Eina_Bool enabled)
+{
+   enabled = !!enabled;
+   if (_enabled == enabled) return;
+   _enabled = enabled;
+   if (!enabled) _e_comp_profile_clear();
+   if (e_comp) e_comp_render_queue();
+}
+
+E_API Eina_Bool
+e_comp_profile_enabled_get(void)
+{
+   return _enabled;
+}
+
+E_API void
+e_comp_profile_span_add(E_Comp_Profile_Phase phase, double t0, double t1, const E_Client *ec, unsigned int pixels, unsigned int rects)
+{
+   E_Comp_Profile_Span *sp;
+
+   if ((!_enabled) || (t0 <= 0.0)) return;
+   EINA_SAFETY_ON_FALSE_RETURN(phase < E_COMP_PROFILE_PHASE_LAST);
+
+   sp = &_spans[_span_now];
+   sp->t0 = t0;
+   sp->t1 = t1;
+   eina_stringshare_replace(&sp->client, ec ? e_client_util_name_get(ec) : NULL);
+   sp->frame = _frame;
+   sp->pixels = pixels;
+   sp->rects = rects;
+   sp->phase = phase;
+   _span_now = (_span_now + 1) % E_COMP_PROFILE_SPAN_COUNT;
+   if (_span_count < E_COMP_PROFILE_SPAN_COUNT) _span_count++;
+}
+
+E_API void
+e_comp_profile_frame_end(void)
+{
+   if (_enabled) _frame++;
+}
+
+E_API double
+e_comp_profile_phase_average_get(E_Comp_Profile_Phase phase)
+{
+   unsigned int i, idx, first = 0, last = 0;
+   Eina_Bool found = EINA_FALSE;
+   double total = 0.0;
+
+   if ((!_enabled) || (phase >= E_COMP_PROFILE_PHASE_LAST)) return 0.0;
+   /* walk backwards over the last AVERAGE_FRAMES complete frames */
+   for (i = 0; i < _span_count; i++)
+     {
+        E_Comp_Profile_Span *sp;
+
+        idx = (_span_now + E_COMP_PROFILE_SPAN_COUNT - 1 - i) % E_COMP_PROFILE_SPAN_COUNT;
+        sp = &_spans[idx];
+        if (sp->frame == _frame) continue;
+        if (_frame - sp->frame > AVERAGE_FRAMES) break;
+        if (!found)
+          {
+             last = sp->frame;
+             found = EINA_TRUE;
+          }
+        first = sp->frame;
+        if (sp->phase == phase) total += sp->t1 - sp->t0;
+     }
+   if (!found) return 0.0;
+   return total / (double)(last - first + 1);
+}
+
+E_API Eina_Bool
+e_comp_profile_dump(const char *file)
+{
+   FILE *f;
+   unsigned int i, idx;
+   Eina_Bool first = EINA_TRUE;
+   int pid;
+
+   EINA_SAFETY_ON_NULL_RETURN_VAL(file, EINA_FALSE);
+   f = fopen(file, "w");
+   if (!f)
+     {
+        ERR("COMP PROFILE: could not open '%s' for writing", file);
+        return EINA_FALSE;
+     }
+   pid = getpid();
+   fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+   for (i = 0; i < _span_count; i++)
+     {
+        E_Comp_Profile_Span *sp;
+
+        idx = (_span_now + E_COMP_PROFILE_SPAN_COUNT - _span_count + i) % E_COMP_PROFILE_SPAN_COUNT;
+        sp = &_spans[idx];
+        fprintf(f, "%s{\"name\":", first ? "" : ",\n");
+        first = EINA_FALSE;
+        if (sp->client)
+          _e_comp_profile_json_string(f, sp->client);
+        else
+          _e_comp_profile_json_string(f, _phase_names[sp->phase]);
+        fprintf(f, ",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+                "\"pid\":%d,\"tid\":%d,"
+                "\"args\":{\"frame\":%u,\"pixels\":%u,\"rects\":%u}}",
+                _phase_names[sp->phase], sp->t0 * 1000000.0,
+                (sp->t1 - sp->t0) * 1000000.0, pid, (int)sp->phase,
+                sp->frame, sp->pixels, sp->rects);
+     }
+   fprintf(f, "\n]}\n");
+   if (fclose(f))
+     {
+        ERR("COMP PROFILE: error writing '%s'", file);
+        return EINA_FALSE;
+     }
+   return EINA_TRUE;
+}
@@ -0,0 +1,48 @@
+#ifdef E_TYPEDEFS
+
+typedef enum _E_Comp_Profile_Phase
+{
+   E_COMP_PROFILE_PHASE_DAMAGE, // per-client damage collection (pixmap refresh)
+   E_COMP_PROFILE_PHASE_UPDATE, // whole _e_comp_cb_update() pass
+   E_COMP_PROFILE_PHASE_CLIENT_RENDER, // per-client e_comp_object_render()
+   E_COMP_PROFILE_PHASE_RENDER, // evas render
+   E_COMP_PROFILE_PHASE_SWAP, // evas flush/buffer swap
+   E_COMP_PROFILE_PHASE_LAST
+} E_Comp_Profile_Phase;
+
+typedef struct _E_Comp_Profile_Span E_Comp_Profile_Span;
+
+#else
+#ifndef E_COMP_PROFILE_H
+#define E_COMP_PROFILE_H
+
+#define E_COMP_PROFILE_SPAN_COUNT 8192
+
+struct _E_Comp_Profile_Span
+{
+   double t0, t1; // begin/end time (ecore_time_get)
+   const char *client; // stringshared client name, NULL for global phases
+   unsigned int frame; // frame counter at the time of recording
+   unsigned int pixels; // pixels uploaded
+   unsigned int rects; // damage rects processed
+   E_Comp_Profile_Phase phase;
+};
+
+EINTERN int e_comp_profile_init(void);
+EINTERN int e_comp_profile_shutdown(void);
+E_API void e_comp_profile_enabled_set(Eina_Bool enabled);
+E_API Eina_Bool e_comp_profile_enabled_get(void);
+E_API void e_comp_profile_span_add(E_Comp_Profile_Phase phase, double t0, double t1, const E_Client *ec, unsigned int pixels, unsigned int rects);
+E_API void e_comp_profile_frame_end(void);
+E_API double e_comp_profile_phase_average_get(E_Comp_Profile_Phase phase);
+E_API Eina_Bool e_comp_profile_dump(const char *file);
+
+/* most callers only want to pay for the clock when profiling */
+#define E_COMP_PROFILE_BEGIN(_t) \
+  double _t = e_comp_profile_enabled_get() ? ecore_time_get() : 0.0
+#define E_COMP_PROFILE_END(_t, _phase, _ec, _pixels, _rects) \
+  do { if (e_comp_profile_enabled_get() && (_t > 0.0)) \
+         e_comp_profile_span_add(_phase, _t, ecore_time_get(), _ec, _pixels, _rects); } while (0)
+
+#endif
+#endif
@@ -26,6 +26,7 @@
 #define EXECUTIVE_MODE_ENABLED
 #define E_COMP_WL
 #include "e.h"
+#include <sys/mman.h>
 
 #if defined(__clang__)
 # pragma clang diagnostic ignored "-Wunused-parameter"
@@ -37,6 +38,10 @@
                      WL_DATA_DEVICE_MANAGER_DND_ACTION_MOVE | \
                      WL_DATA_DEVICE_MANAGER_DND_ACTION_ASK)
 
+/* bytes held by all saved selections, bounded by CLIPBOARD_SIZE_MAX */
+static size_t _clipboard_size = 0;
+static E_Client_Hook *_clipboard_client_del_hook = NULL;
+
 static void
 _mime_types_free(E_Comp_Wl_Data_Source *source)
 {
@@ -799,92 +804,553 @@ _e_comp_wl_data_cb_bind_manager(struct wl_client *client, void *data EINA_UNUSED
                                   e_comp->wl_comp_data, NULL);
 }
 
-static Eina_Bool
-_e_comp_wl_clipboard_offer_load(void *data, Ecore_Fd_Handler *handler)
+static int
+_e_comp_wl_clipboard_spill_fd_new(void)
 {
-   E_Comp_Wl_Clipboard_Offer *offer;
-   char *p;
-   size_t size;
-   int len;
-   int fd;
-
-   if (!(offer = (E_Comp_Wl_Clipboard_Offer *)data))
-     return ECORE_CALLBACK_CANCEL;
+   Eina_Tmpstr *tmpstr = NULL;
+   char tmp[PATH_MAX];
+   const char *path;
+   int fd, flags;
+
+#ifdef HAVE_MEMFD_CREATE
+   fd = memfd_create("e-clipboard", MFD_CLOEXEC);
+   if (fd >= 0) return fd;
+#endif
 
-   fd = ecore_main_fd_handler_fd_get(handler);
+   if (!(path = getenv("XDG_RUNTIME_DIR")))
+     return -1;
+   if (snprintf(tmp, sizeof(tmp), "%s/e-clipboard-XXXXXX", path) >= (int)sizeof(tmp))
+     return -1;
+   if ((fd = eina_file_mkstemp(tmp, &tmpstr)) < 0) return -1;
 
-   size = offer->source->contents.size;
-   p = (char *)offer->source->contents.data;
-   len = write(fd, p + offer->offset, size - offer->offset);
-   if (len > 0) offer->offset += len;
+   unlink(tmpstr);
+   eina_tmpstr_del(tmpstr);
 
-   if ((offer->offset == size) || (len <= 0))
+   flags = fcntl(fd, F_GETFD);
+   if ((flags < 0) || (fcntl(fd, F_SETFD, (flags | FD_CLOEXEC)) == -1))
      {
         close(fd);
-        ecore_main_fd_handler_del(handler);
-        e_comp_wl_clipboard_source_unref(offer->source);
-        free(offer);
+        return -1;
      }
+   return fd;
+}
 
-   return ECORE_CALLBACK_RENEW;
+static E_Comp_Wl_Clipboard_Data *
+_e_comp_wl_clipboard_data_new(E_Comp_Wl_Clipboard_Source *source, const char *mime_type)
+{
+   E_Comp_Wl_Clipboard_Data *cd;
+
+   cd = E_NEW(E_Comp_Wl_Clipboard_Data, 1);
+   if (!cd) return NULL;
+
+   cd->source = source;
+   cd->mime_type = eina_stringshare_add(mime_type);
+   cd->fd = -1;
+   cd->spill_fd = -1;
+   wl_array_init(&cd->contents);
+   eina_hash_add(source->data, mime_type, cd);
+
+   if (!source->data_source.mime_types)
+     source->data_source.mime_types = eina_array_new(1);
+   eina_array_push(source->data_source.mime_types,
+                   eina_stringshare_ref(cd->mime_type));
+   return cd;
+}
+
+static void
+_e_comp_wl_clipboard_data_read_stop(E_Comp_Wl_Clipboard_Data *cd)
+{
+   if (cd->fd_handler)
+     {
+        ecore_main_fd_handler_del(cd->fd_handler);
+        cd->fd_handler = NULL;
+     }
+   if (cd->fd >= 0)
+     {
+        close(cd->fd);
+        cd->fd = -1;
+     }
+   if (cd->source->current == cd)
+     cd->source->current = NULL;
+}
+
+static void
+_e_comp_wl_clipboard_data_storage_free(E_Comp_Wl_Clipboard_Data *cd)
+{
+   E_Comp_Wl_Clipboard_Source *source = cd->source;
+
+   if (cd->spill_fd >= 0)
+     {
+        close(cd->spill_fd);
+        cd->spill_fd = -1;
+     }
+   else
+     source->mem_size -= cd->size;
+   source->size -= cd->size;
+   _clipboard_size -= cd->size;
+   cd->size = 0;
+   wl_array_release(&cd->contents);
+   wl_array_init(&cd->contents);
 }
 
 static void
-_e_comp_wl_clipboard_offer_create(E_Comp_Wl_Clipboard_Source *source, int fd)
+_e_comp_wl_clipboard_data_free(void *data)
+{
+   E_Comp_Wl_Clipboard_Data *cd = data;
+
+   _e_comp_wl_clipboard_data_read_stop(cd);
+   _e_comp_wl_clipboard_data_storage_free(cd);
+   eina_stringshare_del(cd->mime_type);
+   free(cd);
+}
+
+static void
+_e_comp_wl_clipboard_data_offers_wake(E_Comp_Wl_Clipboard_Data *cd)
 {
    E_Comp_Wl_Clipboard_Offer *offer;
+   Eina_List *l;
 
-   offer = E_NEW(E_Comp_Wl_Clipboard_Offer, 1);
+   EINA_LIST_FOREACH(cd->offers, l, offer)
+     ecore_main_fd_handler_active_set(offer->fd_handler, ECORE_FD_WRITE);
+}
 
-   offer->offset = 0;
-   offer->source = source;
-   source->ref++;
-   offer->fd_handler =
-     ecore_main_fd_handler_add(fd, ECORE_FD_WRITE,
-                               _e_comp_wl_clipboard_offer_load, offer,
-                               NULL, NULL);
+static Eina_Bool
+_e_comp_wl_clipboard_mime_type_keep(void *data, void *gdata)
+{
+   E_Comp_Wl_Clipboard_Data *cd;
+
+   cd = eina_hash_find(((E_Comp_Wl_Clipboard_Source *)gdata)->data, data);
+   if ((!cd) || (!cd->failed)) return EINA_TRUE;
+   eina_stringshare_del(data);
+   return EINA_FALSE;
+}
+
+static void
+_e_comp_wl_clipboard_data_fail(E_Comp_Wl_Clipboard_Data *cd)
+{
+   E_Comp_Wl_Clipboard_Source *source = cd->source;
+
+   if (cd->failed) return;
+   cd->failed = EINA_TRUE;
+   _e_comp_wl_clipboard_data_read_stop(cd);
+   _e_comp_wl_clipboard_data_storage_free(cd);
+   /* readers still attached get their fd closed */
+   _e_comp_wl_clipboard_data_offers_wake(cd);
+   /* stop advertising what we can no longer provide */
+   if (source->data_source.mime_types)
+     eina_array_remove(source->data_source.mime_types,
+                       _e_comp_wl_clipboard_mime_type_keep, source);
 }
 
+/* move what is held on the heap so far into a memfd, after which reads
+ * from the owner are spliced straight into it */
 static Eina_Bool
-_e_comp_wl_clipboard_source_save(void *data EINA_UNUSED, Ecore_Fd_Handler *handler)
+_e_comp_wl_clipboard_data_spill(E_Comp_Wl_Clipboard_Data *cd)
 {
-   E_Comp_Wl_Clipboard_Source *source;
-   char *p;
-   int len, size;
+   size_t off = 0;
+   ssize_t len;
+   int fd;
 
-   if (!(source = (E_Comp_Wl_Clipboard_Source *)e_comp_wl->clipboard.source))
-     return ECORE_CALLBACK_CANCEL;
+   if ((fd = _e_comp_wl_clipboard_spill_fd_new()) < 0)
+     return EINA_FALSE;
 
-   /* extend contents buffer */
-   if ((source->contents.alloc - source->contents.size) < CLIPBOARD_CHUNK)
+   while (off < cd->size)
      {
-        wl_array_add(&source->contents, CLIPBOARD_CHUNK);
-        source->contents.size -= CLIPBOARD_CHUNK;
+        len = write(fd, (char *)cd->contents.data + off, cd->size - off);
+        if (len < 0)
+          {
+             if (errno == EINTR) continue;
+             close(fd);
+             return EINA_FALSE;
+          }
+        off += len;
      }
 
-   p = (char *)source->contents.data + source->contents.size;
-   size = source->contents.alloc - source->contents.size;
-   len = read(source->fd, p, size);
+   cd->source->mem_size -= cd->size;
+   wl_array_release(&cd->contents);
+   wl_array_init(&cd->contents);
+   cd->spill_fd = fd;
+   return EINA_TRUE;
+}
+
+static ssize_t
+_e_comp_wl_clipboard_data_read(E_Comp_Wl_Clipboard_Data *cd)
+{
+   char buf[CLIPBOARD_CHUNK];
+   size_t off = 0;
+   ssize_t len, wlen;
+
+   if (cd->spill_fd < 0)
+     {
+        /* extend contents buffer */
+        if ((cd->contents.alloc - cd->contents.size) < CLIPBOARD_CHUNK)
+          {
+             if (!wl_array_add(&cd->contents, CLIPBOARD_CHUNK))
+               return -1;
+             cd->contents.size -= CLIPBOARD_CHUNK;
+          }
+        len = read(cd->fd, (char *)cd->contents.data + cd->contents.size,
+                   cd->contents.alloc - cd->contents.size);
+        if (len > 0)
+          {
+             cd->contents.size += len;
+             cd->source->mem_size += len;
+          }
+        return len;
+     }
+
+#ifdef HAVE_SPLICE
+   len = splice(cd->fd, NULL, cd->spill_fd, NULL, CLIPBOARD_MEM_MAX,
+                SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+   if ((len >= 0) || (errno != EINVAL)) return len;
+#endif
+   len = read(cd->fd, buf, sizeof(buf));
+   while ((len > 0) && (off < (size_t)len))
+     {
+        wlen = write(cd->spill_fd, buf + off, len - off);
+        if (wlen < 0)
+          {
+             if (errno == EINTR) continue;
+             return -1;
+          }
+        off += wlen;
+     }
+   return len;
+}
+
+static void _e_comp_wl_clipboard_source_fetch_next(E_Comp_Wl_Clipboard_Source *source);
+
+static Eina_Bool
+_e_comp_wl_clipboard_data_save(void *data, Ecore_Fd_Handler *handler EINA_UNUSED)
+{
+   E_Comp_Wl_Clipboard_Data *cd = data;
+   E_Comp_Wl_Clipboard_Source *source = cd->source;
+   ssize_t len;
+
+   if ((cd->spill_fd < 0) &&
+       (source->mem_size + CLIPBOARD_CHUNK > CLIPBOARD_MEM_MAX))
+     {
+        if (!_e_comp_wl_clipboard_data_spill(cd))
+          {
+             WRN("Clipboard: dropping %s, could not spill it out of memory",
+                 cd->mime_type);
+             _e_comp_wl_clipboard_data_fail(cd);
+             _e_comp_wl_clipboard_source_fetch_next(source);
+             return ECORE_CALLBACK_RENEW;
+          }
+     }
+
+   len = _e_comp_wl_clipboard_data_read(cd);
+   if (len > 0)
+     {
+        cd->size += len;
+        source->size += len;
+        _clipboard_size += len;
+        if (_clipboard_size > CLIPBOARD_SIZE_MAX)
+          {
+             WRN("Clipboard: dropping %s, clipboard exceeds %d bytes",
+                 cd->mime_type, CLIPBOARD_SIZE_MAX);
+             _e_comp_wl_clipboard_data_fail(cd);
+             _e_comp_wl_clipboard_source_fetch_next(source);
+             return ECORE_CALLBACK_RENEW;
+          }
+        _e_comp_wl_clipboard_data_offers_wake(cd);
+        return ECORE_CALLBACK_RENEW;
+     }
+   else if ((len < 0) && ((errno == EAGAIN) || (errno == EINTR)))
+     return ECORE_CALLBACK_RENEW;
 
    if (len == 0)
      {
-        ecore_main_fd_handler_del(handler);
-        close(source->fd);
-        source->fd_handler = NULL;
+        DBG("Clipboard: saved %zu bytes of %s", cd->size, cd->mime_type);
+        cd->done = EINA_TRUE;
+        _e_comp_wl_clipboard_data_read_stop(cd);
+        _e_comp_wl_clipboard_data_offers_wake(cd);
      }
-   else if (len < 0)
+   else
+     _e_comp_wl_clipboard_data_fail(cd);
+
+   _e_comp_wl_clipboard_source_fetch_next(source);
+   return ECORE_CALLBACK_RENEW;
+}
+
+/* request the next saved representation from the owner. one at a time, so
+ * the owner never has more than a single transfer to serve */
+static void
+_e_comp_wl_clipboard_source_fetch_next(E_Comp_Wl_Clipboard_Source *source)
+{
+   E_Comp_Wl_Clipboard_Data *cd;
+   int p[2];
+
+   while ((!source->current) && (source->pending))
      {
-        e_comp_wl_clipboard_source_unref(source);
-        e_comp_wl->clipboard.source = NULL;
+        cd = eina_list_data_get(source->pending);
+        source->pending = eina_list_remove_list(source->pending, source->pending);
+
+        if ((!source->owner) || (_clipboard_size >= CLIPBOARD_SIZE_MAX) ||
+            (pipe2(p, O_CLOEXEC) == -1))
+          {
+             _e_comp_wl_clipboard_data_fail(cd);
+             continue;
+          }
+
+        cd->fd = p[0];
+        cd->fd_handler =
+          ecore_main_fd_handler_add(p[0], ECORE_FD_READ | ECORE_FD_ERROR,
+                                    _e_comp_wl_clipboard_data_save, cd,
+                                    NULL, NULL);
+        if (!cd->fd_handler)
+          {
+             close(p[1]);
+             _e_comp_wl_clipboard_data_fail(cd);
+             continue;
+          }
+        source->current = cd;
+        source->owner->send(source->owner, cd->mime_type, p[1]);
      }
+}
+
+static void
+_e_comp_wl_clipboard_source_cb_owner_destroy(struct wl_listener *listener, void *data EINA_UNUSED)
+{
+   E_Comp_Wl_Clipboard_Source *source;
+   E_Comp_Wl_Clipboard_Data *cd;
+   Eina_Iterator *it;
+   Eina_List *fail = NULL;
+
+   source = container_of(listener, E_Comp_Wl_Clipboard_Source,
+                         owner_destroy_listener);
+   wl_list_remove(&listener->link);
+   source->owner = NULL;
+
+   /* whatever is in flight still drains from the pipe, the rest is gone */
+   source->pending = eina_list_free(source->pending);
+   it = eina_hash_iterator_data_new(source->data);
+   EINA_ITERATOR_FOREACH(it, cd)
+     {
+        if ((cd == source->current) || (cd->done)) continue;
+        fail = eina_list_append(fail, cd);
+     }
+   eina_iterator_free(it);
+   EINA_LIST_FREE(fail, cd)
+     _e_comp_wl_clipboard_data_fail(cd);
+}
+
+static void
+_e_comp_wl_clipboard_data_queue(E_Comp_Wl_Clipboard_Data *cd, Eina_Bool first)
+{
+   E_Comp_Wl_Clipboard_Source *source = cd->source;
+
+   if (cd->queued) return;
+   cd->queued = EINA_TRUE;
+   if (first)
+     source->pending = eina_list_prepend(source->pending, cd);
    else
+     source->pending = eina_list_append(source->pending, cd);
+}
+
+/* the owner's last window is closing, so it is most likely about to exit:
+ * take everything it offers while it can still answer */
+static void
+_e_comp_wl_clipboard_cb_client_del(void *data EINA_UNUSED, E_Client *ec)
+{
+   E_Comp_Wl_Clipboard_Source *source = e_comp_wl->clipboard.source;
+   E_Comp_Wl_Clipboard_Data *cd;
+   E_Client *ec2;
+   Eina_Iterator *it;
+   Eina_List *l;
+   pid_t pid;
+
+   if ((!source) || (!source->owner) || (!source->owner->resource)) return;
+   if (ec->netwm.pid <= 0) return;
+   wl_client_get_credentials(wl_resource_get_client(source->owner->resource),
+                             &pid, NULL, NULL);
+   if (pid != ec->netwm.pid) return;
+   EINA_LIST_FOREACH(e_comp->clients, l, ec2)
+     {
+        if ((ec2 != ec) && (ec2->netwm.pid == pid) &&
+            (!e_object_is_del(E_OBJECT(ec2))))
+          return;
+     }
+
+   it = eina_hash_iterator_data_new(source->data);
+   EINA_ITERATOR_FOREACH(it, cd)
+     _e_comp_wl_clipboard_data_queue(cd, EINA_FALSE);
+   eina_iterator_free(it);
+   _e_comp_wl_clipboard_source_fetch_next(source);
+}
+
+/* what is worth holding before anyone asks: one text and one image type */
+static Eina_Bool
+_e_comp_wl_clipboard_mime_type_eager(const char *mime_type, const char *text, Eina_Bool *image)
+{
+   if ((text) && (!strcmp(mime_type, text))) return EINA_TRUE;
+   if ((!*image) && (!strncmp(mime_type, "image/", 6)))
+     {
+        *image = EINA_TRUE;
+        return EINA_TRUE;
+     }
+   return EINA_FALSE;
+}
+
+static void
+_e_comp_wl_clipboard_source_owner_set(E_Comp_Wl_Clipboard_Source *source, E_Comp_Wl_Data_Source *owner)
+{
+   static const char *texts[] =
+     { "text/plain;charset=utf-8", "UTF8_STRING", "text/plain", NULL };
+   E_Comp_Wl_Clipboard_Data *cd;
+   Eina_Iterator *it;
+   const char *text = NULL;
+   Eina_Bool image = EINA_FALSE;
+   unsigned int i;
+   char *t;
+
+   if (!owner->mime_types) return;
+
+   for (i = 0; (texts[i]) && (!text); i++)
+     {
+        it = eina_array_iterator_new(owner->mime_types);
+        EINA_ITERATOR_FOREACH(it, t)
+          {
+             if (!strcmp(t, texts[i]))
+               {
+                  text = texts[i];
+                  break;
+               }
+          }
+        eina_iterator_free(it);
+     }
+
+   /* every type is advertised, but only the preferred ones are fetched up
+    * front. the rest are fetched when a reader first asks for them */
+   it = eina_array_iterator_new(owner->mime_types);
+   EINA_ITERATOR_FOREACH(it, t)
+     {
+        if (eina_hash_find(source->data, t)) continue;
+        if (!(cd = _e_comp_wl_clipboard_data_new(source, t))) continue;
+        if (_e_comp_wl_clipboard_mime_type_eager(t, text, &image))
+          _e_comp_wl_clipboard_data_queue(cd, EINA_FALSE);
+     }
+   eina_iterator_free(it);
+
+   source->owner = owner;
+   source->owner_destroy_listener.notify =
+     _e_comp_wl_clipboard_source_cb_owner_destroy;
+   wl_signal_add(&owner->destroy_signal, &source->owner_destroy_listener);
+
+   _e_comp_wl_clipboard_source_fetch_next(source);
+}
+
+static void
+_e_comp_wl_clipboard_offer_free(E_Comp_Wl_Clipboard_Offer *offer)
+{
+   E_Comp_Wl_Clipboard_Data *cd = offer->data;
+
+   close(ecore_main_fd_handler_fd_get(offer->fd_handler));
+   ecore_main_fd_handler_del(offer->fd_handler);
+   cd->offers = eina_list_remove(cd->offers, offer);
+   e_comp_wl_clipboard_source_unref(cd->source);
+   free(offer);
+}
+
+static ssize_t
+_e_comp_wl_clipboard_offer_write(E_Comp_Wl_Clipboard_Offer *offer, int fd)
+{
+   E_Comp_Wl_Clipboard_Data *cd = offer->data;
+   char buf[CLIPBOARD_CHUNK];
+   size_t size;
+   ssize_t len;
+
+   size = cd->size - offer->offset;
+   if (cd->spill_fd < 0)
+     return write(fd, (char *)cd->contents.data + offer->offset, size);
+
+#ifdef HAVE_SPLICE
+   {
+      loff_t off = offer->offset;
+
+      len = splice(cd->spill_fd, &off, fd, NULL, MIN(size, (size_t)CLIPBOARD_MEM_MAX),
+                   SPLICE_F_NONBLOCK);
+      /* EINVAL: the reader is not a pipe */
+      if ((len >= 0) || (errno != EINVAL)) return len;
+   }
+#endif
+   len = pread(cd->spill_fd, buf, MIN(size, sizeof(buf)), offer->offset);
+   if (len <= 0) return -1;
+   return write(fd, buf, len);
+}
+
+static Eina_Bool
+_e_comp_wl_clipboard_offer_load(void *data, Ecore_Fd_Handler *handler)
+{
+   E_Comp_Wl_Clipboard_Offer *offer;
+   E_Comp_Wl_Clipboard_Data *cd;
+   ssize_t len;
+
+   if (!(offer = (E_Comp_Wl_Clipboard_Offer *)data))
+     return ECORE_CALLBACK_CANCEL;
+   cd = offer->data;
+
+   if ((!cd->failed) && (offer->offset < cd->size))
      {
-        source->contents.size += len;
+        len = _e_comp_wl_clipboard_offer_write
+          (offer, ecore_main_fd_handler_fd_get(handler));
+        if (len > 0)
+          offer->offset += len;
+        else if ((len < 0) && ((errno == EAGAIN) || (errno == EINTR)))
+          return ECORE_CALLBACK_RENEW;
+        else
+          {
+             _e_comp_wl_clipboard_offer_free(offer);
+             return ECORE_CALLBACK_RENEW;
+          }
      }
 
+   if ((!cd->failed) && (offer->offset < cd->size))
+     return ECORE_CALLBACK_RENEW;
+
+   /* caught up with the owner: sleep until more arrives */
+   if ((!cd->failed) && (!cd->done))
+     ecore_main_fd_handler_active_set(handler, 0);
+   else
+     _e_comp_wl_clipboard_offer_free(offer);
+
    return ECORE_CALLBACK_RENEW;
 }
 
+static void
+_e_comp_wl_clipboard_offer_create(E_Comp_Wl_Clipboard_Data *cd, int fd)
+{
+   E_Comp_Wl_Clipboard_Offer *offer;
+   int flags;
+
+   offer = E_NEW(E_Comp_Wl_Clipboard_Offer, 1);
+   if (!offer)
+     {
+        close(fd);
+        return;
+     }
+
+   /* never let a slow reader block the compositor */
+   flags = fcntl(fd, F_GETFL);
+   if (flags >= 0) fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+
+   offer->offset = 0;
+   offer->data = cd;
+   offer->fd_handler =
+     ecore_main_fd_handler_add(fd, ECORE_FD_WRITE,
+                               _e_comp_wl_clipboard_offer_load, offer,
+                               NULL, NULL);
+   if (!offer->fd_handler)
+     {
+        close(fd);
+        free(offer);
+        return;
+     }
+   cd->source->ref++;
+   cd->offers = eina_list_append(cd->offers, offer);
+}
+
 static void
 _e_comp_wl_clipboard_source_target_send(E_Comp_Wl_Data_Source *source EINA_UNUSED, uint32_t serial EINA_UNUSED, const char *mime_type EINA_UNUSED)
 {
@@ -894,16 +1360,35 @@ static void
 _e_comp_wl_clipboard_source_send_send(E_Comp_Wl_Data_Source *source, const char *mime_type, int fd)
 {
    E_Comp_Wl_Clipboard_Source *clip_source;
-   char *t;
+   E_Comp_Wl_Clipboard_Data *cd;
+   Eina_List *l;
 
    clip_source = container_of(source, E_Comp_Wl_Clipboard_Source, data_source);
    if (!clip_source) return;
 
-   t = eina_array_data_get(source->mime_types, 0);
-   if (!strcmp(mime_type, t))
-     _e_comp_wl_clipboard_offer_create(clip_source, fd);
-   else
-     close(fd);
+   cd = eina_hash_find(clip_source->data, mime_type);
+   if ((!cd) || (cd->failed))
+     {
+        close(fd);
+        return;
+     }
+
+   if (!cd->queued)
+     {
+        /* first reader of a type that was not fetched up front */
+        if (!clip_source->owner)
+          {
+             close(fd);
+             return;
+          }
+        _e_comp_wl_clipboard_data_queue(cd, EINA_TRUE);
+     }
+   /* asked for before we got to it: fetch it next */
+   else if ((l = eina_list_data_find_list(clip_source->pending, cd)))
+     clip_source->pending = eina_list_promote_list(clip_source->pending, l);
+
+   _e_comp_wl_clipboard_offer_create(cd, fd);
+   _e_comp_wl_clipboard_source_fetch_next(clip_source);
 }
 
 static void
@@ -916,8 +1401,6 @@ _e_comp_wl_clipboard_selection_set(struct wl_listener *listener EINA_UNUSED, voi
 {
    E_Comp_Wl_Data_Source *sel_source;
    E_Comp_Wl_Clipboard_Source *clip_source;
-   int p[2];
-   char *mime_type;
 
    sel_source = (E_Comp_Wl_Data_Source *)e_comp_wl->selection.data_source;
    clip_source = (E_Comp_Wl_Clipboard_Source *)e_comp_wl->clipboard.source;
@@ -937,19 +1420,15 @@ _e_comp_wl_clipboard_selection_set(struct wl_listener *listener EINA_UNUSED, voi
      e_comp_wl_clipboard_source_unref(clip_source);
 
    e_comp_wl->clipboard.source = NULL;
-   mime_type = eina_array_data_get(sel_source->mime_types, 0);
-
-   if (pipe2(p, O_CLOEXEC) == -1)
+   if ((!sel_source->mime_types) || (!eina_array_count(sel_source->mime_types)))
      return;
 
-   sel_source->send(sel_source, mime_type, p[1]);
-
-   e_comp_wl->clipboard.source =
-     e_comp_wl_clipboard_source_create(mime_type,
-                                       e_comp_wl->selection.serial, p[0]);
+   clip_source =
+     e_comp_wl_clipboard_source_create(NULL, e_comp_wl->selection.serial, -1);
+   if (!clip_source) return;
 
-   if (!e_comp_wl->clipboard.source)
-     close(p[0]);
+   e_comp_wl->clipboard.source = clip_source;
+   _e_comp_wl_clipboard_source_owner_set(clip_source, sel_source);
 }
 
 static void
@@ -1169,6 +1648,9 @@ e_comp_wl_data_manager_init(void)
 
    /* create clipboard */
    _e_comp_wl_clipboard_create();
+   _clipboard_client_del_hook =
+     e_client_hook_add(E_CLIENT_HOOK_DEL, _e_comp_wl_clipboard_cb_client_del,
+                       NULL);
    e_comp_wl->mgr.data_resources = eina_hash_pointer_new(NULL);
 
    return EINA_TRUE;
@@ -1181,6 +1663,7 @@ e_comp_wl_data_manager_shutdown(void)
    /* if (e_comp_wl->mgr.global) wl_global_destroy(e_comp_wl->mgr.global); */
 
    wl_list_remove(&e_comp_wl->clipboard.listener.link);
+   E_FREE_FUNC(_clipboard_client_del_hook, e_client_hook_del);
    E_FREE_FUNC(e_comp_wl->mgr.data_resources, eina_hash_free);
 }
 
@@ -1229,6 +1712,7 @@ E_API E_Comp_Wl_Clipboard_Source *
 e_comp_wl_clipboard_source_create(const char *mime_type, uint32_t serial, int fd)
 {
    E_Comp_Wl_Clipboard_Source *source;
+   E_Comp_Wl_Clipboard_Data *cd;
 
    source = E_NEW(E_Comp_Wl_Clipboard_Source, 1);
    if (!source) return NULL;
@@ -1238,36 +1722,34 @@ e_comp_wl_clipboard_source_create(const char *mime_type, uint32_t serial, int fd
    source->data_source.send = _e_comp_wl_clipboard_source_send_send;
    source->data_source.cancelled = _e_comp_wl_clipboard_source_cancelled_send;
 
-   wl_array_init(&source->contents);
+   source->data = eina_hash_string_superfast_new(_e_comp_wl_clipboard_data_free);
    wl_signal_init(&source->data_source.destroy_signal);
 
    source->ref = 1;
    source->serial = serial;
 
-   if (mime_type)
-     {
-        if (!source->data_source.mime_types)
-          source->data_source.mime_types = eina_array_new(1);
-        eina_array_push(source->data_source.mime_types,
-                        eina_stringshare_add(mime_type));
-     }
+   if (!mime_type) return source;
 
-   if (fd > 0)
+   cd = _e_comp_wl_clipboard_data_new(source, mime_type);
+   if ((cd) && (fd > 0))
      {
-        source->fd_handler =
-          ecore_main_fd_handler_file_add(fd, ECORE_FD_READ | ECORE_FD_ERROR,
-                                         _e_comp_wl_clipboard_source_save,
-                                         e_comp->wl_comp_data, NULL, NULL);
-        if (!source->fd_handler)
+        cd->fd_handler =
+          ecore_main_fd_handler_add(fd, ECORE_FD_READ | ECORE_FD_ERROR,
+                                    _e_comp_wl_clipboard_data_save, cd,
+                                    NULL, NULL);
+        if (!cd->fd_handler)
           {
+             eina_hash_free(source->data);
              _mime_types_free(&source->data_source);
              free(source);
              return NULL;
           }
+        cd->fd = fd;
+        /* already being read in, there is no owner to fetch it from */
+        cd->queued = EINA_TRUE;
+        source->current = cd;
      }
 
-   source->fd = fd;
-
    return source;
 }
 
@@ -1278,11 +1760,10 @@ e_comp_wl_clipboard_source_unref(E_Comp_Wl_Clipboard_Source *source)
    source->ref--;
    if (source->ref > 0) return;
 
-   if (source->fd_handler)
-     {
-        ecore_main_fd_handler_del(source->fd_handler);
-        close(source->fd);
-     }
+   if (source->owner)
+     wl_list_remove(&source->owner_destroy_listener.link);
+   source->pending = eina_list_free(source->pending);
+   E_FREE_FUNC(source->data, eina_hash_free);
 
    _mime_types_free(&source->data_source);
    if (source == e_comp_wl->clipboard.source)
@@ -1291,7 +1772,12 @@ e_comp_wl_clipboard_source_unref(E_Comp_Wl_Clipboard_Source *source)
      e_comp_wl->selection.data_source = NULL;
 
    wl_signal_emit(&source->data_source.destroy_signal, &source->data_source);
-   wl_array_release(&source->contents);
    free(source);
 }
 
+E_API size_t
+e_comp_wl_clipboard_source_size_get(const E_Comp_Wl_Clipboard_Source *source)
+{
+   EINA_SAFETY_ON_NULL_RETURN_VAL(source, 0);
+   return source->size;
+}
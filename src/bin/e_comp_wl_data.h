@@ -30,12 +30,18 @@
 
 #  include "e_comp_wl.h"
 
-#  define CLIPBOARD_CHUNK 1024
+#  define CLIPBOARD_CHUNK 4096
+/* heap bytes held per selection before representations spill to a memfd */
+#  define CLIPBOARD_MEM_MAX (256 * 1024)
+/* total bytes held across saved selections, representations past this are
+ * dropped */
+#  define CLIPBOARD_SIZE_MAX (64 * 1024 * 1024)
 
 typedef struct _E_Comp_Wl_Data_Source E_Comp_Wl_Data_Source;
 typedef struct _E_Comp_Wl_Data_Offer E_Comp_Wl_Data_Offer;
 typedef struct _E_Comp_Wl_Clipboard_Source E_Comp_Wl_Clipboard_Source;
 typedef struct _E_Comp_Wl_Clipboard_Offer E_Comp_Wl_Clipboard_Offer;
+typedef struct _E_Comp_Wl_Clipboard_Data E_Comp_Wl_Clipboard_Data;
 
 struct _E_Comp_Wl_Data_Source
 {
@@ -71,17 +77,39 @@ struct _E_Comp_Wl_Data_Offer
 struct _E_Comp_Wl_Clipboard_Source
 {
    E_Comp_Wl_Data_Source data_source;
-   Ecore_Fd_Handler *fd_handler;
+   E_Comp_Wl_Data_Source *owner; //selection source being saved, until it goes away
+   struct wl_listener owner_destroy_listener;
    uint32_t serial;
 
-   struct wl_array contents; //for extendable buffer
+   Eina_Hash *data; //mime type -> E_Comp_Wl_Clipboard_Data
+   Eina_List *pending; //representations waiting to be requested from the owner
+   E_Comp_Wl_Clipboard_Data *current; //representation being read
+   size_t mem_size; //bytes held on the heap
+   size_t size; //bytes held in total
    int ref;
-   int fd;
 };
 
-struct _E_Comp_Wl_Clipboard_Offer
+/* one saved mime type representation of a selection */
+struct _E_Comp_Wl_Clipboard_Data
 {
    E_Comp_Wl_Clipboard_Source *source;
+   Eina_Stringshare *mime_type;
+   Ecore_Fd_Handler *fd_handler;
+   Eina_List *offers; //readers streaming this representation
+
+   struct wl_array contents; //for extendable buffer, until spilled
+   size_t size;
+   int fd; //read end of the pipe from the owner
+   int spill_fd; //memfd holding contents once they outgrow the heap
+
+   Eina_Bool queued E_BITFIELD; //requested, or waiting to be, from the owner
+   Eina_Bool done E_BITFIELD;
+   Eina_Bool failed E_BITFIELD;
+};
+
+struct _E_Comp_Wl_Clipboard_Offer
+{
+   E_Comp_Wl_Clipboard_Data *data;
    Ecore_Fd_Handler *fd_handler;
    size_t offset;
 };
@@ -96,5 +124,6 @@ E_API struct wl_resource *e_comp_wl_data_find_for_client(struct wl_client *clien
 E_API E_Comp_Wl_Data_Source *e_comp_wl_data_manager_source_create(struct wl_client *client, struct wl_resource *resource, uint32_t id);
 E_API void e_comp_wl_clipboard_source_unref(E_Comp_Wl_Clipboard_Source *source);
 E_API E_Comp_Wl_Clipboard_Source *e_comp_wl_clipboard_source_create(const char *mime_type, uint32_t serial, int fd);
+E_API size_t e_comp_wl_clipboard_source_size_get(const E_Comp_Wl_Clipboard_Source *source);
 # endif
 #endif
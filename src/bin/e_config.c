@@ -52,6 +52,15 @@ static Eina_Lock  _e_config_pending_files_lock;
 static Eina_Hash *_e_config_pending_files = NULL;
 static Eina_Thread_Queue *_e_config_thread_thq = NULL;
 
+/* saves of the same file within this many seconds only write the last one */
+#define E_CONFIG_SAVE_COALESCE 0.5
+
+static Eina_Hash *_e_config_save_pending = NULL;
+static Ecore_Timer *_e_config_save_pending_timer = NULL;
+static Eina_Hash *_e_config_save_stats = NULL;
+static Eina_Bool _e_config_save_debug = EINA_FALSE;
+static Eina_Bool _e_config_save_error_shown = EINA_FALSE;
+
 static Eina_List *handlers = NULL;
 
 typedef struct _E_Color_Class
@@ -72,9 +81,33 @@ typedef struct _E_Config_Save_Thread_Message
 {
    Eina_Thread_Queue_Msg head;
    E_Config_Save_Thread_Message_Type type;
-   char *path, *destpath;
+   char *path, *destpath, *domain;
+   void *data;
+   int size;
+   Eina_Bool raw;
 } E_Config_Save_Thread_Message;
 
+/* a snapshot encoded on the main loop, waiting out the coalesce window
+ * before the save thread compresses it into the tmp file and moves that
+ * in place. raw data is written as is, otherwise it is the uncompressed
+ * output of eet_data_descriptor_encode() */
+typedef struct _E_Config_Save_Pending
+{
+   char *path, *destpath, *domain;
+   void *data;
+   int size;
+   Eina_Bool raw;
+} E_Config_Save_Pending;
+
+/* sent back from the save thread for each file written */
+typedef struct _E_Config_Save_Result
+{
+   char *domain;
+   const char *error;
+   double time;
+   Eina_Bool ok;
+} E_Config_Save_Result;
+
 static Eina_Bool
 _e_config_cb_efreet_cache_update(void *data EINA_UNUSED, int type EINA_UNUSED, void *ev EINA_UNUSED)
 {
@@ -158,7 +191,7 @@ _e_config_pending_file_find(const char *path)
 }
 
 static Eina_Bool
-_e_config_pending_file_del(const char *path)
+_e_config_pending_file_del(const char *path, const char **error)
 {
    Eet_File *ef;
    Eina_Bool ok = EINA_FALSE;
@@ -238,18 +271,112 @@ _e_config_pending_file_del(const char *path)
              break;
           }
         if (!ok) printf("CF: Write Error: %s\n", erstr);
+        if (error) *error = erstr;
      }
    else
-     eina_lock_release(&_e_config_pending_files_lock);
+     {
+        eina_lock_release(&_e_config_pending_files_lock);
+        if (error) *error = _("The settings file was not open for writing.");
+     }
    return ok;
 }
 
+/* write a snapshot into the tmp file. going through an Eet_Node writes
+ * exactly what eet_data_write() would, string dictionary and compression
+ * included, without needing the descriptor or the decoded struct here */
+static Eina_Bool
+_e_config_save_file_write(const char *path, const void *data, int size, Eina_Bool raw, const char **error)
+{
+   Eet_File *ef;
+   Eet_Node *node;
+   int ok;
+
+   ef = _e_config_pending_file_find(path);
+   if (!ef)
+     {
+        if (error) *error = _("The settings file could not be opened for writing.");
+        return EINA_FALSE;
+     }
+   if (raw)
+     ok = eet_write(ef, "config", data, size, 0);
+   else
+     {
+        node = eet_data_node_decode_cipher(data, NULL, size);
+        if (!node)
+          {
+             if (error) *error = _("The settings could not be encoded.");
+             return EINA_FALSE;
+          }
+        ok = eet_data_node_write_cipher(ef, "config", node, NULL,
+                                        EET_COMPRESSION_SUPERFAST);
+        eet_node_del(node);
+     }
+   if (ok <= 0)
+     {
+        if (error) *error = _("The settings could not be written to the file.");
+        return EINA_FALSE;
+     }
+   return EINA_TRUE;
+}
+
+/* write the snapshot, close the tmp file, rotate the old revisions and
+ * move it in place. runs on the save thread, or on the main loop for
+ * whatever is left at shutdown */
+static Eina_Bool
+_e_config_save_file_finish(const char *path, const char *destpath, const void *data, int size, Eina_Bool raw, const char **error)
+{
+   Eina_Bool ret = EINA_TRUE;
+
+   if (!_e_config_save_file_write(path, data, size, raw, error))
+     {
+        _e_config_pending_file_del(path, NULL);
+        return EINA_FALSE;
+     }
+   if (!_e_config_pending_file_del(path, error)) return EINA_FALSE;
+   if (_e_config_revisions > 0)
+     {
+        int i;
+        char bsrc[4096], bdst[4096];
+
+        for (i = _e_config_revisions; i > 1; i--)
+          {
+             snprintf(bsrc, sizeof(bsrc), "%s.%i", destpath, i - 1);
+             snprintf(bdst, sizeof(bdst), "%s.%i", destpath, i);
+             if ((ecore_file_exists(bsrc)) &&
+                 (ecore_file_size(bsrc)))
+               {
+                  ret = ecore_file_mv(bsrc, bdst);
+                  if (!ret)
+                    {
+                       printf("CF: Error: Can't rename %s to %s\n", bsrc, bdst);
+                       break;
+                    }
+               }
+          }
+        if (ret)
+          {
+             snprintf(bdst, sizeof(bdst), "%s.1", destpath);
+             ecore_file_mv(destpath, bdst);
+          }
+     }
+   if (!ecore_file_mv(path, destpath))
+     {
+        printf("CF: Error: Can't rename %s to %s\n", path, destpath);
+        if (error) *error = _("The new settings file could not be moved in place.");
+        return EINA_FALSE;
+     }
+   return EINA_TRUE;
+}
+
 static void
 _e_config_save_thread_main(void *data EINA_UNUSED, Ecore_Thread *eth)
 {
    E_Config_Save_Thread_Message *msg;
+   E_Config_Save_Result *res;
+   const char *error;
    void *ref;
-   Eina_Bool run = EINA_TRUE;
+   double t0;
+   Eina_Bool ok, run = EINA_TRUE;
 
    while (run)
      {
@@ -257,43 +384,29 @@ _e_config_save_thread_main(void *data EINA_UNUSED, Ecore_Thread *eth)
         switch (msg->type)
           {
            case E_CONFIG_SAVE_THREAD_SAVE:
-             if (_e_config_pending_file_del(msg->path))
+             t0 = ecore_time_get();
+             error = "";
+             ok = _e_config_save_file_finish(msg->path, msg->destpath,
+                                             msg->data, msg->size, msg->raw,
+                                             &error);
+             if (ok)
                {
-                  Eina_Bool ret = EINA_TRUE;
-
-                  if (_e_config_revisions > 0)
-                    {
-                       int i;
-                       char bsrc[4096], bdst[4096];
-
-                       for (i = _e_config_revisions; i > 1; i--)
-                         {
-                            snprintf(bsrc, sizeof(bsrc), "%s.%i", msg->destpath, i - 1);
-                            snprintf(bdst, sizeof(bdst), "%s.%i", msg->destpath, i);
-                            if ((ecore_file_exists(bsrc)) &&
-                                (ecore_file_size(bsrc)))
-                              {
-                                 ret = ecore_file_mv(bsrc, bdst);
-                                 if (!ret)
-                                   {
-                                      printf("CF: Error: Can't rename %s to %s\n", bsrc, bdst);
-                                      break;
-                                   }
-                              }
-                         }
-                       if (ret)
-                         {
-                            snprintf(bdst, sizeof(bdst), "%s.1", msg->destpath);
-                            ecore_file_mv(msg->destpath, bdst);
-                         }
-                    }
-                  if (!ecore_file_mv(msg->path, msg->destpath))
-                    printf("CF: Error: Can't rename %s to %s\n", msg->path, msg->destpath);
                   // open another tmp file now in a thread ready for writes next
                   // time. This can just dangle - no harm
                   _e_config_pending_file_find(msg->path);
-                  ecore_thread_feedback(eth, strdup(msg->destpath));
                }
+             free(msg->data);
+             res = malloc(sizeof(E_Config_Save_Result));
+             if (res)
+               {
+                  res->domain = msg->domain;
+                  res->error = error;
+                  res->time = ecore_time_get() - t0;
+                  res->ok = ok;
+                  ecore_thread_feedback(eth, res);
+               }
+             else
+               free(msg->domain);
              free(msg->path);
              free(msg->destpath);
              break;
@@ -307,11 +420,61 @@ _e_config_save_thread_main(void *data EINA_UNUSED, Ecore_Thread *eth)
      }
 }
 
+static E_Config_Save_Stats *
+_e_config_save_stats_get(const char *domain)
+{
+   E_Config_Save_Stats *st;
+
+   if (!_e_config_save_stats) return NULL;
+   st = eina_hash_find(_e_config_save_stats, domain);
+   if (st) return st;
+   st = E_NEW(E_Config_Save_Stats, 1);
+   if (!st) return NULL;
+   st->domain = eina_stringshare_add(domain);
+   eina_hash_add(_e_config_save_stats, domain, st);
+   return st;
+}
+
+static void
+_e_config_save_stats_free(E_Config_Save_Stats *st)
+{
+   eina_stringshare_del(st->domain);
+   free(st);
+}
+
 static void
 _e_config_save_thread_notify(void *data EINA_UNUSED, Ecore_Thread *eth EINA_UNUSED, void *msgdata)
 {
-   char *path = msgdata;
-   free(path);
+   E_Config_Save_Result *res = msgdata;
+   E_Config_Save_Stats *st;
+
+   st = _e_config_save_stats_get(res->domain);
+   if (st)
+     {
+        if (res->ok) st->writes++;
+        else st->failures++;
+        st->write_time += res->time;
+        if (res->time > st->write_max) st->write_max = res->time;
+        if (_e_config_save_debug)
+          printf("CF: save %s: %u bytes, encode %.3fms, write %.3fms%s\n",
+                 res->domain, st->size, st->encode_last * 1000.0,
+                 res->time * 1000.0, res->ok ? "" : " FAILED");
+     }
+   /* one dialog until a save works again, not one per file */
+   if (res->ok)
+     _e_config_save_error_shown = EINA_FALSE;
+   else if ((!_e_config_save_error_shown) && (e_main_loop_running))
+     {
+        _e_config_save_error_shown = EINA_TRUE;
+        e_util_dialog_show(_("Enlightenment Settings Write Problems"),
+                           _("Enlightenment has had an error while writing<ps/>"
+                             "its settings file \"%s\".<ps/>"
+                             "%s<ps/>"
+                             "Your changes may not have been saved."),
+                           res->domain, res->error);
+     }
+   free(res->domain);
+   free(res);
 }
 
 static void
@@ -326,8 +489,9 @@ _e_config_save_thread_cancel(void *data EINA_UNUSED, Ecore_Thread *eth EINA_UNUS
    ecore_main_loop_quit();
 }
 
+/* takes ownership of everything in pend (if given) */
 static void
-_e_config_save_thread_send(E_Config_Save_Thread_Message_Type type, const char *path, const char *destpath)
+_e_config_save_thread_send(E_Config_Save_Thread_Message_Type type, E_Config_Save_Pending *pend)
 {
    E_Config_Save_Thread_Message *msg;
    void *ref;
@@ -335,13 +499,120 @@ _e_config_save_thread_send(E_Config_Save_Thread_Message_Type type, const char *p
    msg = eina_thread_queue_send
      (_e_config_thread_thq, sizeof(E_Config_Save_Thread_Message), &ref);
    msg->type = type;
-   if (path) msg->path = strdup(path);
-   else msg->path = NULL;
-   if (destpath) msg->destpath = strdup(destpath);
-   else msg->destpath = NULL;
+   if (pend)
+     {
+        msg->path = pend->path;
+        msg->destpath = pend->destpath;
+        msg->domain = pend->domain;
+        msg->data = pend->data;
+        msg->size = pend->size;
+        msg->raw = pend->raw;
+        free(pend);
+     }
+   else
+     {
+        msg->path = msg->destpath = msg->domain = NULL;
+        msg->data = NULL;
+        msg->size = 0;
+        msg->raw = EINA_FALSE;
+     }
    eina_thread_queue_send_done(_e_config_thread_thq, ref);
 }
 
+static void
+_e_config_save_pending_free(E_Config_Save_Pending *pend)
+{
+   free(pend->path);
+   free(pend->destpath);
+   free(pend->domain);
+   free(pend->data);
+   free(pend);
+}
+
+static Eina_Bool
+_e_config_save_pending_send_cb(const Eina_Hash *hash EINA_UNUSED, const void *key EINA_UNUSED, void *data, void *fdata EINA_UNUSED)
+{
+   _e_config_save_thread_send(E_CONFIG_SAVE_THREAD_SAVE, data);
+   return EINA_TRUE;
+}
+
+static void
+_e_config_save_pending_flush(void)
+{
+   E_FREE_FUNC(_e_config_save_pending_timer, ecore_timer_del);
+   if (!eina_hash_population(_e_config_save_pending)) return;
+   eina_hash_foreach(_e_config_save_pending, _e_config_save_pending_send_cb, NULL);
+   /* ownership moved to the thread messages */
+   eina_hash_free_cb_set(_e_config_save_pending, NULL);
+   eina_hash_free_buckets(_e_config_save_pending);
+   eina_hash_free_cb_set(_e_config_save_pending, (Eina_Free_Cb)_e_config_save_pending_free);
+}
+
+static Eina_Bool
+_e_config_save_pending_cb(void *data EINA_UNUSED)
+{
+   _e_config_save_pending_timer = NULL;
+   _e_config_save_pending_flush();
+   return ECORE_CALLBACK_CANCEL;
+}
+
+/* hand a snapshot over to the save thread after the coalesce window.
+ * saving the same file again before that replaces the snapshot, so only
+ * the newest copy is compressed and hits the disk. takes data
+ */
+static void
+_e_config_save_pending_add(const char *path, const char *destpath, const char *domain, void *data, int size, Eina_Bool raw, double encode_time)
+{
+   E_Config_Save_Pending *pend;
+   E_Config_Save_Stats *st;
+
+   st = _e_config_save_stats_get(domain);
+   if (st)
+     {
+        st->saves++;
+        st->size = size;
+        st->encode_last = encode_time;
+        st->encode_time += encode_time;
+        if (encode_time > st->encode_max) st->encode_max = encode_time;
+     }
+   pend = eina_hash_find(_e_config_save_pending, path);
+   if (pend)
+     {
+        if (st) st->coalesced++;
+        free(pend->data);
+        pend->data = data;
+        pend->size = size;
+        pend->raw = raw;
+        return;
+     }
+   pend = E_NEW(E_Config_Save_Pending, 1);
+   if (!pend)
+     {
+        free(data);
+        return;
+     }
+   pend->data = data;
+   pend->size = size;
+   pend->raw = raw;
+   pend->path = strdup(path);
+   pend->destpath = strdup(destpath);
+   pend->domain = strdup(domain);
+   eina_hash_add(_e_config_save_pending, path, pend);
+   if (!_e_config_save_pending_timer)
+     _e_config_save_pending_timer =
+       ecore_timer_loop_add(E_CONFIG_SAVE_COALESCE, _e_config_save_pending_cb, NULL);
+}
+
+static Eina_Bool
+_e_config_save_pending_finish_cb(const Eina_Hash *hash EINA_UNUSED, const void *key EINA_UNUSED, void *data, void *fdata EINA_UNUSED)
+{
+   E_Config_Save_Pending *pend = data;
+
+   _e_config_save_file_finish(pend->path, pend->destpath,
+                              pend->data, pend->size, pend->raw, NULL);
+   return EINA_TRUE;
+}
+
 static void
 _e_config_edd_shutdown(void)
 {
@@ -727,6 +998,7 @@ _e_config_edd_init(Eina_Bool old)
    E_CONFIG_VAL(D, T, winlist_list_focus_while_selecting, INT); /**/
    E_CONFIG_VAL(D, T, winlist_list_raise_while_selecting, INT); /**/
    E_CONFIG_VAL(D, T, winlist_list_move_after_select, INT); /**/
+   E_CONFIG_VAL(D, T, winlist_list_show_previews, INT); /**/
    E_CONFIG_VAL(D, T, winlist_pos_align_x, DOUBLE); /**/
    E_CONFIG_VAL(D, T, winlist_pos_align_y, DOUBLE); /**/
    E_CONFIG_VAL(D, T, winlist_pos_size_w, DOUBLE); /**/
@@ -1008,6 +1280,10 @@ e_config_init(void)
    eina_lock_new(&_e_config_pending_files_lock);
    _e_config_pending_files = eina_hash_string_superfast_new(NULL);
 
+   _e_config_save_pending = eina_hash_string_superfast_new((Eina_Free_Cb)_e_config_save_pending_free);
+   _e_config_save_stats = eina_hash_string_superfast_new((Eina_Free_Cb)_e_config_save_stats_free);
+   _e_config_save_debug = !!getenv("E_CONFIG_SAVE_DEBUG");
+
    _e_config_thread_thq = eina_thread_queue_new();
    ecore_thread_feedback_run(_e_config_save_thread_main,
                              _e_config_save_thread_notify,
@@ -1212,6 +1488,14 @@ EINTERN int
 e_config_shutdown(void)
 {
    E_FREE_LIST(handlers, ecore_event_handler_del);
+   E_FREE_FUNC(_e_config_save_pending_timer, ecore_timer_del);
+   /* saves queued after e_config_save_flush() stopped the save thread
+    * (module, desk, remember and comp configs saved on the way out) are
+    * finished here, on this thread */
+   if (_e_config_save_pending)
+     eina_hash_foreach(_e_config_save_pending, _e_config_save_pending_finish_cb, NULL);
+   E_FREE_FUNC(_e_config_save_pending, eina_hash_free);
+   E_FREE_FUNC(_e_config_save_stats, eina_hash_free);
    eina_stringshare_del(_e_config_profile);
    E_CONFIG_DD_FREE(_e_config_binding_edd);
    E_CONFIG_DD_FREE(_e_config_bindings_mouse_edd);
@@ -1833,6 +2117,7 @@ e_config_load(void)
    E_CONFIG_LIMIT(e_config->winlist_list_show_other_screen_windows, 0, 1);
    E_CONFIG_LIMIT(e_config->winlist_list_uncover_while_selecting, 0, 1);
    E_CONFIG_LIMIT(e_config->winlist_list_jump_desk_while_selecting, 0, 1);
+   E_CONFIG_LIMIT(e_config->winlist_list_show_previews, 0, 1);
    E_CONFIG_LIMIT(e_config->winlist_pos_align_x, 0.0, 1.0);
    E_CONFIG_LIMIT(e_config->winlist_pos_align_y, 0.0, 1.0);
    E_CONFIG_LIMIT(e_config->winlist_pos_size_w, 0.0, 1.0);
@@ -1989,9 +2274,10 @@ e_config_save_flush(void)
         _e_config_save_defer = NULL;
         _e_config_save_cb(NULL);
      }
+   _e_config_save_pending_flush();
    if (!e_main_loop_running)
      {
-        _e_config_save_thread_send(E_CONFIG_SAVE_THREAD_QUIT, NULL, NULL);
+        _e_config_save_thread_send(E_CONFIG_SAVE_THREAD_QUIT, NULL);
         // wait for save thread to exit...
         ecore_main_loop_begin();
      }
@@ -2143,6 +2429,23 @@ e_config_save_block_get(void)
    return _e_config_save_block;
 }
 
+static void *
+_e_config_data_read(Eet_File *ef, E_Config_DD *edd)
+{
+   void *data, *enc;
+   int size = 0;
+
+   data = eet_data_read(ef, edd, "config");
+   if (data) return data;
+   /* files written by builds that stored snapshots encoded without the
+    * file's string dictionary */
+   enc = eet_read(ef, "config", &size);
+   if (!enc) return NULL;
+   if (size > 0) data = eet_data_descriptor_decode(edd, enc, size);
+   free(enc);
+   return data;
+}
+
 /**
  * Loads configurations from file located in the working profile
  * The configurations are stored in a struct declated by the
@@ -2165,7 +2468,7 @@ e_config_domain_load(const char *domain, E_Config_DD *edd)
    ef = eet_open(buf, EET_FILE_MODE_READ);
    if (ef)
      {
-        data = eet_data_read(ef, edd, "config");
+        data = _e_config_data_read(ef, edd);
         eet_close(ef);
         if (data) return data;
      }
@@ -2177,7 +2480,7 @@ e_config_domain_load(const char *domain, E_Config_DD *edd)
         ef = eet_open(buf, EET_FILE_MODE_READ);
         if (ef)
           {
-             data = eet_data_read(ef, edd, "config");
+             data = _e_config_data_read(ef, edd);
              eet_close(ef);
              if (data) return data;
           }
@@ -2197,7 +2500,7 @@ e_config_domain_system_load(const char *domain, E_Config_DD *edd)
    ef = eet_open(buf, EET_FILE_MODE_READ);
    if (ef)
      {
-        data = eet_data_read(ef, edd, "config");
+        data = _e_config_data_read(ef, edd);
         eet_close(ef);
         return data;
      }
@@ -2208,8 +2511,8 @@ e_config_domain_system_load(const char *domain, E_Config_DD *edd)
 E_API int
 e_config_profile_save(void)
 {
-   Eet_File *ef;
    char buf[4096], buf2[4096];
+   void *data;
    const char *s;
    int ok = 0;
    static signed char nosave = -1;
@@ -2225,13 +2528,11 @@ e_config_profile_save(void)
    e_user_dir_concat_static(buf, "config/profile.cfg");
    e_user_dir_concat_static(buf2, "config/profile.cfg.tmp");
 
-   ef = _e_config_pending_file_find(buf2);
-   if (ef)
-     {
-        ok = eet_write(ef, "config", _e_config_profile,
-                       strlen(_e_config_profile), 0);
-        _e_config_save_thread_send(E_CONFIG_SAVE_THREAD_SAVE, buf2, buf);
-     }
+   ok = strlen(_e_config_profile);
+   data = malloc(ok);
+   if (!data) return 0;
+   memcpy(data, _e_config_profile, ok);
+   _e_config_save_pending_add(buf2, buf, "profile", data, ok, EINA_TRUE, 0.0);
    return ok;
 }
 
@@ -2244,13 +2545,20 @@ e_config_profile_save(void)
  * @param edd pointer to struct definition
  * @param data struct to save as configuration file
  * @return 1 if save success, 0 on failure
+ *
+ * The struct is encoded into a snapshot right away, so it may be changed
+ * or freed as soon as this returns. Compressing and writing it out happen
+ * on the save thread, and repeated saves of a domain within
+ * E_CONFIG_SAVE_COALESCE seconds only write the newest copy. Errors
+ * writing it out are shown in a dialog as they can't be returned here.
  */
 E_API int
 e_config_domain_save(const char *domain, E_Config_DD *edd, const void *data)
 {
-   Eet_File *ef;
    char buf[4096], buf2[4096];
-   int ok = 0;
+   void *snap;
+   int size = 0;
+   double t0;
    size_t len, len2;
 
    if (_e_config_save_block) return 0;
@@ -2275,14 +2583,40 @@ e_config_domain_save(const char *domain, E_Config_DD *edd, const void *data)
    memcpy(buf2, buf, len);
    memcpy(buf2 + len, ".tmp", sizeof(".tmp"));
 
-   ef = _e_config_pending_file_find(buf2);
-   if (ef)
+   t0 = ecore_time_get();
+   snap = eet_data_descriptor_encode(edd, data, &size);
+   if ((!snap) || (size <= 0))
      {
-        ok = eet_data_write(ef, edd, "config", data,
-                            EET_COMPRESSION_SUPERFAST);
-        _e_config_save_thread_send(E_CONFIG_SAVE_THREAD_SAVE, buf2, buf);
+        free(snap);
+        return 0;
      }
-   return ok;
+   _e_config_save_pending_add(buf2, buf, domain, snap, size, EINA_FALSE,
+                              ecore_time_get() - t0);
+   return 1;
+}
+
+static Eina_Bool
+_e_config_save_stats_list_cb(const Eina_Hash *hash EINA_UNUSED, const void *key EINA_UNUSED, void *data, void *fdata)
+{
+   Eina_List **l = fdata;
+
+   *l = eina_list_append(*l, data);
+   return EINA_TRUE;
+}
+
+/**
+ * Returns the save statistics of every domain saved so far.
+ *
+ * @return a list of E_Config_Save_Stats owned by e; free only the list
+ */
+E_API Eina_List *
+e_config_save_stats_list(void)
+{
+   Eina_List *l = NULL;
+
+   if (_e_config_save_stats)
+     eina_hash_foreach(_e_config_save_stats, _e_config_save_stats_list_cb, &l);
+   return l;
 }
 
 E_API E_Config_Binding_Mouse *
@@ -28,6 +28,8 @@ typedef struct _E_Event_Config_Icon_Theme   E_Event_Config_Icon_Theme;
 
 typedef struct E_Config_Bindings E_Config_Bindings;
 
+typedef struct _E_Config_Save_Stats         E_Config_Save_Stats;
+
 typedef enum
 {
    E_CONFIG_PROFILE_TYPE_NONE,
@@ -131,6 +133,7 @@ struct _E_Config
    int         winlist_list_focus_while_selecting; // GUI
    int         winlist_list_raise_while_selecting; // GUI
    int         winlist_list_move_after_select; // GUI
+   int         winlist_list_show_previews; // GUI
    double      winlist_pos_align_x; // GUI
    double      winlist_pos_align_y; // GUI
    double      winlist_pos_size_w; // GUI
@@ -651,6 +654,22 @@ struct _E_Config_XKB_Option
    const char *name;
 };
 
+/* per-domain costs of e_config_domain_save() */
+struct _E_Config_Save_Stats
+{
+   const char  *domain;
+   unsigned int saves; // e_config_domain_save() calls
+   unsigned int coalesced; // saves replaced by a newer one before being written out
+   unsigned int writes; // files written
+   unsigned int failures; // files that failed to write
+   unsigned int size; // uncompressed bytes of the last save
+   double       encode_time; // total time encoding on the main loop
+   double       encode_max;
+   double       encode_last;
+   double       write_time; // total time compressing, writing out + renaming on the save thread
+   double       write_max;
+};
+
 EINTERN int                   e_config_init(void);
 EINTERN int                   e_config_shutdown(void);
 
@@ -674,6 +693,7 @@ E_API void                    *e_config_domain_load(const char *domain, E_Config
 E_API void                    *e_config_domain_system_load(const char *domain, E_Config_DD *edd);
 E_API int                      e_config_profile_save(void);
 E_API int                      e_config_domain_save(const char *domain, E_Config_DD *edd, const void *data);
+E_API Eina_List               *e_config_save_stats_list(void);
 
 E_API E_Config_Binding_Mouse  *e_config_binding_mouse_match(E_Config_Binding_Mouse *eb_in);
 E_API E_Config_Binding_Key    *e_config_binding_key_match(E_Config_Binding_Key *eb_in);
@@ -21,6 +21,9 @@ typedef struct E_Smart_Data
 
    Eina_List *handlers;
 
+   Ecore_Timer *thumb_timer;
+   double thumb_rate;
+
    Evas_Coord x, y;
    int w, h;
 
@@ -32,6 +35,7 @@ typedef struct E_Smart_Data
 
    Eina_Bool resize E_BITFIELD;
    Eina_Bool force E_BITFIELD;
+   Eina_Bool thumb E_BITFIELD;
 } E_Smart_Data;
 
 typedef struct Mirror
@@ -41,9 +45,11 @@ typedef struct Mirror
    E_Client *ec;
    Evas_Object *comp_object;
    Evas_Object *mirror;
+   Evas_Object *thumb; // downscaled snapshot used in place of a live mirror
    int x, y, w, h;
    int ref;
    Eina_Bool added E_BITFIELD;
+   Eina_Bool thumb_dirty E_BITFIELD;
 } Mirror;
 
 typedef struct Mirror_Border
@@ -62,6 +68,7 @@ static void _e_deskmirror_mirror_color_set_cb(void *data, Evas_Object *obj, void
 
 static void _e_deskmirror_mirror_setup(Mirror *m);
 static void _comp_object_dirty(void *data, Evas_Object *obj, void *event_info EINA_UNUSED);
+static void _comp_object_thumb_dirty(void *data, Evas_Object *obj, void *event_info EINA_UNUSED);
 static void _comp_object_hide(Mirror *m, Evas *e EINA_UNUSED, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED);
 static void _comp_object_show(Mirror *m, Evas *e EINA_UNUSED, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED);
 static void _comp_object_stack(Mirror *m, Evas *e EINA_UNUSED, Evas_Object *obj, void *event_info EINA_UNUSED);
@@ -132,6 +139,97 @@ _mirror_unref(Mirror *m)
    free(m);
 }
 
+static void
+_mirror_thumb_size_get(Mirror *m, int *w, int *h)
+{
+   double sc = 0.125;
+   int cw, ch;
+
+   /* before the first resize there is no scale yet: guess small,
+    * the resize will mark everything dirty anyway
+    */
+   if ((m->sd->h > 0) && (m->sd->desk->zone->h > 0))
+     sc = (double)m->sd->h / (double)m->sd->desk->zone->h;
+   if (sc > 1.0) sc = 1.0;
+   evas_object_geometry_get(m->comp_object, NULL, NULL, &cw, &ch);
+   *w = MAX(1, (int)(cw * sc + 0.5));
+   *h = MAX(1, (int)(ch * sc + 0.5));
+}
+
+static void
+_mirror_thumb_update(Mirror *m)
+{
+   int w, h;
+
+   m->thumb_dirty = 0;
+   if ((!m->thumb) || (!m->comp_object)) return;
+   _mirror_thumb_size_get(m, &w, &h);
+   /* on failure keep showing the previous snapshot */
+   e_comp_object_util_mirror_snapshot(m->comp_object, m->thumb, w, h);
+}
+
+static Eina_Bool
+_e_deskmirror_thumb_cb(void *data)
+{
+   E_Smart_Data *sd = data;
+   Mirror *m;
+   Eina_Bool updated = EINA_FALSE;
+
+   /* hidden deskmirrors and desks keep their stale snapshots until shown */
+   if (evas_object_visible_get(sd->obj))
+     {
+        EINA_INLIST_FOREACH(sd->mirrors, m)
+          {
+             if (!m->thumb_dirty) continue;
+             if ((!sd->desk->visible) && ((!m->ec) || (!m->ec->sticky))) continue;
+             _mirror_thumb_update(m);
+             updated = EINA_TRUE;
+          }
+     }
+   /* keep ticking while there is work so the next update is held back */
+   if (updated) return ECORE_CALLBACK_RENEW;
+   sd->thumb_timer = NULL;
+   return ECORE_CALLBACK_CANCEL;
+}
+
+static void
+_e_deskmirror_thumb_queue(E_Smart_Data *sd)
+{
+   if ((!sd->thumb) || sd->thumb_timer) return;
+   sd->thumb_timer = ecore_timer_loop_add(1.0 / sd->thumb_rate, _e_deskmirror_thumb_cb, sd);
+}
+
+static void
+_e_deskmirror_thumb_dirty_all(E_Smart_Data *sd)
+{
+   Mirror *m;
+
+   EINA_INLIST_FOREACH(sd->mirrors, m)
+     if (m->thumb) m->thumb_dirty = 1;
+   _e_deskmirror_thumb_queue(sd);
+}
+
+static Evas_Object *
+_e_deskmirror_mirror_image_add(Mirror *m)
+{
+   Evas_Object *o;
+   int w, h;
+
+   if ((!m->sd->thumb) || (!m->ec))
+     return e_comp_object_util_mirror_add(m->comp_object);
+   o = evas_object_image_filled_add(m->sd->e);
+   evas_object_image_smooth_scale_set(o, e_comp_config_get()->smooth_windows);
+   _mirror_thumb_size_get(m, &w, &h);
+   if (e_comp_object_util_mirror_snapshot(m->comp_object, o, w, h))
+     {
+        m->thumb = o;
+        return o;
+     }
+   /* no cpu-side pixels (native surface): fall back to a live mirror */
+   evas_object_del(o);
+   return e_comp_object_util_mirror_add(m->comp_object);
+}
+
 static void
 _e_deskmirror_smart_reconfigure(E_Smart_Data *sd)
 {
@@ -187,6 +285,7 @@ _e_deskmirror_smart_del(Evas_Object *obj)
         sd->desk = NULL;
      }
    E_FREE_LIST(sd->handlers, ecore_event_handler_del);
+   E_FREE_FUNC(sd->thumb_timer, ecore_timer_del);
    eina_hash_free(sd->mirror_hash);
    evas_object_del(sd->clip);
    evas_object_del(sd->bgpreview);
@@ -212,6 +311,7 @@ _e_deskmirror_smart_resize(Evas_Object *obj, Evas_Coord w, Evas_Coord h)
    sd->h = h;
    sd->resize = 1;
    _e_deskmirror_smart_reconfigure(sd);
+   _e_deskmirror_thumb_dirty_all(sd);
 }
 
 static void
@@ -232,6 +332,7 @@ _e_deskmirror_smart_show(Evas_Object *obj)
         evas_object_show(mb->mirror);
      }
    evas_object_show(sd->clip);
+   _e_deskmirror_thumb_queue(sd);
 }
 
 static void
@@ -387,6 +488,8 @@ _mirror_client_smart_del(Evas_Object *obj)
      }
    evas_object_del(mb->frame);
    mb->frame = NULL;
+   if (mb->m->thumb == mb->mirror)
+     mb->m->thumb = NULL;
    evas_object_del(mb->mirror);
    mb->mirror = NULL;
    _mirror_unref(mb->m);
@@ -536,6 +639,7 @@ _e_deskmirror_mirror_del_hash(Mirror *m)
    if (m->comp_object)
      {
         evas_object_smart_callback_del_full(m->comp_object, "dirty", _comp_object_dirty, m);
+        evas_object_smart_callback_del_full(m->comp_object, "dirty", _comp_object_thumb_dirty, m);
         evas_object_smart_callback_del_full(m->comp_object, "frame_recalc_done", _e_deskmirror_mirror_frame_recalc_cb, m);
         evas_object_smart_callback_del_full(m->comp_object, "color_set", _e_deskmirror_mirror_color_set_cb, m);
         evas_object_event_callback_del_full(m->comp_object, EVAS_CALLBACK_DEL, _e_deskmirror_mirror_del_cb, m);
@@ -614,7 +718,7 @@ _comp_object_check(Mirror *m)
    if ((w < 2) || (h < 2)) return EINA_FALSE;
    if (!m->mirror)
      {
-        m->mirror = e_comp_object_util_mirror_add(m->comp_object);
+        m->mirror = _e_deskmirror_mirror_image_add(m);
         if (!m->mirror) return EINA_FALSE;
      }
    evas_object_smart_callback_del(m->comp_object, "dirty", _comp_object_dirty);
@@ -681,6 +785,16 @@ _comp_object_dirty(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EI
    _comp_object_check(data);
 }
 
+static void
+_comp_object_thumb_dirty(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+{
+   Mirror *m = data;
+
+   if (!m->thumb) return;
+   m->thumb_dirty = 1;
+   _e_deskmirror_thumb_queue(m->sd);
+}
+
 static Mirror *
 _e_deskmirror_mirror_add(E_Smart_Data *sd, Evas_Object *obj)
 {
@@ -714,18 +828,18 @@ _e_deskmirror_mirror_add(E_Smart_Data *sd, Evas_Object *obj)
              if (sd->desk != e_desk_current_get(sd->desk->zone)) return NULL;
           }
      }
+   m = calloc(1, sizeof(Mirror));
+   m->comp_object = obj;
+   m->ec = ec;
+   m->sd = sd;
+   m->ref = 1;
    evas_object_geometry_get(obj, NULL, NULL, &w, &h);
    if ((w > 1) && (h > 1))
      {
-        o = e_comp_object_util_mirror_add(obj);
+        o = _e_deskmirror_mirror_image_add(m);
         evas_object_name_set(o, "m->mirror");
      }
-   m = calloc(1, sizeof(Mirror));
-   m->comp_object = obj;
-   m->ec = ec;
-   m->sd = sd;
    m->mirror = o;
-   m->ref = 1;
    evas_object_event_callback_add(m->comp_object, EVAS_CALLBACK_DEL, _e_deskmirror_mirror_del_cb, m);
    evas_object_event_callback_add(obj, EVAS_CALLBACK_SHOW, (Evas_Object_Event_Cb)_comp_object_show, m);
    evas_object_event_callback_add(obj, EVAS_CALLBACK_HIDE, (Evas_Object_Event_Cb)_comp_object_hide, m);
@@ -736,6 +850,8 @@ _e_deskmirror_mirror_add(E_Smart_Data *sd, Evas_Object *obj)
    evas_object_smart_callback_add(obj, "color_set", _e_deskmirror_mirror_color_set_cb, m);
    if (ec && (!ec->redirected) && (!ec->new_client) && e_pixmap_usable_get(ec->pixmap))
      evas_object_smart_callback_add(obj, "dirty", _comp_object_dirty, m);
+   if (sd->thumb && ec)
+     evas_object_smart_callback_add(obj, "dirty", _comp_object_thumb_dirty, m);
    sd->mirrors = eina_inlist_append(sd->mirrors, EINA_INLIST_GET(m));
    eina_hash_add(sd->mirror_hash, &obj, m);
    _e_deskmirror_mirror_setup(m);
@@ -810,9 +926,17 @@ _client_property(E_Smart_Data *sd, int type EINA_UNUSED, E_Event_Client_Property
    return ECORE_CALLBACK_RENEW;
 }
 
-/* externally accessible functions */
-E_API Evas_Object *
-e_deskmirror_add(E_Desk *desk, Eina_Bool pager, Eina_Bool taskbar)
+static Eina_Bool
+_desk_show(E_Smart_Data *sd, int type EINA_UNUSED, E_Event_Desk_Show *ev)
+{
+   /* pick up whatever changed while the desk was hidden */
+   if (ev->desk == sd->desk)
+     _e_deskmirror_thumb_queue(sd);
+   return ECORE_CALLBACK_RENEW;
+}
+
+static Evas_Object *
+_e_deskmirror_add(E_Desk *desk, Eina_Bool pager, Eina_Bool taskbar, double thumb_rate)
 {
    E_Smart_Data *sd;
    Evas_Object *o, *l;
@@ -825,6 +949,8 @@ e_deskmirror_add(E_Desk *desk, Eina_Bool pager, Eina_Bool taskbar)
    sd = evas_object_smart_data_get(o);
    sd->pager = !!pager;
    sd->taskbar = !!taskbar;
+   sd->thumb = thumb_rate > 0.0;
+   sd->thumb_rate = thumb_rate;
    sd->desk = desk;
    sd->mirror_hash = eina_hash_pointer_new((Eina_Free_Cb)_e_deskmirror_mirror_del_hash);
    sd->desk_delfn = e_object_delfn_add(E_OBJECT(desk), (Ecore_End_Cb)_e_deskmirror_delfn, sd);
@@ -866,9 +992,29 @@ e_deskmirror_add(E_Desk *desk, Eina_Bool pager, Eina_Bool taskbar)
    E_LIST_HANDLER_APPEND(sd->handlers, E_EVENT_CLIENT_REMOVE, (Ecore_Event_Handler_Cb)_client_del, sd);
    E_LIST_HANDLER_APPEND(sd->handlers, E_EVENT_CLIENT_PROPERTY, (Ecore_Event_Handler_Cb)_client_property, sd);
    E_LIST_HANDLER_APPEND(sd->handlers, E_EVENT_CLIENT_DESK_SET, (Ecore_Event_Handler_Cb)_client_desk_set, sd);
+   if (sd->thumb)
+     E_LIST_HANDLER_APPEND(sd->handlers, E_EVENT_DESK_SHOW, (Ecore_Event_Handler_Cb)_desk_show, sd);
    return o;
 }
 
+/* externally accessible functions */
+E_API Evas_Object *
+e_deskmirror_add(E_Desk *desk, Eina_Bool pager, Eina_Bool taskbar)
+{
+   return _e_deskmirror_add(desk, pager, taskbar, 0.0);
+}
+
+/* like e_deskmirror_add(), but clients are shown as downscaled snapshots
+ * which are refreshed at most rate times per second instead of as live
+ * full-size mirrors; clients without cpu-side pixels still get live mirrors
+ */
+E_API Evas_Object *
+e_deskmirror_thumb_add(E_Desk *desk, Eina_Bool pager, Eina_Bool taskbar, double rate)
+{
+   EINA_SAFETY_ON_FALSE_RETURN_VAL(rate > 0.0, NULL);
+   return _e_deskmirror_add(desk, pager, taskbar, rate);
+}
+
 E_API Evas_Object *
 e_deskmirror_mirror_find(Evas_Object *deskmirror, Evas_Object *comp_object)
 {
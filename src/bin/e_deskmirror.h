@@ -2,6 +2,7 @@
 #define E_WIDGET_DESKMIRROR_H
 
 E_API Evas_Object *e_deskmirror_add(E_Desk *desk, Eina_Bool pager, Eina_Bool taskbar);
+E_API Evas_Object *e_deskmirror_thumb_add(E_Desk *desk, Eina_Bool pager, Eina_Bool taskbar, double rate);
 E_API Evas_Object *e_deskmirror_mirror_find(Evas_Object *deskmirror, Evas_Object *comp_object);
 E_API Eina_List *e_deskmirror_mirror_list(Evas_Object *deskmirror);
 E_API Evas_Object *e_deskmirror_mirror_copy(Evas_Object *obj);
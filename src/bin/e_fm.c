@@ -121,10 +121,19 @@ struct _E_Fm2_Smart_Data
    {
       Evas_Object *obj, *obj2;
       Eina_List   *last_insert;
-      Eina_List  **list_index;
       int          iter;
    } tmp;
 
+   /* file name -> list of E_Fm2_Icon in icons or queue, newest first */
+   Eina_Hash       *icons_hash;
+   /* the nodes of icons, in list order, for binary search on insert/del */
+   struct
+   {
+      Eina_List  **nodes;
+      unsigned int num, size;
+      Eina_Bool    dirty E_BITFIELD;
+   } icons_index;
+
    struct
    {
       Eina_List   *actions;
@@ -278,6 +287,15 @@ static void          _e_fm2_dir_save_props(E_Fm2_Smart_Data *sd);
 
 static Eina_List    *_e_fm2_file_fm2_find(const char *file);
 static E_Fm2_Icon   *_e_fm2_icon_find(Evas_Object *obj, const char *file);
+static E_Fm2_Icon   *_e_fm2_icons_hash_find(E_Fm2_Smart_Data *sd, const char *file);
+static void          _e_fm2_icons_hash_add(E_Fm2_Smart_Data *sd, E_Fm2_Icon *ic);
+static void          _e_fm2_icons_hash_del(E_Fm2_Smart_Data *sd, E_Fm2_Icon *ic);
+static void          _e_fm2_icons_index_rebuild(E_Fm2_Smart_Data *sd);
+static void          _e_fm2_icons_index_insert(E_Fm2_Smart_Data *sd, unsigned int pos, Eina_List *node);
+static Eina_List    *_e_fm2_icons_index_remove(E_Fm2_Smart_Data *sd, E_Fm2_Icon *ic);
+static unsigned int  _e_fm2_icons_index_search(E_Fm2_Smart_Data *sd, E_Fm2_Icon *ic);
+static Eina_List    *_e_fm2_icons_list_insert(E_Fm2_Smart_Data *sd, E_Fm2_Icon *ic, unsigned int pos);
+static void          _e_fm2_icon_resort(E_Fm2_Icon *ic);
 static const char   *_e_fm2_uri_escape(const char *path);
 static Eina_List    *_e_fm2_uri_selected_icon_list_get(Eina_List *uri);
 
@@ -1539,16 +1557,12 @@ e_fm2_all_list_get(Evas_Object *obj)
 E_API E_Fm2_Icon_Info *
 e_fm2_icon_file_get(Evas_Object *obj, const char *file)
 {
-   Eina_List *l;
    E_Fm2_Icon *ic;
 
    EFM_SMART_CHECK(NULL);
    if (!file) return NULL;
-   EINA_LIST_FOREACH(sd->icons, l, ic)
-     {
-        if ((ic->info.file) && (!strcmp(ic->info.file, file)))
-          return &(ic->info);
-     }
+   ic = _e_fm2_icon_find(obj, file);
+   if (ic) return &(ic->info);
    return NULL;
 }
 
@@ -1585,18 +1599,11 @@ e_fm2_select_set(Evas_Object *obj, const char *file, int select_)
 E_API void
 e_fm2_file_show(Evas_Object *obj, const char *file)
 {
-   Eina_List *l;
    E_Fm2_Icon *ic;
 
    EFM_SMART_CHECK();
-   EINA_LIST_FOREACH(sd->icons, l, ic)
-     {
-        if (!strcmp(ic->info.file, file))
-          {
-             _e_fm2_icon_make_visible(ic);
-             return;
-          }
-     }
+   ic = _e_fm2_icon_find(obj, file);
+   if (ic) _e_fm2_icon_make_visible(ic);
 }
 
 E_API void
@@ -2739,7 +2746,6 @@ _e_fm2_client_monitor_list_end(Evas_Object *obj)
         ecore_idler_del(sd->sort_idler);
         sd->sort_idler = NULL;
      }
-   E_FREE(sd->tmp.list_index);
    _e_fm2_queue_free(obj);
    _e_fm2_obj_icons_place(sd);
    _e_fm2_live_process_begin(obj);
@@ -2785,6 +2791,125 @@ _e_fm2_file_force_update(const char *path)
    free(dir);
 }
 
+static void
+_e_fm2_client_list_file_add(Evas_Object *obj, E_Fm2_Smart_Data *sd, const char *path, E_Fm2_Finfo *finf)
+{
+   const char *file;
+
+   if (!sd->scan_timer)
+     {
+        sd->scan_timer =
+          ecore_timer_loop_add(0.5,
+                               _e_fm2_cb_scan_timer,
+                               sd->obj);
+        sd->busy_count++;
+        if (sd->busy_count == 1)
+          edje_object_signal_emit(sd->overlay, "e,state,busy,start", "e");
+     }
+   else
+     {
+        if ((eina_list_count(sd->icons) > 50) && (ecore_timer_interval_get(sd->scan_timer) < 1.5))
+          {
+             /* increase timer interval when loading large directories to
+              * dramatically improve load times
+              */
+             ecore_timer_interval_set(sd->scan_timer, 1.5);
+             ecore_timer_loop_reset(sd->scan_timer);
+          }
+     }
+   if (path[0] == 0) return;
+   file = ecore_file_file_get(path);
+   if ((!strcmp(file, ".order")))
+     sd->order_file = EINA_TRUE;
+   else if (!((file[0] == '.') && (!sd->show_hidden_files)))
+     _e_fm2_file_add(obj, file, sd->order_file, NULL, 0, finf);
+}
+
+static void
+_e_fm2_client_list_overlay_update(E_Fm2_Smart_Data *sd)
+{
+   unsigned int n;
+   char buf[1024];
+
+   n = eina_list_count(sd->queue) + eina_list_count(sd->icons);
+   if (n - sd->overlay_count <= 150) return;
+   sd->overlay_count = n + 1;
+   snprintf(buf, sizeof(buf), P_("%u file", "%u files", sd->overlay_count), sd->overlay_count);
+   edje_object_part_text_set(sd->overlay, "e.text.busy_label", buf);
+}
+
+static void
+_e_fm2_client_list_scan_end(Evas_Object *obj, E_Fm2_Smart_Data *sd)
+{
+   sd->listing = EINA_FALSE;
+   if (sd->scan_timer)
+     {
+        ecore_timer_interval_set(sd->scan_timer, 0.0001);
+        ecore_timer_loop_reset(sd->scan_timer);
+     }
+   else
+     {
+        _e_fm2_client_monitor_list_end(obj);
+     }
+}
+
+/* a listing batch is a run of records, each being:
+ *
+ * record_size[unsigned int] + stat_info[stat size] + broken_link[1] +
+ * path[n]\0 + lnk[n]\0 + rlnk[n]\0
+ *
+ * all records of a batch come from the same directory listing.
+ */
+static void
+_e_fm2_client_list_batch_add(Evas_Object *obj, E_Fm2_Smart_Data *sd, const char *dir, const unsigned char *data, int size)
+{
+   const unsigned char *p = data, *end = data + size;
+   Eina_Bool checked = EINA_FALSE;
+
+   while (p + sizeof(unsigned int) + sizeof(struct stat) + 4 <= end)
+     {
+        E_Fm2_Finfo finf;
+        const char *path;
+        unsigned int len;
+        const unsigned char *rec;
+
+        memcpy(&len, p, sizeof(unsigned int));
+        p += sizeof(unsigned int);
+        if ((len < sizeof(struct stat) + 4) || (len > (size_t)(end - p))) break;
+        rec = p;
+        p += len;
+        /* strings must be terminated inside the record */
+        if (rec[len - 1] != 0) break;
+
+        memcpy(&(finf.st), rec, sizeof(struct stat));
+        rec += sizeof(struct stat);
+        finf.broken_link = rec[0];
+        rec += 1;
+        path = (const char *)rec;
+        rec += strlen(path) + 1;
+        if (rec >= p) break;
+        finf.lnk = (const char *)rec;
+        rec += strlen(finf.lnk) + 1;
+        if (rec >= p) break;
+        finf.rlnk = (const char *)rec;
+
+        if (!checked)
+          {
+             char *evdir = ecore_file_dir_get(path);
+             Eina_Bool ok;
+
+             ok = evdir && ((!evdir[0]) || (dir && (!strcmp(dir, evdir))));
+             free(evdir);
+             if (!ok) return;
+             checked = EINA_TRUE;
+          }
+        _e_fm2_client_list_file_add(obj, sd, path, &finf);
+     }
+   if (!checked) return;
+   _e_fm2_client_list_overlay_update(sd);
+   _e_fm2_client_list_scan_end(obj, sd);
+}
+
 E_API void
 e_fm2_client_data(Ecore_Ipc_Event_Client_Data *e)
 {
@@ -2801,6 +2926,8 @@ e_fm2_client_data(Ecore_Ipc_Event_Client_Data *e)
      {
         cl = E_NEW(E_Fm2_Client, 1);
         cl->cl = e->client;
+        /* listing batches are far bigger than ecore_ipc's default limit */
+        ecore_ipc_client_data_size_max_set(cl->cl, E_FM_OP_IPC_DATA_MAX);
         _e_fm2_client_list = eina_list_prepend(_e_fm2_client_list, cl);
         /* FIXME: new client - send queued msgs */
         _e_fm2_client_spawning = 0;
@@ -2812,7 +2939,7 @@ e_fm2_client_data(Ecore_Ipc_Event_Client_Data *e)
      {
         unsigned char *p;
         char *evdir;
-        const char *dir, *path, *lnk, *rlnk, *file;
+        const char *dir, *path, *lnk, *rlnk;
         struct stat st;
         int broken_link;
         E_Fm2_Smart_Data *sd;
@@ -2889,67 +3016,10 @@ e_fm2_client_data(Ecore_Ipc_Event_Client_Data *e)
                    /*file add - listing*/
                    if (e->minor == E_FM_OP_FILE_ADD)    /*file add*/
                      {
-                        if (!sd->scan_timer)
-                          {
-                             sd->scan_timer =
-                               ecore_timer_loop_add(0.5,
-                                               _e_fm2_cb_scan_timer,
-                                               sd->obj);
-                             sd->busy_count++;
-                             if (sd->busy_count == 1)
-                               edje_object_signal_emit(sd->overlay, "e,state,busy,start", "e");
-                          }
-                        else
-                          {
-                             if ((eina_list_count(sd->icons) > 50) && (ecore_timer_interval_get(sd->scan_timer) < 1.5))
-                               {
-                                  /* increase timer interval when loading large directories to
-                                   * dramatically improve load times
-                                   */
-                                  ecore_timer_interval_set(sd->scan_timer, 1.5);
-                                  ecore_timer_loop_reset(sd->scan_timer);
-                               }
-                          }
-                        if (path[0] != 0)
-                          {
-                             file = ecore_file_file_get(path);
-                             if ((!strcmp(file, ".order")))
-                               sd->order_file = EINA_TRUE;
-                             else
-                               {
-                                  unsigned int n;
-
-                                  n = eina_list_count(sd->queue) + eina_list_count(sd->icons);
-                                  if (!((file[0] == '.') &&
-                                        (!sd->show_hidden_files)))
-                                    {
-                                       char buf[1024];
-
-                                       _e_fm2_file_add(obj, file,
-                                                       sd->order_file,
-                                                       NULL, 0, &finf);
-                                       if (n - sd->overlay_count > 150)
-                                         {
-                                            sd->overlay_count = n + 1;
-                                            snprintf(buf, sizeof(buf), P_("%u file", "%u files", sd->overlay_count), sd->overlay_count);
-                                            edje_object_part_text_set(sd->overlay, "e.text.busy_label", buf);
-                                         }
-                                    }
-                               }
-                          }
+                        _e_fm2_client_list_file_add(obj, sd, path, &finf);
+                        _e_fm2_client_list_overlay_update(sd);
                         if (e->response == 2)    /* end of scan */
-                          {
-                             sd->listing = EINA_FALSE;
-                             if (sd->scan_timer)
-                               {
-                                  ecore_timer_interval_set(sd->scan_timer, 0.0001);
-                                  ecore_timer_loop_reset(sd->scan_timer);
-                               }
-                             else
-                               {
-                                  _e_fm2_client_monitor_list_end(obj);
-                               }
-                          }
+                          _e_fm2_client_list_scan_end(obj, sd);
                      }
                    break;
                 }
@@ -2976,6 +3046,11 @@ e_fm2_client_data(Ecore_Ipc_Event_Client_Data *e)
            }
            break;
 
+           case E_FM_OP_FILE_ADD_BATCH: /*file add - listing, many at once*/
+             if (sd->id == e->ref_to)
+               _e_fm2_client_list_batch_add(obj, sd, dir, e->data, e->size);
+             break;
+
            case E_FM_OP_FILE_DEL: /*file del*/
 //             printf("E_FM_OP_FILE_DEL\n");
              path = e->data;
@@ -3459,29 +3534,16 @@ _e_fm2_file_add(Evas_Object *obj, const char *file, int unique, Eina_Stringshare
    sd = evas_object_smart_data_get(obj);
    if (!sd) return;
    /* if we only want unique icon names - if it's there - ignore */
-   if (unique)
+   if ((unique) && (_e_fm2_icons_hash_find(sd, file)))
      {
-        EINA_LIST_FOREACH(sd->icons, l, ic)
-          {
-             if (!strcmp(ic->info.file, file))
-               {
-                  sd->tmp.last_insert = NULL;
-                  return;
-               }
-          }
-        EINA_LIST_FOREACH(sd->queue, l, ic)
-          {
-             if (!strcmp(ic->info.file, file))
-               {
-                  sd->tmp.last_insert = NULL;
-                  return;
-               }
-          }
+        sd->tmp.last_insert = NULL;
+        return;
      }
    /* create icon obj and append to unsorted list */
    ic = _e_fm2_icon_new(sd, file, finf);
    if (ic)
      {
+        _e_fm2_icons_hash_add(sd, ic);
         if (!file_rel)
           {
              if (ic->queued) abort();
@@ -3512,11 +3574,13 @@ _e_fm2_file_add(Evas_Object *obj, const char *file, int unique, Eina_Stringshare
                        break;
                     }
                }
-             if (ic->inserted)
+             if (!ic->inserted)
                {
                   sd->icons = eina_list_append(sd->icons, ic);
                   ic->inserted = EINA_TRUE;
                }
+             /* explicit positioning breaks sort order - reindex lazily */
+             sd->icons_index.dirty = EINA_TRUE;
              sd->icons_place = eina_list_append(sd->icons_place, ic);
           }
         sd->tmp.last_insert = NULL;
@@ -3533,33 +3597,30 @@ _e_fm2_file_del(Evas_Object *obj, const char *file)
 
    sd = evas_object_smart_data_get(obj);
    if (!sd) return;
-   EINA_LIST_FOREACH(sd->icons, l, ic)
+   ic = _e_fm2_icons_hash_find(sd, file);
+   if (!ic) return;
+   if (ic->inserted)
      {
-        if (!strcmp(ic->info.file, file))
+        l = _e_fm2_icons_index_remove(sd, ic);
+        if (!l) l = eina_list_data_find_list(sd->icons, ic);
+        if (!l) abort();
+        sd->icons = eina_list_remove_list(sd->icons, l);
+        ic->inserted = EINA_FALSE;
+        sd->icons_place = eina_list_remove(sd->icons_place, ic);
+        if (ic->region)
           {
-             if (!ic->inserted) abort();
-             sd->icons = eina_list_remove_list(sd->icons, l);
-             ic->inserted = EINA_FALSE;
-             sd->icons_place = eina_list_remove(sd->icons_place, ic);
-             if (ic->region)
-               {
-                  ic->region->list = eina_list_remove(ic->region->list, ic);
-                  ic->region = NULL;
-               }
-             _e_fm2_icon_free(ic);
-             return;
+             ic->region->list = eina_list_remove(ic->region->list, ic);
+             ic->region = NULL;
           }
+        sd->tmp.last_insert = NULL;
+        _e_fm2_icon_free(ic);
      }
-   EINA_LIST_FOREACH(sd->queue, l, ic)
+   else if (ic->queued)
      {
-        if (!strcmp(ic->info.file, file))
-          {
-             INF("MATCH!");
-             sd->queue = eina_list_remove_list(sd->queue, l);
-             ic->queued = EINA_FALSE;
-             _e_fm2_icon_free(ic);
-             return;
-          }
+        INF("MATCH!");
+        sd->queue = eina_list_remove(sd->queue, ic);
+        ic->queued = EINA_FALSE;
+        _e_fm2_icon_free(ic);
      }
 }
 
@@ -3802,13 +3863,184 @@ _e_fm2_file_symlink_menu(void *data, E_Menu *m EINA_UNUSED, E_Menu_Item *mi EINA
    _e_fm2_file_symlink(sd->obj);
 }
 
+static void
+_e_fm2_icons_index_rebuild(E_Fm2_Smart_Data *sd)
+{
+   Eina_List *l;
+   unsigned int n;
+
+   if ((!sd->icons_index.dirty) && (sd->icons_index.num == eina_list_count(sd->icons)))
+     return;
+   n = eina_list_count(sd->icons);
+   if (n > sd->icons_index.size)
+     {
+        Eina_List **nodes;
+
+        nodes = realloc(sd->icons_index.nodes, n * sizeof(Eina_List *));
+        if (!nodes) return;
+        sd->icons_index.nodes = nodes;
+        sd->icons_index.size = n;
+     }
+   sd->icons_index.num = 0;
+   for (l = sd->icons; l; l = eina_list_next(l))
+     sd->icons_index.nodes[sd->icons_index.num++] = l;
+   sd->icons_index.dirty = EINA_FALSE;
+}
+
+static void
+_e_fm2_icons_index_insert(E_Fm2_Smart_Data *sd, unsigned int pos, Eina_List *node)
+{
+   if (sd->icons_index.dirty) return;
+   if (sd->icons_index.num == sd->icons_index.size)
+     {
+        Eina_List **nodes;
+        unsigned int size;
+
+        size = sd->icons_index.size ? sd->icons_index.size * 2 : 256;
+        nodes = realloc(sd->icons_index.nodes, size * sizeof(Eina_List *));
+        if (!nodes)
+          {
+             sd->icons_index.dirty = EINA_TRUE;
+             return;
+          }
+        sd->icons_index.nodes = nodes;
+        sd->icons_index.size = size;
+     }
+   if (pos < sd->icons_index.num)
+     memmove(sd->icons_index.nodes + pos + 1, sd->icons_index.nodes + pos,
+             (sd->icons_index.num - pos) * sizeof(Eina_List *));
+   sd->icons_index.nodes[pos] = node;
+   sd->icons_index.num++;
+}
+
+/* first index whose icon sorts after ic - ie. where ic is to be inserted */
+static unsigned int
+_e_fm2_icons_index_search(E_Fm2_Smart_Data *sd, E_Fm2_Icon *ic)
+{
+   unsigned int p0 = 0, p1 = sd->icons_index.num, i;
+
+   while (p0 < p1)
+     {
+        i = (p0 + p1) / 2;
+        if (_e_fm2_cb_icon_sort(ic, eina_list_data_get(sd->icons_index.nodes[i])) < 0)
+          p1 = i;
+        else
+          p0 = i + 1;
+     }
+   return p0;
+}
+
+/* drop ic from the index and return its list node - NULL if not indexed */
+static Eina_List *
+_e_fm2_icons_index_remove(E_Fm2_Smart_Data *sd, E_Fm2_Icon *ic)
+{
+   Eina_List *node = NULL;
+   unsigned int i, pos = 0;
+
+   if (sd->icons_index.dirty) return NULL;
+   if (!sd->order_file)
+     {
+        /* equal keys sort together so walk back over them from the search */
+        i = _e_fm2_icons_index_search(sd, ic);
+        while (i > 0)
+          {
+             i--;
+             if (eina_list_data_get(sd->icons_index.nodes[i]) == ic)
+               {
+                  node = sd->icons_index.nodes[i];
+                  pos = i;
+                  break;
+               }
+             if (_e_fm2_cb_icon_sort(ic, eina_list_data_get(sd->icons_index.nodes[i])))
+               break;
+          }
+     }
+   if (!node)
+     {
+        for (i = 0; i < sd->icons_index.num; i++)
+          {
+             if (eina_list_data_get(sd->icons_index.nodes[i]) != ic) continue;
+             node = sd->icons_index.nodes[i];
+             pos = i;
+             break;
+          }
+        if (!node) return NULL;
+     }
+   sd->icons_index.num--;
+   if (pos < sd->icons_index.num)
+     memmove(sd->icons_index.nodes + pos, sd->icons_index.nodes + pos + 1,
+             (sd->icons_index.num - pos) * sizeof(Eina_List *));
+   return node;
+}
+
+/* insert ic into icons before the node at index pos, and index it */
+static Eina_List *
+_e_fm2_icons_list_insert(E_Fm2_Smart_Data *sd, E_Fm2_Icon *ic, unsigned int pos)
+{
+   Eina_List *l;
+
+   if ((sd->icons_index.dirty) || (pos >= sd->icons_index.num))
+     {
+        sd->icons = eina_list_append(sd->icons, ic);
+        l = eina_list_last(sd->icons);
+     }
+   else if (sd->icons_index.nodes[pos] == sd->icons)
+     {
+        sd->icons = eina_list_prepend(sd->icons, ic);
+        l = sd->icons;
+     }
+   else
+     {
+        sd->icons = eina_list_prepend_relative_list(sd->icons, ic,
+                                                    sd->icons_index.nodes[pos]);
+        l = eina_list_prev(sd->icons_index.nodes[pos]);
+     }
+   _e_fm2_icons_index_insert(sd, pos, l);
+   return l;
+}
+
+/* a refill may have changed what ic sorts by (label, mime, size, mtime).
+ * move it to where it sorts now so the index stays good for bisection */
+static void
+_e_fm2_icon_resort(E_Fm2_Icon *ic)
+{
+   E_Fm2_Smart_Data *sd = ic->sd;
+   Eina_List *node, *next;
+   unsigned int pos;
+
+   if ((sd->order_file) || (sd->icons_index.dirty)) return;
+   node = _e_fm2_icons_index_remove(sd, ic);
+   if (!node)
+     {
+        sd->icons_index.dirty = EINA_TRUE;
+        return;
+     }
+   next = eina_list_next(node);
+   pos = _e_fm2_icons_index_search(sd, ic);
+   /* still sorts between the same neighbours */
+   if ((pos < sd->icons_index.num) ?
+       (sd->icons_index.nodes[pos] == next) : (!next))
+     {
+        _e_fm2_icons_index_insert(sd, pos, node);
+        return;
+     }
+   if (sd->tmp.last_insert == node) sd->tmp.last_insert = NULL;
+   sd->icons = eina_list_remove_list(sd->icons, node);
+   _e_fm2_icons_list_insert(sd, ic, pos);
+   if (!eina_list_data_find(sd->icons_place, ic))
+     sd->icons_place = eina_list_append(sd->icons_place, ic);
+   if (sd->resize_job) ecore_job_del(sd->resize_job);
+   sd->resize_job = ecore_job_add(_e_fm2_cb_resize_job, sd->obj);
+}
+
 static void
 _e_fm2_queue_process(Evas_Object *obj)
 {
    E_Fm2_Smart_Data *sd;
-   E_Fm2_Icon *ic, *ic2;
-   Eina_List *l, **ll;
-   int added = 0, i, p0, p1, n, v;
+   E_Fm2_Icon *ic;
+   Eina_List *l;
+   unsigned int pos;
+   int added = 0;
    double t;
    char buf[4096];
 
@@ -3826,89 +4058,26 @@ _e_fm2_queue_process(Evas_Object *obj)
 //   int queued = eina_list_count(sd->queue);
 /* take unsorted and insert into the icon list - reprocess regions */
    t = ecore_time_get();
-   if (!sd->tmp.last_insert)
-     {
-#if 1
-        n = eina_list_count(sd->icons);
-        E_FREE(sd->tmp.list_index);
-        if (n > 0)
-          sd->tmp.list_index = calloc(n, sizeof(Eina_List *));
-        if (sd->tmp.list_index)
-          {
-             ll = sd->tmp.list_index;
-             for (l = sd->icons; l; l = eina_list_next(l))
-               {
-                  *ll = l;
-                  ll++;
-               }
-             /* binary search first queue */
-             ic = eina_list_data_get(sd->queue);
-             p0 = 0; p1 = n;
-             i = (p0 + p1) / 2;
-             ll = sd->tmp.list_index;
-             if (ll[i])
-               do /* avoid garbage deref */
-                 {
-                    ic2 = eina_list_data_get(ll[i]);
-                    v = _e_fm2_cb_icon_sort(ic, ic2);
-                    if (v < 0) /* ic should go before ic2 */
-                      p1 = i;
-                    else /* ic should go at or after ic2 */
-                      p0 = i;
-                    i = (p0 + p1) / 2;
-                    l = ll[i];
-                 }
-               while ((p1 - p0) > 1);
-          }
-        else
-#endif
-        l = sd->icons;
-     }
-   else
-     l = sd->tmp.last_insert;
+   /* the index is kept up to date incrementally, so this is only a full
+    * walk after something reordered the icon list behind our back */
+   _e_fm2_icons_index_rebuild(sd);
    while (sd->queue)
      {
         ic = sd->queue->data;
         sd->queue = eina_list_remove_list(sd->queue, sd->queue);
-        /* insertion sort - better than qsort for the way we are doing
-         * things - incrimentally scan and sort as we go as we now know
-         * that the queue files are in order, we speed up insertions to
-         * a worst case of O(n) where n is the # of files in the list
-         * so far
-         */
-        if (sd->order_file)
-          {
-             l = NULL;
-          }
+        if (!ic->queued) abort();
+        if (ic->inserted) abort();
+        ic->queued = EINA_FALSE;
+        ic->inserted = EINA_TRUE;
+        /* binary search the insert position in the sorted node index, then
+         * insert relative to the node found - O(log n) per file instead of
+         * rescanning the list */
+        if ((sd->order_file) || (sd->icons_index.dirty))
+          pos = sd->icons_index.num;
         else
-          {
-             EINA_LIST_FOREACH(l, l, ic2)
-               {
-                  if (_e_fm2_cb_icon_sort(ic, ic2) < 0)
-                    {
-                       if (!ic->queued) abort();
-                       if (ic->inserted) abort();
-                       ic->queued = EINA_FALSE;
-                       ic->inserted = EINA_TRUE;
-                       if (l == sd->icons)
-                         sd->icons = eina_list_prepend(sd->icons, ic);
-                       else
-                         sd->icons = eina_list_prepend_relative_list(sd->icons,
-                                                                     ic, l);
-                       sd->tmp.last_insert = l;
-                       break;
-                    }
-               }
-          }
-        if (!l)
-          {
-             if (!ic->queued) abort();
-             if (ic->inserted) abort();
-             ic->queued = EINA_FALSE;
-             ic->inserted = EINA_TRUE;
-             sd->icons = eina_list_append(sd->icons, ic);
-             sd->tmp.last_insert = eina_list_last(sd->icons);
-          }
+          pos = _e_fm2_icons_index_search(sd, ic);
+        l = _e_fm2_icons_list_insert(sd, ic, pos);
+        sd->tmp.last_insert = l;
         sd->icons_place = eina_list_append(sd->icons_place, ic);
         added++;
         /* if we spent more than 1/20th of a second inserting - give up
@@ -4408,7 +4577,9 @@ _e_fm2_icons_free(Evas_Object *obj)
    eina_list_free(sd->icons_place);
    sd->icons_place = NULL;
    sd->tmp.last_insert = NULL;
-   E_FREE(sd->tmp.list_index);
+   E_FREE(sd->icons_index.nodes);
+   sd->icons_index.num = sd->icons_index.size = 0;
+   sd->icons_index.dirty = EINA_FALSE;
 }
 
 static void
@@ -4463,16 +4634,54 @@ static E_Fm2_Icon *
 _e_fm2_icon_find(Evas_Object *obj, const char *file)
 {
    E_Fm2_Smart_Data *sd;
-   Eina_List *l;
    E_Fm2_Icon *ic;
 
    sd = evas_object_smart_data_get(obj);
    if (!sd) return NULL;
-   EINA_LIST_FOREACH(sd->icons, l, ic)
+   ic = _e_fm2_icons_hash_find(sd, file);
+   if ((ic) && (ic->inserted)) return ic;
+   return NULL;
+}
+
+/* names are normally unique, but a non-unique add can repeat one. every
+ * icon of a name is kept so freeing one leaves the others findable */
+static E_Fm2_Icon *
+_e_fm2_icons_hash_find(E_Fm2_Smart_Data *sd, const char *file)
+{
+   if ((!sd->icons_hash) || (!file)) return NULL;
+   return eina_list_data_get(eina_hash_find(sd->icons_hash, file));
+}
+
+static void
+_e_fm2_icons_hash_add(E_Fm2_Smart_Data *sd, E_Fm2_Icon *ic)
+{
+   Eina_List *l;
+
+   if (!sd->icons_hash)
+     sd->icons_hash =
+       eina_hash_string_superfast_new(EINA_FREE_CB(eina_list_free));
+   l = eina_hash_find(sd->icons_hash, ic->info.file);
+   if (l)
+     eina_hash_modify(sd->icons_hash, ic->info.file, eina_list_prepend(l, ic));
+   else
+     eina_hash_add(sd->icons_hash, ic->info.file, eina_list_append(NULL, ic));
+}
+
+static void
+_e_fm2_icons_hash_del(E_Fm2_Smart_Data *sd, E_Fm2_Icon *ic)
+{
+   Eina_List *l, *l2;
+
+   if (!sd->icons_hash) return;
+   l = eina_hash_find(sd->icons_hash, ic->info.file);
+   if (!l) return;
+   if ((!eina_list_next(l)) && (eina_list_data_get(l) == ic))
      {
-        if (!strcmp(ic->info.file, file)) return ic;
+        eina_hash_del_by_key(sd->icons_hash, ic->info.file);
+        return;
      }
-   return NULL;
+   l2 = eina_list_remove(l, ic);
+   if (l2 != l) eina_hash_modify(sd->icons_hash, ic->info.file, l2);
 }
 
 /* Escape illegal caracters within an uri and return an eina_stringshare */
@@ -4833,6 +5042,7 @@ _e_fm2_icon_fill(E_Fm2_Icon *ic, E_Fm2_Finfo *finf)
      }
    edje_thaw();
    evas_event_thaw(evas_object_evas_get(ic->sd->obj));
+   if (ic->inserted) _e_fm2_icon_resort(ic);
    return 1;
 }
 
@@ -4887,6 +5097,7 @@ _e_fm2_icon_free(E_Fm2_Icon *ic)
      ic->sd->selected_icons = eina_list_remove(ic->sd->selected_icons, ic);
    if (ic->drag.dnd_end_timer)
      ecore_timer_del(ic->drag.dnd_end_timer);
+   _e_fm2_icons_hash_del(ic->sd, ic);
    eina_stringshare_del(ic->info.file);
    eina_stringshare_del(ic->info.mime);
    eina_stringshare_del(ic->info.label);
@@ -8647,6 +8858,7 @@ _e_fm2_smart_del(Evas_Object *obj)
    _e_fm2_queue_free(obj);
    _e_fm2_regions_free(obj);
    _e_fm2_icons_free(obj);
+   E_FREE_FUNC(sd->icons_hash, eina_hash_free);
    if (sd->selected_icons) eina_list_free(sd->selected_icons);
    if (sd->menu)
      {
@@ -10411,6 +10623,7 @@ _e_fm2_sort(void *data, E_Menu *m, E_Menu_Item *mi)
    sd = data;
    sd->icons = eina_list_sort(sd->icons, eina_list_count(sd->icons),
                               _e_fm2_cb_icon_sort);
+   sd->icons_index.dirty = EINA_TRUE;
    _e_fm2_refresh(data, m, mi);
 }
 
@@ -11302,7 +11515,6 @@ _e_fm2_live_process(Evas_Object *obj)
 {
    E_Fm2_Smart_Data *sd;
    E_Fm2_Action *a;
-   Eina_List *l;
    E_Fm2_Icon *ic;
 
    sd = evas_object_smart_data_get(obj);
@@ -11346,36 +11558,30 @@ _e_fm2_live_process(Evas_Object *obj)
           }
         else
           {
-             if (!((a->file[0] == '.') && (!sd->show_hidden_files)))
+             if ((!((a->file[0] == '.') && (!sd->show_hidden_files))) &&
+                 (ic = _e_fm2_icon_find(obj, a->file)))
                {
-                  EINA_LIST_FOREACH(sd->icons, l, ic)
+                  if (ic->removable_state_change)
                     {
-                       if (!strcmp(ic->info.file, a->file))
+                       _e_fm2_icon_unfill(ic);
+                       _e_fm2_icon_fill(ic, &(a->finf));
+                       ic->removable_state_change = EINA_FALSE;
+                       if ((ic->realized) && (ic->obj_icon))
                          {
-                            if (ic->removable_state_change)
-                              {
-                                 _e_fm2_icon_unfill(ic);
-                                 _e_fm2_icon_fill(ic, &(a->finf));
-                                 ic->removable_state_change = EINA_FALSE;
-                                 if ((ic->realized) && (ic->obj_icon))
-                                   {
-                                      _e_fm2_icon_removable_update(ic);
-                                      _e_fm2_icon_label_set(ic, ic->obj);
-                                   }
-                              }
-                            else if (!eina_str_has_extension(ic->info.file, ".part"))
-                              {
-                                 int realized;
-
-                                 realized = ic->realized;
-                                 if (realized) _e_fm2_icon_unrealize(ic);
-                                 _e_fm2_icon_unfill(ic);
-                                 _e_fm2_icon_fill(ic, &(a->finf));
-                                 if (realized) _e_fm2_icon_realize(ic);
-                              }
-                            break;
+                            _e_fm2_icon_removable_update(ic);
+                            _e_fm2_icon_label_set(ic, ic->obj);
                          }
                     }
+                  else if (!eina_str_has_extension(ic->info.file, ".part"))
+                    {
+                       int realized;
+
+                       realized = ic->realized;
+                       if (realized) _e_fm2_icon_unrealize(ic);
+                       _e_fm2_icon_unfill(ic);
+                       _e_fm2_icon_fill(ic, &(a->finf));
+                       if (realized) _e_fm2_icon_realize(ic);
+                    }
                }
           }
         break;
@@ -42,6 +42,13 @@
 #include "e_fm_main.h"
 #include "e_fm_shared_codec.h"
 #define DEF_MOD_BACKOFF          0.2
+/* listing entries packed into one E_FM_OP_FILE_ADD_BATCH message */
+#define DEF_LIST_BATCH           512
+/* ecore_ipc drops messages bigger than the receiver's limit, which e sets
+ * to E_FM_OP_IPC_DATA_MAX. one record is at most a struct stat and 3 paths
+ * (~12.5k), so flushing once a batch passes this keeps it under the limit.
+ * only batches of very long names ever get here before DEF_LIST_BATCH */
+#define DEF_LIST_BATCH_SIZE      (E_FM_OP_IPC_DATA_MAX - (16 * 1024))
 
 typedef struct _E_Dir          E_Dir;
 typedef struct _E_Fop          E_Fop;
@@ -143,6 +150,7 @@ static int         _e_fm_ipc_slave_send(E_Fm_Slave *slave, E_Fm_Op_Type type, vo
 static void        _e_fm_ipc_cb_file_monitor(void *data, Ecore_File_Monitor *em, Ecore_File_Event event, const char *path);
 static Eina_Bool   _e_fm_ipc_cb_recent_clean(void *data);
 
+static Eina_Bool   _e_fm_ipc_file_info_append(Eina_Binbuf *buf, const char *path, Eina_Bool sized);
 static void        _e_fm_ipc_file_add_mod(E_Dir *ed, const char *path, E_Fm_Op_Type op, int listing);
 static void        _e_fm_ipc_file_add(E_Dir *ed, const char *path, int listing);
 static void        _e_fm_ipc_file_del(E_Dir *ed, const char *path);
@@ -231,59 +239,59 @@ static void
 _e_fm_ipc_cb_list_result(void *data, Ecore_Thread *thread EINA_UNUSED, void *msg_data)
 {
    E_Dir *ed = data;
-   Eina_List *files = msg_data;
-   const char *s;
+   Eina_Binbuf *buf = msg_data;
 
-   if (!files) _e_fm_ipc_file_add(ed, "", 2);
+   if (!buf) _e_fm_ipc_file_add(ed, "", 2);
    else
      {
-        EINA_LIST_FREE(files, s)
-          {
-             _e_fm_ipc_file_add(ed, s, 2);
-             eina_stringshare_del(s);
-          }
+        ecore_ipc_server_send(_e_fm_ipc_server, 6 /*E_IPC_DOMAIN_FM*/,
+                              E_FM_OP_FILE_ADD_BATCH, 0, ed->id, 2,
+                              eina_binbuf_string_get(buf),
+                              eina_binbuf_length_get(buf));
+        eina_binbuf_free(buf);
      }
 }
 
+/* stat/readlink every entry here in the thread and hand back ready to send
+ * batches, so a big directory costs a few messages instead of one per file
+ */
 static void
 _e_fm_ipc_cb_list(void *data, Ecore_Thread *thread)
 {
    E_Dir *ed = data;
-   Eina_List *files = NULL;
+   Eina_Binbuf *files = NULL;
    int i, total = 0;
    Eina_File_Direct_Info *info;
    Eina_Iterator *it = ed->lister_iterator;
    char buf[4096];
-   const char *s;
 
+   files = eina_binbuf_new();
+   i = 0;
    if (!strcmp(ed->dir, "/")) snprintf(buf, sizeof(buf), "/.order");
    else snprintf(buf, sizeof(buf), "%s/.order", ed->dir);
-   if (ecore_file_exists(buf))
-     {
-        s = eina_stringshare_add(buf);
-        files = eina_list_append(files, s);
-     }
-   i = 0;
+   if (ecore_file_exists(buf) && _e_fm_ipc_file_info_append(files, buf, EINA_TRUE))
+     i++;
    EINA_ITERATOR_FOREACH(it, info)
      {
         if (!strcmp(info->path + info->name_start, ".order")) continue;
         if (ecore_thread_check(thread))
           {
-             EINA_LIST_FREE(files, s) eina_stringshare_del(s);
-             break;
+             eina_binbuf_free(files);
+             return;
           }
-        s = eina_stringshare_add(info->path);
-        files = eina_list_append(files, s);
+        if (!_e_fm_ipc_file_info_append(files, info->path, EINA_TRUE)) continue;
         total++;
         i++;
-        if (i >= 16)
+        if ((i >= DEF_LIST_BATCH) ||
+            (eina_binbuf_length_get(files) >= DEF_LIST_BATCH_SIZE))
           {
              i = 0;
              ecore_thread_feedback(thread, files);
-             files = NULL;
+             files = eina_binbuf_new();
           }
      }
-   if (files) ecore_thread_feedback(thread, files);
+   if (i > 0) ecore_thread_feedback(thread, files);
+   else eina_binbuf_free(files);
    if (total == 0) ecore_thread_feedback(thread, NULL);
 }
 
@@ -1012,9 +1020,6 @@ _e_fm_ipc_cb_recent_clean(void *data)
 static void
 _e_fm_ipc_file_add_mod(E_Dir *ed, const char *path, E_Fm_Op_Type op, int listing)
 {
-   struct stat st;
-   char *lnk = NULL, *rlnk = NULL;
-   int broken_lnk = 0;
    Eina_Binbuf *buf;
    /* file add/change format is as follows:
     *
@@ -1058,12 +1063,30 @@ _e_fm_ipc_file_add_mod(E_Dir *ed, const char *path, E_Fm_Op_Type op, int listing
           }
      }
 //   printf("MOD %s %3.3f\n", path, ecore_time_unix_get());
+   buf = eina_binbuf_new();
+   if (_e_fm_ipc_file_info_append(buf, path, EINA_FALSE))
+     ecore_ipc_server_send(_e_fm_ipc_server, 6 /*E_IPC_DOMAIN_FM*/, op, 0, ed->id,
+                           listing, eina_binbuf_string_get(buf), eina_binbuf_length_get(buf));
+   eina_binbuf_free(buf);
+}
+
+/* append the file add/change record for path to buf; for listing batches
+ * (sized) the record is prefixed with its length. returns EINA_FALSE if
+ * the file is gone. this is called from the lister thread too.
+ */
+static Eina_Bool
+_e_fm_ipc_file_info_append(Eina_Binbuf *buf, const char *path, Eina_Bool sized)
+{
+   struct stat st;
+   char *lnk = NULL, *rlnk = NULL;
+   int broken_lnk = 0;
+
    lnk = ecore_file_readlink(path);
    memset(&st, 0, sizeof(struct stat));
    if (stat((lnk && lnk[0]) ? lnk : path, &st) == -1)
      {
         if ((path[0] == 0) || (lnk)) broken_lnk = 1;
-        else return;
+        else return EINA_FALSE;
      }
    if ((lnk) && (lnk[0] != '/'))
      {
@@ -1079,23 +1102,26 @@ _e_fm_ipc_file_add_mod(E_Dir *ed, const char *path, E_Fm_Op_Type op, int listing
    if (!lnk) lnk = strdup("");
    if (!rlnk) rlnk = strdup("");
 
-   buf = eina_binbuf_new();
    /* NOTE: i am NOT converting this data to portable arch/os independent
     * format. i am ASSUMING e_fm_main and e are local and built together
     * and thus this will work. if this ever changes this here needs to
     * change */
+   if (sized)
+     {
+        unsigned int len;
+
+        len = sizeof(struct stat) + 1 + strlen(path) + 1 + strlen(lnk) + 1 + strlen(rlnk) + 1;
+        eina_binbuf_append_length(buf, (void*)&len, sizeof(unsigned int));
+     }
    eina_binbuf_append_length(buf, (void*)&st, sizeof(struct stat));
 
    eina_binbuf_append_char(buf, !!broken_lnk);
    eina_binbuf_append_length(buf, (void*)path, strlen(path) + 1);
    eina_binbuf_append_length(buf, (void*)lnk, strlen(lnk) + 1);
    eina_binbuf_append_length(buf, (void*)rlnk, strlen(rlnk) + 1);
-
-   ecore_ipc_server_send(_e_fm_ipc_server, 6 /*E_IPC_DOMAIN_FM*/, op, 0, ed->id,
-                         listing, eina_binbuf_string_get(buf), eina_binbuf_length_get(buf));
-   eina_binbuf_free(buf);
    free(lnk);
    free(rlnk);
+   return EINA_TRUE;
 }
 
 static void
@@ -0,0 +1,171 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+/* list a directory of a few thousand long-named files through
+ * enlightenment_fm the way e does and check every file arrives. like e,
+ * this raises ecore_ipc's receive size limit to E_FM_OP_IPC_DATA_MAX and
+ * no further, so a batch that is too big is lost and the count comes up
+ * short.
+ *
+ * usage: e_fm_list_test /path/to/enlightenment_fm
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <Eina.h>
+#include <Ecore.h>
+#include <Ecore_Ipc.h>
+#include <Ecore_File.h>
+
+#define E_TYPEDEFS
+#include "e_fm_op.h"
+#undef E_TYPEDEFS
+
+#define FILES   3000
+#define TIMEOUT 30.0
+
+static char        _list_dir[PATH_MAX];
+static int         _seen = 0;
+static Eina_Bool   _ok = EINA_FALSE;
+
+static int
+_records_count(const unsigned char *data, int size)
+{
+   const unsigned char *p = data, *end = data + size;
+   unsigned int len;
+   int n = 0;
+
+   while (p + sizeof(unsigned int) <= end)
+     {
+        memcpy(&len, p, sizeof(unsigned int));
+        p += sizeof(unsigned int);
+        if (len > (size_t)(end - p)) break;
+        p += len;
+        n++;
+     }
+   return n;
+}
+
+static Eina_Bool
+_cb_client_add(void *data EINA_UNUSED, int type EINA_UNUSED, void *event)
+{
+   Ecore_Ipc_Event_Client_Add *e = event;
+
+   ecore_ipc_client_data_size_max_set(e->client, E_FM_OP_IPC_DATA_MAX);
+   ecore_ipc_client_send(e->client, 6 /*E_IPC_DOMAIN_FM*/,
+                         E_FM_OP_MONITOR_START, 1, 0, 0,
+                         _list_dir, strlen(_list_dir) + 1);
+   return ECORE_CALLBACK_PASS_ON;
+}
+
+static Eina_Bool
+_cb_client_data(void *data EINA_UNUSED, int type EINA_UNUSED, void *event)
+{
+   Ecore_Ipc_Event_Client_Data *e = event;
+
+   if (e->major != 6 /*E_IPC_DOMAIN_FM*/) return ECORE_CALLBACK_PASS_ON;
+   if (e->response != 2) return ECORE_CALLBACK_PASS_ON;
+   if (e->minor == E_FM_OP_FILE_ADD_BATCH)
+     _seen += _records_count(e->data, e->size);
+   else if ((e->minor == E_FM_OP_FILE_ADD) && (e->size > 0) &&
+            (((const char *)e->data)[sizeof(struct stat) + 1]))
+     _seen++;
+   if (_seen >= FILES)
+     {
+        _ok = (_seen == FILES);
+        ecore_main_loop_quit();
+     }
+   return ECORE_CALLBACK_PASS_ON;
+}
+
+static Eina_Bool
+_cb_timeout(void *data EINA_UNUSED)
+{
+   ecore_main_loop_quit();
+   return ECORE_CALLBACK_CANCEL;
+}
+
+int
+main(int argc, char **argv)
+{
+   Ecore_Ipc_Server *srv;
+   Ecore_Exe *exe;
+   char base[] = "/tmp/e_fm_list_test-XXXXXX";
+   char name[256], buf[PATH_MAX + 256], sock[PATH_MAX];
+   int i, fd;
+
+   if (argc < 2)
+     {
+        fprintf(stderr, "usage: %s /path/to/enlightenment_fm\n", argv[0]);
+        return 2;
+     }
+   eina_init();
+   ecore_init();
+   ecore_file_init();
+   ecore_ipc_init();
+
+   if (!mkdtemp(base))
+     {
+        perror("mkdtemp");
+        return 1;
+     }
+   snprintf(_list_dir, sizeof(_list_dir), "%s/list", base);
+   mkdir(_list_dir, 0700);
+   /* near NAME_MAX, so records are big and a count alone can't size a
+    * batch */
+   memset(name, 'x', 240);
+   name[240] = 0;
+   for (i = 0; i < FILES; i++)
+     {
+        snprintf(buf, sizeof(buf), "%s/%05i-%s", _list_dir, i, name);
+        fd = open(buf, O_CREAT | O_WRONLY, 0600);
+        if (fd < 0)
+          {
+             perror(buf);
+             ecore_file_recursive_rm(base);
+             return 1;
+          }
+        close(fd);
+     }
+
+   snprintf(sock, sizeof(sock), "%s/ipc", base);
+   srv = ecore_ipc_server_add(ECORE_IPC_LOCAL_SYSTEM, sock, 0, NULL);
+   if (!srv)
+     {
+        fprintf(stderr, "cannot listen on %s\n", sock);
+        ecore_file_recursive_rm(base);
+        return 1;
+     }
+   setenv("E_IPC_SOCKET", sock, 1);
+   ecore_event_handler_add(ECORE_IPC_EVENT_CLIENT_ADD, _cb_client_add, NULL);
+   ecore_event_handler_add(ECORE_IPC_EVENT_CLIENT_DATA, _cb_client_data, NULL);
+   ecore_timer_add(TIMEOUT, _cb_timeout, NULL);
+
+   exe = ecore_exe_run(argv[1], NULL);
+   if (!exe)
+     {
+        fprintf(stderr, "cannot run %s\n", argv[1]);
+        ecore_file_recursive_rm(base);
+        return 1;
+     }
+   ecore_main_loop_begin();
+
+   ecore_exe_kill(exe);
+   ecore_exe_free(exe);
+   ecore_ipc_server_del(srv);
+   ecore_file_recursive_rm(base);
+   if (!_ok)
+     fprintf(stderr, "listed %i of %i files\n", _seen, FILES);
+
+   ecore_ipc_shutdown();
+   ecore_file_shutdown();
+   ecore_shutdown();
+   eina_shutdown();
+   return _ok ? 0 : 1;
+}
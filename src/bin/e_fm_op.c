@@ -33,6 +33,13 @@ void *alloca(size_t);
 #include <errno.h>
 #include <limits.h>
 #include <fcntl.h>
+#include <sys/ioctl.h>
+#ifdef HAVE_SENDFILE
+# include <sys/sendfile.h>
+#endif
+#ifdef HAVE_FICLONE
+# include <linux/fs.h>
+#endif
 
 #include <Ecore.h>
 #include <Ecore_File.h>
@@ -45,7 +52,12 @@ void *alloca(size_t);
 #include "e_fm_op.h"
 
 #define READBUFSIZE     65536
-#define COPYBUFSIZE     16384
+#define COPYCHUNKMIN    (64 * 1024)
+#define COPYCHUNKSTART  (1024 * 1024)
+#define COPYCHUNKMAX    (64 * 1024 * 1024)
+#define COPYBUFALIGN    4096
+/* aim for chunks taking this long so abort + progress stay responsive */
+#define COPYCHUNKTIME   0.02
 #define REMOVECHUNKSIZE 4096
 #define NB_PASS         3
 
@@ -153,10 +165,22 @@ struct _E_Fm_Op_Task
    Eina_List    *link;
 };
 
+typedef enum _E_Fm_Op_Copy_Method
+{
+   E_FM_OP_COPY_METHOD_COPY_FILE_RANGE,
+   E_FM_OP_COPY_METHOD_REFLINK,
+   E_FM_OP_COPY_METHOD_SENDFILE,
+   E_FM_OP_COPY_METHOD_READ_WRITE
+} E_Fm_Op_Copy_Method;
+
 struct _E_Fm_Op_Copy_Data
 {
    FILE *from;
    FILE *to;
+   E_Fm_Op_Copy_Method method;
+   size_t chunk;
+   void *buf;
+   size_t bufsize;
 };
 
 int
@@ -476,6 +500,7 @@ _e_fm_op_task_free(void *t)
           {
              if (data->from) fclose(data->from);
              if (data->to) fclose(data->to);
+             free(data->buf);
           }
         E_FREE(task->data);
      }
@@ -1031,6 +1056,7 @@ _e_fm_op_rollback(E_Fm_Op_Task *task)
                   fclose(data->to);
                   data->to = NULL;
                }
+             E_FREE(data->buf);
           }
         E_FREE(task->data);
         _e_fm_op_update_progress(task, -task->dst.done,
@@ -1361,10 +1387,10 @@ _e_fm_op_open_files(E_Fm_Op_Task *task)
    /* Ordinary file. */
    if (!data)
      {
-        data = malloc(sizeof(E_Fm_Op_Copy_Data));
+        data = calloc(1, sizeof(E_Fm_Op_Copy_Data));
         task->data = data;
-        data->to = NULL;
-        data->from = NULL;
+        data->method = E_FM_OP_COPY_METHOD_COPY_FILE_RANGE;
+        data->chunk = COPYCHUNKSTART;
      }
 
    if (!data->from)
@@ -1385,12 +1411,106 @@ _e_fm_op_open_files(E_Fm_Op_Task *task)
    return 0;
 }
 
+/* Copies up to data->chunk bytes from data->from to data->to, trying the
+ * cheapest method the kernel offers first and falling back when a method is
+ * not supported for this pair of files:
+ *   copy_file_range() -> FICLONE reflink -> sendfile() -> read()/write()
+ * Returns the number of bytes copied, 0 at end of file and -1 on error.
+ */
+static ssize_t
+_e_fm_op_copy_chunk_do(E_Fm_Op_Task *task, E_Fm_Op_Copy_Data *data)
+{
+   int in = fileno(data->from), out = fileno(data->to);
+   ssize_t ret, w, done;
+
+   switch (data->method)
+     {
+      case E_FM_OP_COPY_METHOD_COPY_FILE_RANGE:
+#ifdef HAVE_COPY_FILE_RANGE
+        ret = copy_file_range(in, NULL, out, NULL, data->chunk, 0);
+        if (ret > 0) return ret;
+        /* procfs, sysfs and some fuse/nfs files claim a size but give
+         * nothing through copy_file_range() - not eof, try the next */
+        if ((ret == 0) &&
+            ((task->dst.done) || (task->src.st.st_size <= 0)))
+          return 0;
+        /* nothing copied yet - just not supported here, try the next */
+        if (((ret == 0) || (errno == ENOSYS) || (errno == EXDEV) ||
+             (errno == EINVAL) || (errno == EOPNOTSUPP)) &&
+            (!task->dst.done))
+          {
+             data->method = E_FM_OP_COPY_METHOD_REFLINK;
+             return _e_fm_op_copy_chunk_do(task, data);
+          }
+        return -1;
+#endif
+        /* fallthrough */
+      case E_FM_OP_COPY_METHOD_REFLINK:
+#ifdef HAVE_FICLONE
+        if ((!task->dst.done) && (!ioctl(out, FICLONE, in)))
+          {
+             /* the whole file is shared now - move both offsets to the end */
+             lseek(in, 0, SEEK_END);
+             lseek(out, 0, SEEK_END);
+             return task->src.st.st_size;
+          }
+#endif
+        data->method = E_FM_OP_COPY_METHOD_SENDFILE;
+        /* fallthrough */
+      case E_FM_OP_COPY_METHOD_SENDFILE:
+#ifdef HAVE_SENDFILE
+        ret = sendfile(out, in, NULL, data->chunk);
+        if ((ret > 0) ||
+            ((ret == 0) && ((task->dst.done) || (task->src.st.st_size <= 0))))
+          return ret;
+        if (((ret == 0) || (errno == ENOSYS) || (errno == EINVAL)) &&
+            (!task->dst.done))
+          data->method = E_FM_OP_COPY_METHOD_READ_WRITE;
+        else
+          return -1;
+#else
+        data->method = E_FM_OP_COPY_METHOD_READ_WRITE;
+#endif
+        /* fallthrough */
+      case E_FM_OP_COPY_METHOD_READ_WRITE:
+      default:
+        if (data->bufsize < data->chunk)
+          {
+             free(data->buf);
+             data->buf = NULL;
+             data->bufsize = 0;
+             if (posix_memalign(&data->buf, COPYBUFALIGN, data->chunk))
+               {
+                  data->buf = NULL;
+                  return -1;
+               }
+             data->bufsize = data->chunk;
+          }
+        ret = read(in, data->buf, data->chunk);
+        if (ret <= 0) return ret;
+        for (done = 0; done < ret; done += w)
+          {
+             w = write(out, (char *)data->buf + done, ret - done);
+             if (w < 0)
+               {
+                  if (errno == EINTR)
+                    {
+                       w = 0;
+                       continue;
+                    }
+                  return -1;
+               }
+          }
+        return ret;
+     }
+}
+
 static int
 _e_fm_op_copy_chunk(E_Fm_Op_Task *task)
 {
    E_Fm_Op_Copy_Data *data;
-   size_t dread, dwrite;
-   char buf[COPYBUFSIZE];
+   ssize_t dcopy;
+   double t;
 
    data = task->data;
 
@@ -1402,12 +1522,12 @@ _e_fm_op_copy_chunk(E_Fm_Op_Task *task)
         return 1;
      }
 
-   dread = fread(buf, 1, sizeof(buf), data->from);
-   if (dread == 0)
+   t = ecore_time_get();
+   dcopy = _e_fm_op_copy_chunk_do(task, data);
+   if (dcopy < 0)
+     _E_FM_OP_ERROR_SEND_WORK(task, E_FM_OP_ERROR, "Cannot copy data to '%s': %s.", task->dst.name);
+   if (dcopy == 0)
      {
-        if (!feof(data->from))
-          _E_FM_OP_ERROR_SEND_WORK(task, E_FM_OP_ERROR, "Cannot read data from '%s': %s.", task->dst.name);
-
         fclose(data->from);
         fclose(data->to);
         data->to = NULL;
@@ -1415,6 +1535,7 @@ _e_fm_op_copy_chunk(E_Fm_Op_Task *task)
 
         _e_fm_op_copy_stat_info(task);
 
+        free(data->buf);
         E_FREE(task->data);
 
         task->finished = 1;
@@ -1424,13 +1545,15 @@ _e_fm_op_copy_chunk(E_Fm_Op_Task *task)
         return 1;
      }
 
-   dwrite = fwrite(buf, 1, dread, data->to);
-
-   if (dwrite < dread)
-     _E_FM_OP_ERROR_SEND_WORK(task, E_FM_OP_ERROR, "Cannot write data to '%s': %s.", task->dst.name);
+   /* adapt the chunk size to the measured throughput */
+   t = ecore_time_get() - t;
+   if ((t < (COPYCHUNKTIME / 2)) && (data->chunk < COPYCHUNKMAX))
+     data->chunk *= 2;
+   else if ((t > (COPYCHUNKTIME * 2)) && (data->chunk > COPYCHUNKMIN))
+     data->chunk /= 2;
 
-   task->dst.done += dread;
-   _e_fm_op_update_progress(task, dwrite, 0);
+   task->dst.done += dcopy;
+   _e_fm_op_update_progress(task, dcopy, 0);
 
    return 0;
 }
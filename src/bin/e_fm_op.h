@@ -4,6 +4,11 @@
 
 #define E_FM_OP_MAGIC 314
 
+/* e raises ecore_ipc's receive limit (32k by default) for the
+ * enlightenment_fm connection to this, so one E_FM_OP_FILE_ADD_BATCH can
+ * carry a whole batch of listing entries */
+#define E_FM_OP_IPC_DATA_MAX (4 * 1024 * 1024)
+
 typedef enum _E_Fm_Op_Type
 {
    E_FM_OP_COPY = 0,
@@ -54,7 +59,8 @@ typedef enum _E_Fm_Op_Type
    E_FM_OP_SECURE_REMOVE,
    E_FM_OP_DESTROY,
    E_FM_OP_VOLUME_LIST_DONE,
-   E_FM_OP_INIT
+   E_FM_OP_INIT,
+   E_FM_OP_FILE_ADD_BATCH
 } E_Fm_Op_Type;
 
 #else
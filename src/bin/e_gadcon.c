@@ -3516,6 +3516,10 @@ struct _E_Gadcon_Layout_Item
    {
       int w, h;
    } min, aspect, aspect_pad;
+   struct
+   {
+      int size, min, mino;
+   } res; /* min/aspect as resolved by the last layout */
 
    E_Gadcon_Client *gcc;
 
@@ -3539,6 +3543,9 @@ static void                  _e_gadcon_layout_smart_hide(Evas_Object *obj);
 static void                  _e_gadcon_layout_smart_color_set(Evas_Object *obj, int r, int g, int b, int a);
 static void                  _e_gadcon_layout_smart_clip_set(Evas_Object *obj, Evas_Object *clip);
 static void                  _e_gadcon_layout_smart_clip_unset(Evas_Object *obj);
+static void                  _e_gadcon_layout_smart_item_resolve(E_Smart_Data *sd, const E_Gadcon_Layout_Item *bi, int *size, int *min, int *mino);
+static void                  _e_gadcon_layout_smart_item_hints_changed(E_Gadcon_Layout_Item *bi);
+static int                   _e_gadcon_layout_smart_item_asked_x_get(E_Smart_Data *sd, const E_Gadcon_Layout_Item *bi, int size, int size2, int *hookp);
 static void                  _e_gadcon_layout_smart_min_cur_size_calc(E_Smart_Data *sd, int *min, int *mino, int *cur);
 static void                  _e_gadcon_layout_smart_gadcons_width_adjust(E_Smart_Data *sd, int min, int cur);
 static int                   _e_gadcon_layout_smart_sort_by_sequence_number_cb(const void *d1, const void *d2);
@@ -3827,18 +3834,19 @@ e_gadcon_layout_pack_min_size_set(Evas_Object *obj, int w, int h)
         evas_object_size_hint_min_set(obj, w, h);
         return;
      }
-   if (bi->sd->horizontal)
-     {
-        bi->min.w = w;
-        bi->min.h = h;
-     }
-   else
+   if (!bi->sd->horizontal)
      {
-        bi->min.w = h;
-        bi->min.h = w;
+        int t = w;
+
+        w = h;
+        h = t;
      }
+   /* gadgets like the clock set this on every update */
+   if ((bi->min.w == w) && (bi->min.h == h)) return;
+   bi->min.w = w;
+   bi->min.h = h;
 
-   _e_gadcon_layout_smart_reconfigure(bi->sd);
+   _e_gadcon_layout_smart_item_hints_changed(bi);
 }
 
 static void
@@ -3853,18 +3861,18 @@ e_gadcon_layout_pack_aspect_set(Evas_Object *obj, int w, int h)
         evas_object_size_hint_aspect_set(obj, EVAS_ASPECT_CONTROL_BOTH, w, h);
         return;
      }
-   if (bi->sd->horizontal)
-     {
-        bi->aspect.w = w;
-        bi->aspect.h = h;
-     }
-   else
+   if (!bi->sd->horizontal)
      {
-        bi->aspect.w = h;
-        bi->aspect.h = w;
+        int t = w;
+
+        w = h;
+        h = t;
      }
+   if ((bi->aspect.w == w) && (bi->aspect.h == h)) return;
+   bi->aspect.w = w;
+   bi->aspect.h = h;
 
-   _e_gadcon_layout_smart_reconfigure(bi->sd);
+   _e_gadcon_layout_smart_item_hints_changed(bi);
 }
 
 static void
@@ -4300,6 +4308,25 @@ _e_gadcon_layout_smart_clip_unset(Evas_Object *obj)
    evas_object_clip_unset(sd->clip);
 }
 
+/* what min and aspect come down to along the layout: the size the item is
+ * laid out at, what it adds to the min/current size, and its min across */
+static void
+_e_gadcon_layout_smart_item_resolve(E_Smart_Data *sd, const E_Gadcon_Layout_Item *bi, int *size, int *min, int *mino)
+{
+   if ((bi->aspect.w > 0) && (bi->aspect.h > 0))
+     {
+        *size =
+          (((sd->h - bi->aspect_pad.h) * bi->aspect.w) / bi->aspect.h) + bi->aspect_pad.w;
+        *min = MAX(*size, bi->min.w);
+        *mino = 0;
+     }
+   else
+     {
+        *size = *min = bi->min.w;
+        *mino = bi->min.h;
+     }
+}
+
 /*
  * @min - the minimum width required by all the gadcons
  * @cur - the current width required by all the gadcons
@@ -4315,35 +4342,127 @@ _e_gadcon_layout_smart_min_cur_size_calc(E_Smart_Data *sd, int *min, int *mino,
    EINA_LIST_FOREACH(sd->items, l, item)
      {
         bi = evas_object_data_get(item, "e_gadcon_layout_data");
-        bi->ask.size2 = bi->ask.size;
+        _e_gadcon_layout_smart_item_resolve(sd, bi, &bi->res.size,
+                                            &bi->res.min, &bi->res.mino);
+        bi->ask.size2 = bi->res.size;
+        if ((bi->aspect.w <= 0) || (bi->aspect.h <= 0))
+          bi->ask.size = bi->min.w;
+        *min += bi->res.min;
+        *cur += bi->res.min;
+        if (bi->res.mino > *mino) *mino = bi->res.mino;
+     }
+}
 
-        if ((bi->aspect.w > 0) && (bi->aspect.h > 0))
-          {
-             bi->ask.size2 =
-               (((sd->h - bi->aspect_pad.h) * bi->aspect.w) / bi->aspect.h) + bi->aspect_pad.w;
+/* the layout keeps to the asked positions and nothing is being dragged,
+ * so the resolved sizes are all that feed into it */
+static Eina_Bool
+_e_gadcon_layout_smart_static_get(E_Smart_Data *sd)
+{
+   E_Gadcon_Layout_Item *bi;
+   Eina_List *l;
+   Evas_Object *item;
 
-             if (bi->ask.size2 > bi->min.w)
-               {
-                  *min += bi->ask.size2;
-                  *cur += bi->ask.size2;
-               }
-             else
-               {
-                  *min += bi->min.w;
-                  *cur += bi->min.w;
-               }
-          }
-        else
-          {
-             bi->ask.size2 = bi->ask.size = bi->min.w;
-             *min += bi->min.w;
-             if (bi->min.h > *mino) *mino = bi->min.h;
-             if (bi->ask.size < bi->min.w)
-               *cur += bi->min.w;
-             else
-               *cur += bi->ask.size;
-          }
+   if ((sd->frozen) || (sd->doing_config) || (sd->w <= sd->req))
+     return EINA_FALSE;
+   EINA_LIST_FOREACH(sd->items, l, item)
+     {
+        bi = evas_object_data_get(item, "e_gadcon_layout_data");
+        if ((!bi->gcc) ||
+            (bi->gcc->state_info.state != E_LAYOUT_ITEM_STATE_NONE))
+          return EINA_FALSE;
      }
+   return EINA_TRUE;
+}
+
+/* resize a single item in place. only valid when the item's own position
+ * does not depend on its size and nothing after it is pushed along by it:
+ * then a full layout would end up with the same geometry for all others */
+static Eina_Bool
+_e_gadcon_layout_smart_item_resize(E_Smart_Data *sd, E_Gadcon_Layout_Item *bi, int size, int min)
+{
+   E_Gadcon_Layout_Item *bi2;
+   Eina_List *l;
+   int hookp, hookp2, ask_size, end, delta, dmin;
+
+   if (bi->w != bi->res.size) return EINA_FALSE;
+   dmin = min - bi->res.min;
+   if ((sd->req + dmin) >= sd->w) return EINA_FALSE;
+
+   /* hooking to the middle centers on the size, elsewhere it only moves
+    * the item if it changes what the item is hooked to */
+   ask_size = bi->ask.size;
+   if ((bi->aspect.w <= 0) || (bi->aspect.h <= 0)) ask_size = bi->min.w;
+   if (_e_gadcon_layout_smart_item_asked_x_get(sd, bi, bi->ask.size, bi->ask.size2, &hookp) !=
+       _e_gadcon_layout_smart_item_asked_x_get(sd, bi, ask_size, size, &hookp2))
+     return EINA_FALSE;
+   if (hookp != hookp2) return EINA_FALSE;
+
+   delta = size - bi->w;
+   l = eina_list_data_find_list(sd->items, bi->obj);
+   if (!l) return EINA_FALSE;
+   if (eina_list_next(l))
+     {
+        bi2 = evas_object_data_get(eina_list_data_get(eina_list_next(l)),
+                                   "e_gadcon_layout_data");
+        /* pushed along by this one or by something before it */
+        if (bi2->x != _e_gadcon_layout_smart_item_asked_x_get
+            (sd, bi2, bi2->ask.size, bi2->ask.size2, NULL))
+          return EINA_FALSE;
+        end = bi2->x;
+     }
+   else
+     {
+        end = sd->w;
+        /* kept on screen at the end, which depends on the size */
+        if ((bi->x + bi->w) >= end) return EINA_FALSE;
+     }
+   if ((bi->x + bi->w + delta) > end) return EINA_FALSE;
+
+   bi->ask.size = ask_size;
+   bi->ask.size2 = size;
+   bi->ask.prev_size = size;
+   bi->w = size;
+   bi->res.size = size;
+   bi->res.min = min;
+   bi->gcc->config.size = size;
+   if (sd->horizontal)
+     evas_object_resize(bi->obj, bi->w, bi->h);
+   else
+     evas_object_resize(bi->obj, bi->h, bi->w);
+
+   if (dmin)
+     {
+        sd->minw += dmin;
+        sd->req = sd->minw;
+        evas_object_smart_callback_call(sd->obj, "min_size_request", NULL);
+        evas_object_smart_callback_call(sd->obj, "size_request", NULL);
+     }
+   return EINA_TRUE;
+}
+
+/* one item's min or aspect changed. most of the time (clock ticks, battery
+ * updates) that either changes nothing the layout uses or only the item's
+ * own size, so avoid re-solving the whole layout for it */
+static void
+_e_gadcon_layout_smart_item_hints_changed(E_Gadcon_Layout_Item *bi)
+{
+   E_Smart_Data *sd = bi->sd;
+   int size, min, mino;
+
+   if (!_e_gadcon_layout_smart_static_get(sd))
+     {
+        _e_gadcon_layout_smart_reconfigure(sd);
+        return;
+     }
+   _e_gadcon_layout_smart_item_resolve(sd, bi, &size, &min, &mino);
+   if ((size == bi->res.size) && (min == bi->res.min) &&
+       (mino == bi->res.mino))
+     return;
+   /* the min size across is the max over all items */
+   if ((mino == bi->res.mino) &&
+       (_e_gadcon_layout_smart_item_resize(sd, bi, size, min)))
+     return;
+   _e_gadcon_layout_smart_reconfigure(sd);
 }
 
 static int
@@ -4649,6 +4768,53 @@ _e_gadcon_layout_smart_gadcon_position_shrinked_mode(E_Smart_Data *sd)
      }
 }
 
+/* where an item asks to be given its asked size (size) and the size it
+ * is laid out at (size2) */
+static int
+_e_gadcon_layout_smart_item_asked_x_get(E_Smart_Data *sd, const E_Gadcon_Layout_Item *bi, int size, int size2, int *hookp)
+{
+   int pos, x, hook;
+
+   pos = bi->ask.pos + (size / 2);
+   if (pos < (bi->ask.res / 3))
+     {
+        /* hooked to start */
+        x = bi->ask.pos;
+        hook = 0;
+     }
+   else if (pos > ((2 * bi->ask.res) / 3))
+     {
+        /* hooked to end */
+        x = (bi->ask.pos - bi->ask.res) + sd->w;
+        hook = bi->ask.res;
+     }
+   else
+     {
+        /* hooked to middle */
+        if ((bi->ask.pos <= (bi->ask.res / 2)) &&
+            ((bi->ask.pos + size2) > (bi->ask.res / 2)))
+          {
+             /* straddles middle */
+             if (bi->ask.res > 2)
+               x = (sd->w / 2) +
+                 (((bi->ask.pos + (size2 / 2) -
+                    (bi->ask.res / 2)) *
+                   (bi->ask.res / 2)) /
+                  (bi->ask.res / 2)) - (size2 / 2);
+             else
+               x = sd->w / 2;
+          }
+        else
+          {
+             /* either side of middle */
+             x = (bi->ask.pos - (bi->ask.res / 2)) + (sd->w / 2);
+          }
+        hook = bi->ask.res / 2;
+     }
+   if (hookp) *hookp = hook;
+   return x;
+}
+
 static void
 _e_gadcon_layout_smart_gadcons_asked_position_set(E_Smart_Data *sd)
 {
@@ -4666,52 +4832,15 @@ _e_gadcon_layout_smart_gadcons_asked_position_set(E_Smart_Data *sd)
         bi->w = bi->ask.size2;
      }
 #else
-   int pos;
    EINA_LIST_FOREACH(sd->items, l, item)
      {
         bi = evas_object_data_get(item, "e_gadcon_layout_data");
         if (!bi) continue;
 
-        pos = bi->ask.pos + (bi->ask.size / 2);
-        if (pos < (bi->ask.res / 3))
-          {
-             /* hooked to start */
-             bi->x = bi->ask.pos;
-             bi->w = bi->ask.size2;
-             bi->hookp = 0;
-          }
-        else if (pos > ((2 * bi->ask.res) / 3))
-          {
-             /* hooked to end */
-             bi->x = (bi->ask.pos - bi->ask.res) + sd->w;
-             bi->w = bi->ask.size2;
-             bi->hookp = bi->ask.res;
-          }
-        else
-          {
-             /* hooked to middle */
-             if ((bi->ask.pos <= (bi->ask.res / 2)) &&
-                 ((bi->ask.pos + bi->ask.size2) > (bi->ask.res / 2)))
-               {
-                  /* straddles middle */
-                  if (bi->ask.res > 2)
-                    bi->x = (sd->w / 2) +
-                      (((bi->ask.pos + (bi->ask.size2 / 2) -
-                         (bi->ask.res / 2)) *
-                        (bi->ask.res / 2)) /
-                       (bi->ask.res / 2)) - (bi->ask.size2 / 2);
-                  else
-                    bi->x = sd->w / 2;
-                  bi->w = bi->ask.size2;
-               }
-             else
-               {
-                  /* either side of middle */
-                  bi->x = (bi->ask.pos - (bi->ask.res / 2)) + (sd->w / 2);
-                  bi->w = bi->ask.size2;
-               }
-             bi->hookp = bi->ask.res / 2;
-          }
+        bi->x = _e_gadcon_layout_smart_item_asked_x_get(sd, bi, bi->ask.size,
+                                                        bi->ask.size2,
+                                                        &bi->hookp);
+        bi->w = bi->ask.size2;
      }
 #endif
 }
@@ -3,6 +3,7 @@
 typedef struct _E_Smart_Data E_Smart_Data;
 typedef struct _Cache_Item   Cache_Item;
 typedef struct _Cache        Cache;
+typedef struct _E_Icon_Cache_Entry E_Icon_Cache_Entry;
 
 struct _E_Smart_Data
 {
@@ -43,6 +44,21 @@ struct _Cache
    Eina_List   *load_queue;
 };
 
+/* a decoded icon kept alive by a hidden image object. evas shares the
+ * pixels of every image object with the same file, key and load options
+ * on a canvas, so while this holds it nobody else showing the icon at
+ * that size decodes it again */
+struct _E_Icon_Cache_Entry
+{
+   const char  *id;
+   Evas_Object *img;
+   Eina_List   *lru;
+   size_t       bytes;
+};
+
+/* upper bound for the (estimated) pixel memory held by the cache */
+#define E_ICON_CACHE_MAX (8 * 1024 * 1024)
+
 /* local subsystem functions */
 static void      _e_icon_smart_reconfigure(E_Smart_Data *sd);
 static void      _e_icon_smart_init(void);
@@ -57,19 +73,44 @@ static void      _e_icon_smart_clip_set(Evas_Object *obj, Evas_Object *clip);
 static void      _e_icon_smart_clip_unset(Evas_Object *obj);
 static void      _e_icon_obj_prepare(Evas_Object *obj, E_Smart_Data *sd);
 static void      _e_icon_preloaded(void *data, Evas *e, Evas_Object *obj, void *event_info);
+static int       _e_icon_cache_size_round(int size);
+static void      _e_icon_image_file_set(E_Smart_Data *sd, const char *file, const char *key);
 
 /* local subsystem globals */
 static Evas_Smart *_e_smart = NULL;
 
+static Eina_Hash *_e_icon_cache = NULL;
+static Eina_List *_e_icon_cache_lru = NULL;
+static size_t _e_icon_cache_bytes = 0;
+static E_Icon_Cache_Stats _e_icon_cache_stats;
+
+static void
+_e_icon_cache_entry_free(E_Icon_Cache_Entry *ce)
+{
+   eina_stringshare_del(ce->id);
+   free(ce);
+}
+
 EINTERN int
 e_icon_init(void)
 {
+   _e_icon_cache = eina_hash_string_superfast_new
+     ((Eina_Free_Cb)_e_icon_cache_entry_free);
    return 1;
 }
 
 EINTERN int
 e_icon_shutdown(void)
 {
+   E_Icon_Cache_Entry *ce;
+
+   /* deleting the image drops the entry */
+   EINA_LIST_FREE(_e_icon_cache_lru, ce)
+     {
+        ce->lru = NULL;
+        evas_object_del(ce->img);
+     }
+   E_FREE_FUNC(_e_icon_cache, eina_hash_free);
    return 1;
 }
 
@@ -104,6 +145,129 @@ _e_icon_obj_prepare(Evas_Object *obj, E_Smart_Data *sd)
      }
 }
 
+static void
+_e_icon_cache_img_del(void *data, Evas *e EINA_UNUSED, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+{
+   E_Icon_Cache_Entry *ce = data;
+
+   if (ce->lru)
+     _e_icon_cache_lru = eina_list_remove_list(_e_icon_cache_lru, ce->lru);
+   _e_icon_cache_bytes -= ce->bytes;
+   eina_hash_del_by_key(_e_icon_cache, ce->id);
+}
+
+static void
+_e_icon_cache_bytes_set(E_Icon_Cache_Entry *ce, int w, int h)
+{
+   E_Icon_Cache_Entry *old;
+
+   _e_icon_cache_bytes -= ce->bytes;
+   ce->bytes = (size_t)w * h * 4;
+   _e_icon_cache_bytes += ce->bytes;
+
+   /* widgets still showing an evicted icon keep their own reference */
+   while ((_e_icon_cache_bytes > E_ICON_CACHE_MAX) &&
+          (_e_icon_cache_lru != ce->lru))
+     {
+        old = eina_list_data_get(_e_icon_cache_lru);
+        _e_icon_cache_stats.evictions++;
+        evas_object_del(old->img);
+     }
+}
+
+static void
+_e_icon_cache_img_preloaded(void *data, Evas *e EINA_UNUSED, Evas_Object *obj, void *event_info EINA_UNUSED)
+{
+   E_Icon_Cache_Entry *ce = data;
+   int w = 0, h = 0;
+
+   if (evas_object_image_load_error_get(obj) != EVAS_LOAD_ERROR_NONE)
+     {
+        evas_object_del(obj);
+        return;
+     }
+   evas_object_image_size_get(obj, &w, &h);
+   _e_icon_cache_bytes_set(ce, w, h);
+}
+
+static void
+_e_icon_cache_ref(Evas_Object *obj, const char *file, const char *key, Eina_Bool preload)
+{
+   E_Icon_Cache_Entry *ce;
+   Evas_Object *img;
+   char buf[PATH_MAX + 256];
+   int w = 0, h = 0;
+
+   if ((!_e_icon_cache) || (!file) || (!file[0])) return;
+   evas_object_image_load_size_get(obj, &w, &h);
+   snprintf(buf, sizeof(buf), "%p:%dx%d:%s:%s", evas_object_evas_get(obj),
+            w, h, file, key ? key : "");
+   ce = eina_hash_find(_e_icon_cache, buf);
+   if (ce)
+     {
+        _e_icon_cache_stats.hits++;
+        _e_icon_cache_lru = eina_list_demote_list(_e_icon_cache_lru, ce->lru);
+        return;
+     }
+   _e_icon_cache_stats.misses++;
+
+   /* same load options as the widget, or evas would not share the decode,
+    * and no synchronous header load when the widget preloads */
+   img = evas_object_image_add(evas_object_evas_get(obj));
+   evas_object_pass_events_set(img, EINA_TRUE);
+   if ((w > 0) && (h > 0))
+     evas_object_image_load_size_set(img, w, h);
+   evas_object_image_load_head_skip_set(img, preload);
+   evas_object_image_file_set(img, file, key);
+   if ((!preload) &&
+       (evas_object_image_load_error_get(img) != EVAS_LOAD_ERROR_NONE))
+     {
+        evas_object_del(img);
+        return;
+     }
+
+   ce = E_NEW(E_Icon_Cache_Entry, 1);
+   ce->id = eina_stringshare_add(buf);
+   ce->img = img;
+   evas_object_event_callback_add(img, EVAS_CALLBACK_DEL,
+                                  _e_icon_cache_img_del, ce);
+   evas_object_event_callback_add(img, EVAS_CALLBACK_IMAGE_PRELOADED,
+                                  _e_icon_cache_img_preloaded, ce);
+   eina_hash_add(_e_icon_cache, ce->id, ce);
+   _e_icon_cache_lru = eina_list_append(_e_icon_cache_lru, ce);
+   ce->lru = eina_list_last(_e_icon_cache_lru);
+
+   /* the load size bounds the decode until the real size is known */
+   if (!preload) evas_object_image_size_get(img, &w, &h);
+   _e_icon_cache_bytes_set(ce, w, h);
+   evas_object_image_preload(img, EINA_FALSE);
+}
+
+/* icons are asked for at whatever size the widget happens to be; round
+ * that up so nearly equal sizes share a decode. the step is at most 1/8 of
+ * the size (4px below 32), so from 32px up a decode is never more than
+ * about 1.27x the pixels asked for */
+static int
+_e_icon_cache_size_round(int size)
+{
+   int step = 4;
+
+   if (size <= 0) return size;
+   while ((step * 16) <= size) step *= 2;
+   return ((size + step - 1) / step) * step;
+}
+
+static void
+_e_icon_image_file_set(E_Smart_Data *sd, const char *file, const char *key)
+{
+   int size = _e_icon_cache_size_round(sd->size);
+
+   if (size > 0)
+     evas_object_image_load_size_set(sd->obj, size, size);
+   evas_object_image_file_set(sd->obj, file, key);
+   _e_icon_cache_ref(sd->obj, file, key, sd->preload);
+}
+
 static Eina_Bool
 _frame_anim(void *data)
 {
@@ -173,13 +337,11 @@ e_icon_file_set(Evas_Object *obj, const char *file)
    sd->invalid = 0;
    sd->edje = EINA_FALSE;
 
-   if (sd->size != 0)
-     evas_object_image_load_size_set(sd->obj, sd->size, sd->size);
    if (sd->preload) evas_object_hide(sd->obj);
 
    if (sd->preload)
      evas_object_image_load_head_skip_set(sd->obj, EINA_TRUE);
-   evas_object_image_file_set(sd->obj, file, NULL);
+   _e_icon_image_file_set(sd, file, NULL);
 //   if (evas_object_image_load_error_get(sd->obj) != EVAS_LOAD_ERROR_NONE)
 //     return EINA_FALSE;
 
@@ -224,12 +386,10 @@ e_icon_file_key_set(Evas_Object *obj, const char *file, const char *key)
    sd->edje = EINA_FALSE;
 
    _e_icon_obj_prepare(obj, sd);
-   if (sd->size != 0)
-     evas_object_image_load_size_set(sd->obj, sd->size, sd->size);
    if (sd->preload) evas_object_hide(sd->obj);
    if (sd->preload)
      evas_object_image_load_head_skip_set(sd->obj, EINA_TRUE);
-   evas_object_image_file_set(sd->obj, file, key);
+   _e_icon_image_file_set(sd, file, key);
 //   if (evas_object_image_load_error_get(sd->obj) != EVAS_LOAD_ERROR_NONE)
 //     return EINA_FALSE;
    if (!_handle_anim(sd))
@@ -371,12 +531,10 @@ e_icon_fdo_icon_set(Evas_Object *obj, const char *icon)
    /* smart code here */
    _e_icon_obj_prepare(obj, sd);
    sd->loading = 0;
-   if (sd->size != 0)
-     evas_object_image_load_size_set(sd->obj, sd->size, sd->size);
    if (sd->preload) evas_object_hide(sd->obj);
    if (sd->preload)
      evas_object_image_load_head_skip_set(sd->obj, EINA_TRUE);
-   evas_object_image_file_set(sd->obj, path, NULL);
+   _e_icon_image_file_set(sd, path, NULL);
 //   if (evas_object_image_load_error_get(sd->obj) != EVAS_LOAD_ERROR_NONE)
 //     return EINA_FALSE;
    if (sd->preload)
@@ -603,7 +761,8 @@ e_icon_scale_size_set(Evas_Object *obj, int size)
    if (!(sd = evas_object_smart_data_get(obj))) return;
    sd->size = size;
    if (sd->edje) return;
-   evas_object_image_load_size_set(sd->obj, sd->size, sd->size);
+   size = _e_icon_cache_size_round(size);
+   evas_object_image_load_size_set(sd->obj, size, size);
 }
 
 E_API int
@@ -640,6 +799,21 @@ e_icon_edje_emit(const Evas_Object *obj, const char *sig, const char *src)
    edje_object_signal_emit(sd->obj, sig, src);
 }
 
+E_API void
+e_icon_cache_stats_get(E_Icon_Cache_Stats *stats)
+{
+   EINA_SAFETY_ON_NULL_RETURN(stats);
+   *stats = _e_icon_cache_stats;
+   stats->count = _e_icon_cache ? eina_hash_population(_e_icon_cache) : 0;
+   stats->bytes = _e_icon_cache_bytes;
+}
+
+E_API void
+e_icon_cache_stats_reset(void)
+{
+   memset(&_e_icon_cache_stats, 0, sizeof(E_Icon_Cache_Stats));
+}
+
 /* local subsystem globals */
 static void
 _e_icon_smart_reconfigure(E_Smart_Data *sd)
@@ -845,8 +1019,7 @@ _e_icon_fdo_reload(void *data)
 
 
    /* smart code here */
-   evas_object_image_load_size_set(sd->obj, sd->size, sd->size);
-   evas_object_image_file_set(sd->obj, path, NULL);
+   _e_icon_image_file_set(sd, path, NULL);
    if (sd->preload)
      {
         sd->loading = 1;
@@ -1,8 +1,21 @@
 #ifdef E_TYPEDEFS
+
+typedef struct _E_Icon_Cache_Stats E_Icon_Cache_Stats;
+
 #else
 #ifndef E_ICON_H
 #define E_ICON_H
 
+/* counters for the icon cache shared by all e_icon objects */
+struct _E_Icon_Cache_Stats
+{
+   unsigned long long hits; // loads that found the icon already decoded
+   unsigned long long misses; // loads that had to decode it
+   unsigned long long evictions; // icons dropped to stay under the memory cap
+   unsigned int count; // icons held right now
+   size_t bytes; // estimated pixel memory held right now
+};
+
 EINTERN int e_icon_init(void);
 EINTERN int e_icon_shutdown(void);
 
@@ -32,5 +45,7 @@ E_API void         e_icon_scale_size_set   (Evas_Object *obj, int size);
 E_API int          e_icon_scale_size_get   (const Evas_Object *obj);
 E_API void         e_icon_selected_set     (const Evas_Object *obj, Eina_Bool selected);
 E_API void         e_icon_edje_emit        (const Evas_Object *obj, const char *sig, const char *src);
+E_API void         e_icon_cache_stats_get  (E_Icon_Cache_Stats *stats);
+E_API void         e_icon_cache_stats_reset(void);
 #endif
 #endif
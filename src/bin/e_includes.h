@@ -100,6 +100,7 @@
 #include "e_fm_op_registry.h"
 #include "e_widget_scrollframe.h"
 #include "e_sha1.h"
+#include "e_thumb_cache.h"
 #include "e_widget_framelist.h"
 #include "e_widget_fsel.h"
 #include "e_fm_mime.h"
@@ -149,6 +150,7 @@
 #include "e_comp.h"
 #include "e_comp_cfdata.h"
 #include "e_comp_canvas.h"
+#include "e_comp_profile.h"
 #include "e_utils.h"
 #include "e_hints.h"
 #include "e_comp_x_randr.h"
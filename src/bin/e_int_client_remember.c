@@ -403,7 +403,7 @@ _check_matches(E_Remember *rem, int update)
 
         if (update)
           {
-             ec->changed = 1;
+             EC_CHANGED(ec);
              ec->changes.icon = 1;
           }
         else if (n > 1)
@@ -495,6 +495,8 @@ _advanced_apply_data(E_Config_Dialog *cfd EINA_UNUSED, E_Config_Dialog_Data *cfd
         rem->prop.desktop_file = NULL;
      }
 
+   /* match properties are edited in place below */
+   e_remember_match_index_invalidate();
    rem->match = 0;
    rem->apply_first_only = cfdata->remember.apply_first_only;
 
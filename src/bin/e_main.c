@@ -1460,6 +1460,8 @@ _e_main_path_init(void)
    snprintf(buf, sizeof(buf), "%s/enlightenment/modules_extra", e_prefix_lib_get());
    e_path_default_path_append(path_modules, buf);
    e_path_user_path_set(path_modules, &(e_config->path_append_modules));
+   /* warm boots find every module without probing the dirs */
+   e_path_cache_persist(path_modules, "module_paths");
 
    /* setup background paths */
    path_backgrounds = e_path_new();
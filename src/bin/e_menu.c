@@ -20,6 +20,11 @@
  * * support obscures to indicate offscreen/not visible menu parts
  */
 
+/* menus with more items than this only realize the ones near the screen */
+#define E_MENU_VIRTUAL_ITEMS   200
+/* how many of the longest labels a virtualized menu measures for its width */
+#define E_MENU_VIRTUAL_MEASURE 8
+
 /* local subsystem data types */
 typedef struct _E_Menu_Category E_Menu_Category;
 
@@ -37,6 +42,13 @@ static void         _e_menu_realize(E_Menu *m);
 static void         _e_menu_items_layout_update(E_Menu *m);
 static void         _e_menu_item_unrealize(E_Menu_Item *mi);
 static void         _e_menu_unrealize(E_Menu *m);
+static Evas_Object *_e_menu_edje_add(E_Menu *m, const char *group, Eina_Bool *ok);
+static void         _e_menu_edje_recycle(E_Menu *m, Evas_Object **obj);
+static Evas_Coord   _e_menu_item_layout_apply(E_Menu_Item *mi);
+static void         _e_menu_item_select_signal(E_Menu_Item *mi, const char *sig);
+static void         _e_menu_virtual_measure(E_Menu *m);
+static void         _e_menu_virtual_update(E_Menu *m);
+static void         _e_menu_virtual_item_geometry_get(E_Menu_Item *mi, int *x, int *y, int *w, int *h);
 static void         _e_menu_activate_internal(E_Menu *m, E_Zone *zone);
 static void         _e_menu_deactivate_all(void);
 static void         _e_menu_deactivate_above(E_Menu *m);
@@ -1031,26 +1043,7 @@ e_menu_item_active_set(E_Menu_Item *mi, int active)
           }
         mi->active = 1;
         _e_active_menu_item = mi;
-        if (mi->bg_object)
-          edje_object_signal_emit(mi->bg_object, "e,state,selected", "e");
-        if (mi->icon_bg_object)
-          edje_object_signal_emit(mi->icon_bg_object, "e,state,selected", "e");
-        if (isedje(mi->label_object))
-          edje_object_signal_emit(mi->label_object, "e,state,selected", "e");
-        if (isedje(mi->submenu_object))
-          edje_object_signal_emit(mi->submenu_object, "e,state,selected", "e");
-        if (isedje(mi->toggle_object))
-          edje_object_signal_emit(mi->toggle_object, "e,state,selected", "e");
-        if (mi->icon_key)
-          {
-             if (mi->icon_object)
-               {
-                  if (isedje(mi->icon_object))
-                    edje_object_signal_emit(mi->icon_object, "e,state,selected", "e");
-                  else
-                    e_icon_selected_set(mi->icon_object, EINA_TRUE);
-               }
-          }
+        _e_menu_item_select_signal(mi, "e,state,selected");
         edje_object_signal_emit(mi->menu->bg_object, "e,state,selected", "e");
         _e_menu_submenu_activate(mi);
      }
@@ -1060,26 +1053,7 @@ e_menu_item_active_set(E_Menu_Item *mi, int active)
         mi->active = 0;
         _e_prev_active_menu_item = mi;
         _e_active_menu_item = NULL;
-        if (mi->bg_object)
-          edje_object_signal_emit(mi->bg_object, "e,state,unselected", "e");
-        if (mi->icon_bg_object)
-          edje_object_signal_emit(mi->icon_bg_object, "e,state,unselected", "e");
-        if (isedje(mi->label_object))
-          edje_object_signal_emit(mi->label_object, "e,state,unselected", "e");
-        if (isedje(mi->submenu_object))
-          edje_object_signal_emit(mi->submenu_object, "e,state,unselected", "e");
-        if (isedje(mi->toggle_object))
-          edje_object_signal_emit(mi->toggle_object, "e,state,unselected", "e");
-        if (mi->icon_key)
-          {
-             if (mi->icon_object)
-               {
-                  if (isedje(mi->icon_object))
-                    edje_object_signal_emit(mi->icon_object, "e,state,unselected", "e");
-                  else
-                    e_icon_selected_set(mi->icon_object, EINA_FALSE);
-               }
-          }
+        _e_menu_item_select_signal(mi, "e,state,unselected");
         edje_object_signal_emit(mi->menu->bg_object, "e,state,unselected", "e");
      }
    _e_menu_list_free_unref(tmp);
@@ -1203,6 +1177,7 @@ e_menu_idler_before(void)
              evas_object_move(m->comp_object, m->cur.x, m->cur.y);
              _e_menu_lock = 0;
           }
+        if (m->virtualized) _e_menu_virtual_update(m);
      }
    /* phase 3. show all the menus that want to be shown */
    EINA_LIST_FOREACH(_e_active_menus, l, m)
@@ -1348,6 +1323,8 @@ _e_menu_item_free(E_Menu_Item *mi)
      }
    if (mi->menu->realized) _e_menu_item_unrealize(mi);
    mi->menu->items = eina_list_remove(mi->menu->items, mi);
+   /* indexes after this item shifted, redo the window */
+   mi->menu->virt.first = mi->menu->virt.last = -1;
    if (mi->icon) eina_stringshare_del(mi->icon);
    if (mi->icon_key) eina_stringshare_del(mi->icon_key);
    if (mi->label) eina_stringshare_del(mi->label);
@@ -1422,10 +1399,8 @@ _e_menu_item_realize(E_Menu_Item *mi)
    /* and set up initial item state */
    if (mi->separator)
      {
-        o = edje_object_add(mi->menu->evas);
+        o = _e_menu_edje_add(mi->menu, "e/widgets/menu/default/separator", NULL);
         mi->separator_object = o;
-        e_theme_edje_object_set(o, "base/theme/menus",
-                                "e/widgets/menu/default/separator");
         edje_object_size_min_calc(mi->separator_object, &ww, &hh);
         E_FILL(mi->separator_object);
         mi->separator_w = ww;
@@ -1436,24 +1411,22 @@ _e_menu_item_realize(E_Menu_Item *mi)
      }
    else
      {
-        o = edje_object_add(mi->menu->evas);
+        Eina_Bool ok = EINA_FALSE;
+
+        if ((mi->submenu) || (mi->submenu_pre_cb.func))
+          {
+             o = _e_menu_edje_add(mi->menu, "e/widgets/menu/default/submenu_bg", &ok);
+             if (!ok)
+               e_theme_edje_object_set(o, "base/theme/menus",
+                                       "e/widgets/menu/default/item_bg");
+          }
+        else
+          o = _e_menu_edje_add(mi->menu, "e/widgets/menu/default/item_bg", NULL);
         mi->bg_object = o;
         evas_object_event_callback_add(o, EVAS_CALLBACK_MOUSE_IN, _e_menu_cb_item_in, mi);
         evas_object_event_callback_add(o, EVAS_CALLBACK_MOUSE_OUT, _e_menu_cb_item_out, mi);
         evas_object_intercept_move_callback_add(o, _e_menu_cb_intercept_item_move, mi);
         evas_object_intercept_resize_callback_add(o, _e_menu_cb_intercept_item_resize, mi);
-        if ((mi->submenu) || (mi->submenu_pre_cb.func))
-          {
-             if (!e_theme_edje_object_set(mi->bg_object, "base/theme/menus",
-                                          "e/widgets/menu/default/submenu_bg"))
-               goto no_submenu_item;
-          }
-        else
-          {
-no_submenu_item:
-             e_theme_edje_object_set(mi->bg_object, "base/theme/menus",
-                                     "e/widgets/menu/default/item_bg");
-          }
         o = elm_box_add(e_comp->elm);
         mi->container_object = o;
         elm_box_horizontal_set(o, 1);
@@ -1462,10 +1435,8 @@ no_submenu_item:
 
         if (mi->check)
           {
-             o = edje_object_add(mi->menu->evas);
+             o = _e_menu_edje_add(mi->menu, "e/widgets/menu/default/check", NULL);
              mi->toggle_object = o;
-             e_theme_edje_object_set(o, "base/theme/menus",
-                                     "e/widgets/menu/default/check");
              edje_object_size_min_calc(mi->toggle_object, &ww, &hh);
              mi->toggle_w = ww;
              mi->toggle_h = hh;
@@ -1477,10 +1448,8 @@ no_submenu_item:
           }
         else if (mi->radio)
           {
-             o = edje_object_add(mi->menu->evas);
+             o = _e_menu_edje_add(mi->menu, "e/widgets/menu/default/radio", NULL);
              mi->toggle_object = o;
-             e_theme_edje_object_set(o, "base/theme/menus",
-                                     "e/widgets/menu/default/radio");
              edje_object_size_min_calc(mi->toggle_object, &ww, &hh);
              mi->toggle_w = ww;
              mi->toggle_h = hh;
@@ -1500,10 +1469,10 @@ no_submenu_item:
         if ((!e_config->menu_icons_hide) && ((mi->icon) || (mi->realize_cb.func)))
           {
              int icon_w = 0, icon_h = 0;
+             Eina_Bool icon_ok = EINA_FALSE;
 
-             o = edje_object_add(mi->menu->evas);
-             if (e_theme_edje_object_set(o, "base/theme/menus",
-                                         "e/widgets/menu/default/icon"))
+             o = _e_menu_edje_add(mi->menu, "e/widgets/menu/default/icon", &icon_ok);
+             if (icon_ok)
                {
                   mi->icon_bg_object = o;
                }
@@ -1603,10 +1572,8 @@ no_submenu_item:
 
         if (mi->label)
           {
-             o = edje_object_add(mi->menu->evas);
+             o = _e_menu_edje_add(mi->menu, "e/widgets/menu/default/label", NULL);
              mi->label_object = o;
-             e_theme_edje_object_set(o, "base/theme/menus",
-                                     "e/widgets/menu/default/label");
              /* default label */
              edje_object_part_text_set(o, "e.text.label", mi->label);
              edje_object_size_min_calc(mi->label_object, &ww, &hh);
@@ -1627,10 +1594,8 @@ no_submenu_item:
           }
         if ((mi->submenu) || (mi->submenu_pre_cb.func))
           {
-             o = edje_object_add(mi->menu->evas);
+             o = _e_menu_edje_add(mi->menu, "e/widgets/menu/default/submenu", NULL);
              mi->submenu_object = o;
-             e_theme_edje_object_set(o, "base/theme/menus",
-                                     "e/widgets/menu/default/submenu");
              edje_object_size_min_calc(mi->submenu_object, &ww, &hh);
              mi->submenu_w = ww;
              mi->submenu_h = hh;
@@ -1655,7 +1620,8 @@ no_submenu_item:
         evas_object_show(mi->container_object);
         evas_object_show(mi->bg_object);
      }
-   if (mi->active) e_menu_item_active_set(mi, 1);
+   /* objects may come from the pool, so set the state rather than toggle it */
+   if (mi->active) _e_menu_item_select_signal(mi, "e,state,selected");
    if (mi->toggle) e_menu_item_toggle_set(mi, 1);
    if (mi->disable) e_menu_item_disabled_set(mi, 1);
 }
@@ -1697,8 +1663,25 @@ _e_menu_realize(E_Menu *m)
    evas_object_intercept_move_callback_add(o, _e_menu_cb_intercept_container_move, m);
    evas_object_intercept_resize_callback_add(o, _e_menu_cb_intercept_container_resize, m);
 
-   EINA_LIST_FOREACH(m->items, l, mi)
-     _e_menu_item_realize(mi);
+   m->virtualized = (eina_list_count(m->items) > E_MENU_VIRTUAL_ITEMS);
+   if (m->virtualized)
+     {
+        m->virt.pool = eina_hash_string_superfast_new(NULL);
+        o = evas_object_rectangle_add(m->evas);
+        m->virt.top = o;
+        evas_object_color_set(o, 0, 0, 0, 0);
+        evas_object_pass_events_set(o, 1);
+        o = evas_object_rectangle_add(m->evas);
+        m->virt.bottom = o;
+        evas_object_color_set(o, 0, 0, 0, 0);
+        evas_object_pass_events_set(o, 1);
+        _e_menu_virtual_measure(m);
+     }
+   else
+     {
+        EINA_LIST_FOREACH(m->items, l, mi)
+          _e_menu_item_realize(mi);
+     }
 
    edje_object_part_swallow(m->bg_object, "e.swallow.content", m->container_object);
 
@@ -1725,7 +1708,7 @@ _e_menu_items_layout_update(E_Menu *m)
    int min_submenu_w = 0, min_submenu_h = 0;
    int min_toggle_w = 0, min_toggle_h = 0;
    int min_w = 0, min_h = 1;
-   int zh = 0, ms = 0, maxh = 0;
+   int zh = 0, maxh = 0;
    unsigned int cur_items = 0, max_items = -1;
 
    if (!m->zone) return;
@@ -1793,6 +1776,20 @@ _e_menu_items_layout_update(E_Menu *m)
         min_w = min_toggle_w + min_submenu_w;
         min_h = min_toggle_h;
      }
+   m->layout.toggle_w = min_toggle_w;
+   m->layout.toggle_h = min_toggle_h;
+   m->layout.icon_w = min_icon_w;
+   m->layout.icon_h = min_icon_h;
+   m->layout.label_w = min_label_w;
+   m->layout.label_h = min_label_h;
+   m->layout.submenu_w = min_submenu_w;
+   m->layout.submenu_h = min_submenu_h;
+   m->layout.w = min_w;
+   m->layout.h = min_h;
+   m->layout.toggles = toggles_on;
+   m->layout.icons = icons_on;
+   m->layout.labels = labels_on;
+   m->layout.submenus = submenus_on;
    if (min_h * eina_list_count(m->items) >= (unsigned int)m->zone->h)
      {
         e_zone_useful_geometry_get(m->zone, NULL, NULL, NULL, &zh);
@@ -1800,61 +1797,376 @@ _e_menu_items_layout_update(E_Menu *m)
         if (maxh > 30000) maxh = 30000;  // 32k x 32k mx coord limit for wins
         max_items = (maxh / min_h) - 1;
      }
-   EINA_LIST_FOREACH(m->items, l, mi)
+   m->virt.max_items = max_items;
+   if (m->virtualized)
      {
-        if (cur_items >= max_items)
+        /* only the measuring items are realized yet */
+        EINA_LIST_FOREACH(m->items, l, mi)
           {
-             _e_menu_item_unrealize(mi);
-             continue;
+             if ((!mi->bg_object) && (!mi->separator_object)) continue;
+             mh = _e_menu_item_layout_apply(mi);
+             if (mi->separator) m->virt.separator_h = mh;
+             else if ((mi->submenu) || (mi->submenu_pre_cb.func))
+               m->virt.submenu_h = mh;
+             else m->virt.item_h = mh;
           }
-        cur_items++;
+        if (!m->virt.item_h) m->virt.item_h = m->virt.submenu_h;
+        if (!m->virt.submenu_h) m->virt.submenu_h = m->virt.item_h;
+        m->virt.first = m->virt.last = -1;
+        _e_menu_virtual_update(m);
+     }
+   else
+     {
+        EINA_LIST_FOREACH(m->items, l, mi)
+          {
+             if (cur_items >= max_items)
+               {
+                  _e_menu_item_unrealize(mi);
+                  continue;
+               }
+             cur_items++;
+             _e_menu_item_layout_apply(mi);
+          }
+     }
+   elm_box_recalculate(m->container_object);
+   evas_object_size_hint_min_get(m->container_object, &bw, &bh);
+   evas_object_size_hint_max_set(m->container_object, bw, bh);
+   edje_object_size_min_calc(m->bg_object, &mw, &mh);
+   m->cur.w = mw;
+   m->cur.h = mh;
+}
+
+/* set the hints worked out by _e_menu_items_layout_update on one item,
+ * returns the height it takes in the menu */
+static Evas_Coord
+_e_menu_item_layout_apply(E_Menu_Item *mi)
+{
+   E_Menu *m = mi->menu;
+   Evas_Coord mw = 0, mh = 0;
+
+   if (mi->separator)
+     {
+        E_WEIGHT(mi->separator_object, 1, 0);
+        E_FILL(mi->separator_object);
+        evas_object_size_hint_min_set(mi->separator_object, mi->separator_w, mi->separator_h);
+        evas_object_size_hint_max_set(mi->separator_object, -1, mi->separator_h);
+        return mi->separator_h;
+     }
+   E_WEIGHT(mi->toggle_object, 0, m->layout.toggles);
+   E_FILL(mi->toggle_object);
+   evas_object_size_hint_min_set(mi->toggle_object, m->layout.toggle_w * m->layout.toggles, m->layout.toggle_h * m->layout.toggles);
+   if (m->layout.icons)
+     {
+        E_WEIGHT(mi->icon_bg_object ?: mi->icon_object, 0, 1);
+        E_FILL(mi->icon_bg_object ?: mi->icon_object);
+        evas_object_size_hint_min_set(mi->icon_bg_object ?: mi->icon_object, m->layout.icon_w, m->layout.icon_h);
+     }
+   else
+     {
+        E_WEIGHT(mi->icon_object, 0, 1);
+        E_FILL(mi->icon_object);
+        evas_object_size_hint_min_set(mi->icon_object, 0, 0);
+     }
+
+   E_WEIGHT(mi->label_object, 0, 1 * m->layout.labels);
+   E_FILL(mi->label_object);
+   evas_object_size_hint_min_set(mi->label_object, m->layout.label_w * m->layout.labels, m->layout.label_h * m->layout.labels);
+
+   E_WEIGHT(mi->submenu_object, 0, 1 * m->layout.submenus);
+   E_FILL(mi->submenu_object);
+   evas_object_size_hint_min_set(mi->submenu_object, m->layout.submenu_w * m->layout.submenus, m->layout.submenu_h * m->layout.submenus);
+
+   evas_object_size_hint_min_set(mi->container_object,
+                                 m->layout.w, m->layout.h);
+   edje_object_size_min_calc(mi->bg_object, &mw, &mh);
+   E_WEIGHT(mi->bg_object, 0, 1);
+   E_FILL(mi->bg_object);
+   evas_object_size_hint_min_set(mi->bg_object, mw, mh);
+   return mh;
+}
+
+static void
+_e_menu_item_select_signal(E_Menu_Item *mi, const char *sig)
+{
+   if (mi->bg_object)
+     edje_object_signal_emit(mi->bg_object, sig, "e");
+   if (mi->icon_bg_object)
+     edje_object_signal_emit(mi->icon_bg_object, sig, "e");
+   if (isedje(mi->label_object))
+     edje_object_signal_emit(mi->label_object, sig, "e");
+   if (isedje(mi->submenu_object))
+     edje_object_signal_emit(mi->submenu_object, sig, "e");
+   if (isedje(mi->toggle_object))
+     edje_object_signal_emit(mi->toggle_object, sig, "e");
+   if ((mi->icon_key) && (mi->icon_object))
+     {
+        if (isedje(mi->icon_object))
+          edje_object_signal_emit(mi->icon_object, sig, "e");
+        else
+          e_icon_selected_set(mi->icon_object, !strcmp(sig, "e,state,selected"));
+     }
+}
+
+/* theme edje objects of virtualized menus go back to a per group pool when
+ * their item scrolls away, so realizing the next item only swaps contents */
+static Evas_Object *
+_e_menu_edje_add(E_Menu *m, const char *group, Eina_Bool *ok)
+{
+   Evas_Object *o;
+   Eina_List *l = NULL;
+
+   if (ok) *ok = EINA_TRUE;
+   if (m->virt.pool) l = eina_hash_find(m->virt.pool, group);
+   if (l)
+     {
+        o = eina_list_data_get(l);
+        l = eina_list_remove_list(l, l);
+        if (l) eina_hash_modify(m->virt.pool, group, l);
+        else eina_hash_del_by_key(m->virt.pool, group);
+        return o;
+     }
+
+   o = edje_object_add(m->evas);
+   if (!e_theme_edje_object_set(o, "base/theme/menus", group))
+     {
+        /* not poolable, the caller may still set another group on it */
+        if (ok) *ok = EINA_FALSE;
+        return o;
+     }
+   if (m->virtualized) evas_object_data_set(o, "e_menu_group", group);
+   return o;
+}
+
+static void
+_e_menu_edje_recycle(E_Menu *m, Evas_Object **obj)
+{
+   Evas_Object *o = *obj;
+   const char *group;
+   Eina_List *l;
+
+   if (!o) return;
+   *obj = NULL;
+   group = evas_object_data_get(o, "e_menu_group");
+   if ((!group) || (!m->virt.pool))
+     {
+        evas_object_del(o);
+        return;
+     }
+   evas_object_hide(o);
+   edje_object_signal_emit(o, "e,state,unselected", "e");
+   edje_object_signal_emit(o, "e,state,off", "e");
+   edje_object_signal_emit(o, "e,state,enable", "e");
+   l = eina_hash_find(m->virt.pool, group);
+   if (l) eina_hash_modify(m->virt.pool, group, eina_list_prepend(l, o));
+   else eina_hash_add(m->virt.pool, group, eina_list_append(NULL, o));
+}
+
+static Eina_Bool
+_e_menu_edje_pool_free_cb(const Eina_Hash *hash EINA_UNUSED, const void *key EINA_UNUSED, void *data, void *fdata EINA_UNUSED)
+{
+   Eina_List *l = data;
+   Evas_Object *o;
+
+   EINA_LIST_FREE(l, o)
+     evas_object_del(o);
+   return EINA_TRUE;
+}
+
+/* unrealize an item of a virtualized menu, keeping its theme objects.
+ * the caller has already unpacked it from the menu */
+static void
+_e_menu_item_recycle(E_Menu_Item *mi)
+{
+   E_Menu *m = mi->menu;
+
+   if (mi->bg_object)
+     {
+        evas_object_event_callback_del_full(mi->bg_object, EVAS_CALLBACK_MOUSE_IN, _e_menu_cb_item_in, mi);
+        evas_object_event_callback_del_full(mi->bg_object, EVAS_CALLBACK_MOUSE_OUT, _e_menu_cb_item_out, mi);
+        evas_object_intercept_move_callback_del(mi->bg_object, _e_menu_cb_intercept_item_move);
+        evas_object_intercept_resize_callback_del(mi->bg_object, _e_menu_cb_intercept_item_resize);
+        if (mi->container_object)
+          edje_object_part_unswallow(mi->bg_object, mi->container_object);
+     }
+   if ((mi->icon_bg_object) && (mi->icon_object))
+     edje_object_part_unswallow(mi->icon_bg_object, mi->icon_object);
+   if (mi->container_object)
+     elm_box_unpack_all(mi->container_object);
+   _e_menu_edje_recycle(m, &mi->separator_object);
+   _e_menu_edje_recycle(m, &mi->bg_object);
+   _e_menu_edje_recycle(m, &mi->toggle_object);
+   _e_menu_edje_recycle(m, &mi->icon_bg_object);
+   _e_menu_edje_recycle(m, &mi->label_object);
+   _e_menu_edje_recycle(m, &mi->submenu_object);
+   _e_menu_item_unrealize(mi);
+}
+
+/* realize one item of each kind to get the theme's sizes, and measure the
+ * longest labels with a spare label object instead of realizing them all */
+static void
+_e_menu_virtual_measure(E_Menu *m)
+{
+   E_Menu_Item *mi, *sep = NULL, *item = NULL, *sub = NULL;
+   E_Menu_Item *longest[E_MENU_VIRTUAL_MEASURE] = { NULL };
+   int lens[E_MENU_VIRTUAL_MEASURE] = { 0 };
+   Evas_Object *o;
+   Evas_Coord ww, hh;
+   Eina_List *l;
+   int i, j, len;
+
+   EINA_LIST_FOREACH(m->items, l, mi)
+     {
         if (mi->separator)
           {
-             E_WEIGHT(mi->separator_object, 1, 0);
-             E_FILL(mi->separator_object);
-             evas_object_size_hint_min_set(mi->separator_object, mi->separator_w, mi->separator_h);
-             evas_object_size_hint_max_set(mi->separator_object, -1, mi->separator_h);
-             ms += mi->separator_h;
+             if (!sep) sep = mi;
              continue;
           }
-        E_WEIGHT(mi->toggle_object, 0, toggles_on);
-        E_FILL(mi->toggle_object);
-        evas_object_size_hint_min_set(mi->toggle_object, min_toggle_w * toggles_on, min_toggle_h * toggles_on);
-        if (icons_on)
+        if ((mi->submenu) || (mi->submenu_pre_cb.func))
           {
-             E_WEIGHT(mi->icon_bg_object ?: mi->icon_object, 0, 1);
-             E_FILL(mi->icon_bg_object ?: mi->icon_object);
-             evas_object_size_hint_min_set(mi->icon_bg_object ?: mi->icon_object, min_icon_w, min_icon_h);
+             if (!sub) sub = mi;
           }
+        else if (!item) item = mi;
+        if (!mi->label) continue;
+
+        len = eina_unicode_utf8_get_len(mi->label);
+        for (i = 0; i < E_MENU_VIRTUAL_MEASURE; i++)
+          if (len > lens[i]) break;
+        if (i == E_MENU_VIRTUAL_MEASURE) continue;
+        for (j = E_MENU_VIRTUAL_MEASURE - 1; j > i; j--)
+          {
+             lens[j] = lens[j - 1];
+             longest[j] = longest[j - 1];
+          }
+        lens[i] = len;
+        longest[i] = mi;
+     }
+   if (sep) _e_menu_item_realize(sep);
+   if (item) _e_menu_item_realize(item);
+   if (sub) _e_menu_item_realize(sub);
+
+   o = _e_menu_edje_add(m, "e/widgets/menu/default/label", NULL);
+   for (i = 0; (i < E_MENU_VIRTUAL_MEASURE) && (longest[i]); i++)
+     {
+        if (longest[i]->label_object) continue;
+        edje_object_part_text_set(o, "e.text.label", longest[i]->label);
+        edje_object_size_min_calc(o, &ww, &hh);
+        longest[i]->label_w = ww;
+        longest[i]->label_h = hh;
+     }
+   _e_menu_edje_recycle(m, &o);
+}
+
+static Evas_Coord
+_e_menu_virtual_item_h(const E_Menu *m, const E_Menu_Item *mi)
+{
+   if (mi->separator) return m->virt.separator_h;
+   if ((mi->submenu) || (mi->submenu_pre_cb.func)) return m->virt.submenu_h;
+   return m->virt.item_h;
+}
+
+/* where the item list starts inside the menu */
+static Evas_Coord
+_e_menu_virtual_offset_get(E_Menu *m)
+{
+   Evas_Coord y = 0;
+
+   if (!m->container_h) return 0;
+   evas_object_geometry_get(m->bg_object, NULL, &y, NULL, NULL);
+   if (m->container_y < y) return 0;
+   return m->container_y - y;
+}
+
+/* keep the items within half a screen of the visible part realized and let
+ * two spacers stand in for everything above and below them */
+static void
+_e_menu_virtual_update(E_Menu *m)
+{
+   E_Menu_Item *mi;
+   Eina_List *l;
+   Evas_Coord top, bottom, y = 0, h, above = 0, below = 0;
+   int i = 0, first = -1, last = -1;
+
+   if ((!m->zone) || (!m->container_object)) return;
+   top = m->cur.y + _e_menu_virtual_offset_get(m);
+   if ((m->virt.first >= 0) && (top == m->virt.y)) return;
+   m->virt.y = top;
+
+   top = m->zone->y - top - (m->zone->h / 2);
+   bottom = top + (m->zone->h * 2);
+   EINA_LIST_FOREACH(m->items, l, mi)
+     {
+        if ((unsigned int)i >= m->virt.max_items) break;
+        h = _e_menu_virtual_item_h(m, mi);
+        if (y + h <= top) above += h;
+        else if (y >= bottom) below += h;
         else
           {
-             E_WEIGHT(mi->icon_object, 0, 1);
-             E_FILL(mi->icon_object);
-             evas_object_size_hint_min_set(mi->icon_object, 0, 0);
+             if (first < 0) first = i;
+             last = i;
           }
+        y += h;
+        i++;
+     }
+   /* always realize something so the menu keeps its width */
+   if (first < 0) first = last = 0;
+   if ((first == m->virt.first) && (last == m->virt.last)) return;
+   m->virt.first = first;
+   m->virt.last = last;
 
-        E_WEIGHT(mi->label_object, 0, 1 * labels_on);
-        E_FILL(mi->label_object);
-        evas_object_size_hint_min_set(mi->label_object, min_label_w * labels_on, min_label_h * labels_on);
+   evas_event_freeze(m->evas);
+   elm_box_unpack_all(m->container_object);
+   /* recycle first so the items coming in can reuse the objects */
+   i = 0;
+   EINA_LIST_FOREACH(m->items, l, mi)
+     {
+        if (((i < first) || (i > last)) &&
+            ((mi->bg_object) || (mi->separator_object)))
+          _e_menu_item_recycle(mi);
+        i++;
+     }
 
-        E_WEIGHT(mi->submenu_object, 0, 1 * submenus_on);
-        E_FILL(mi->submenu_object);
-        evas_object_size_hint_min_set(mi->submenu_object, min_submenu_w * submenus_on, min_submenu_h * submenus_on);
+   evas_object_size_hint_min_set(m->virt.top, 0, above);
+   elm_box_pack_end(m->container_object, m->virt.top);
+   evas_object_show(m->virt.top);
+   i = 0;
+   EINA_LIST_FOREACH(m->items, l, mi)
+     {
+        if (i > last) break;
+        if (i++ < first) continue;
+        if (mi->separator_object)
+          elm_box_pack_end(m->container_object, mi->separator_object);
+        else if (mi->bg_object)
+          elm_box_pack_end(m->container_object, mi->bg_object);
+        else
+          {
+             _e_menu_item_realize(mi);
+             _e_menu_item_layout_apply(mi);
+          }
+     }
+   evas_object_size_hint_min_set(m->virt.bottom, 0, below);
+   elm_box_pack_end(m->container_object, m->virt.bottom);
+   evas_object_show(m->virt.bottom);
+   evas_event_thaw(m->evas);
+}
 
-        evas_object_size_hint_min_set(mi->container_object,
-                                        min_w, min_h);
-        edje_object_size_min_calc(mi->bg_object, &mw, &mh);
-        E_WEIGHT(mi->bg_object, 0, 1);
-        E_FILL(mi->bg_object);
-        evas_object_size_hint_min_set(mi->bg_object, mw, mh);
-        ms += mh;
+static void
+_e_menu_virtual_item_geometry_get(E_Menu_Item *mi, int *x, int *y, int *w, int *h)
+{
+   E_Menu *m = mi->menu;
+   E_Menu_Item *mi2;
+   Eina_List *l;
+   Evas_Coord yy;
+
+   yy = m->cur.y + _e_menu_virtual_offset_get(m);
+   EINA_LIST_FOREACH(m->items, l, mi2)
+     {
+        if (mi2 == mi) break;
+        yy += _e_menu_virtual_item_h(m, mi2);
      }
-   elm_box_recalculate(m->container_object);
-   evas_object_size_hint_min_get(m->container_object, &bw, &bh);
-   evas_object_size_hint_max_set(m->container_object, bw, bh);
-   edje_object_size_min_calc(m->bg_object, &mw, &mh);
-   m->cur.w = mw;
-   m->cur.h = mh;
+   *x = m->cur.x;
+   *y = yy;
+   *w = m->cur.w;
+   *h = _e_menu_virtual_item_h(m, mi);
 }
 
 static void
@@ -1907,6 +2219,14 @@ _e_menu_unrealize(E_Menu *m)
    if (stopping && m->comp_object) evas_object_unref(m->comp_object);
    EINA_LIST_FOREACH(m->items, l, mi)
      _e_menu_item_unrealize(mi);
+   if (m->virt.pool)
+     {
+        eina_hash_foreach(m->virt.pool, _e_menu_edje_pool_free_cb, NULL);
+        E_FREE_FUNC(m->virt.pool, eina_hash_free);
+     }
+   E_FREE_FUNC(m->virt.top, evas_object_del);
+   E_FREE_FUNC(m->virt.bottom, evas_object_del);
+   m->virtualized = 0;
    E_FREE_FUNC(m->header.icon, evas_object_del);
    E_FREE_FUNC(m->bg_object, evas_object_del);
    E_FREE_FUNC(m->container_object, evas_object_del);
@@ -2586,7 +2906,10 @@ _e_menu_item_ensure_onscreen(E_Menu_Item *mi)
 
    if (!mi->menu) return;
    if (!mi->menu->zone) return;
-   evas_object_geometry_get(mi->container_object, &x, &y, &w, &h);
+   if ((!mi->container_object) && (mi->menu->virtualized))
+     _e_menu_virtual_item_geometry_get(mi, &x, &y, &w, &h);
+   else
+     evas_object_geometry_get(mi->container_object, &x, &y, &w, &h);
    if ((x + w) > (mi->menu->zone->x + mi->menu->zone->w))
      dx = (mi->menu->zone->x + mi->menu->zone->w) - (x + w);
    else if (x < mi->menu->zone->x)
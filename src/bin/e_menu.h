@@ -59,6 +59,29 @@ struct _E_Menu
    Evas_Object         *container_object;
    Evas_Coord           container_x, container_y, container_w, container_h;
 
+   /* sizes shared by every item, worked out in _e_menu_items_layout_update */
+   struct {
+      int               toggle_w, toggle_h;
+      int               icon_w, icon_h;
+      int               label_w, label_h;
+      int               submenu_w, submenu_h;
+      int               w, h;
+      Eina_Bool         toggles E_BITFIELD;
+      Eina_Bool         icons E_BITFIELD;
+      Eina_Bool         labels E_BITFIELD;
+      Eina_Bool         submenus E_BITFIELD;
+   } layout;
+
+   /* big menus only realize the items around the visible part */
+   struct {
+      Eina_Hash        *pool; /* theme group -> unused edje objects */
+      Evas_Object      *top, *bottom; /* spacers for the unrealized items */
+      Evas_Coord        item_h, submenu_h, separator_h;
+      Evas_Coord        y; /* menu content position the window was made for */
+      int               first, last; /* realized items, as list indexes */
+      unsigned int      max_items;
+   } virt;
+
    struct {
       void *data;
       void (*func) (void *data, E_Menu *m);
@@ -72,6 +95,7 @@ struct _E_Menu
    Eina_Bool        have_submenu E_BITFIELD;
    Eina_Bool        in_active_list E_BITFIELD;
    Eina_Bool        hold_mode E_BITFIELD;
+   Eina_Bool        virtualized E_BITFIELD; /* 1 if only part of the items are realized */
 };
 
 struct _E_Menu_Item
@@ -7,6 +7,28 @@
  *
  */
 
+/* a module being loaded by e_module_all_load() */
+typedef struct _E_Module_Load E_Module_Load;
+
+struct _E_Module_Load
+{
+   const char  *name;
+   char         buf[PATH_MAX];
+   const char  *modpath;
+   void        *handle;
+   char        *err;
+   E_Module    *module;
+   Eina_Bool    deferred E_BITFIELD;
+   Eina_Bool    visiting E_BITFIELD;
+   Eina_Bool    done E_BITFIELD;
+};
+
+typedef struct _E_Module_Loader
+{
+   E_Module_Load *loads;
+   unsigned int   count;
+} E_Module_Loader;
+
 /* local subsystem functions */
 static void      _e_module_free(E_Module *m);
 static void      _e_module_dialog_disable_create(const char *title, const char *body, E_Module *m);
@@ -14,6 +36,14 @@ static void      _e_module_cb_dialog_disable(void *data, E_Dialog *dia);
 static void      _e_module_event_update_free(void *data, void *event);
 static int       _e_module_sort_name(const void *d1, const void *d2);
 static void      _e_module_whitelist_check(void);
+static E_Module *_e_module_setup(const char *name, const char *buf, const char *modpath, void *handle, const char *err);
+static void      _e_module_deferred_cb_render_post(void *data, Evas *e, void *event_info);
+static Eina_Bool _e_module_deferred_cb_idler(void *data);
+
+static void      _e_module_load_resolve(E_Module_Load *ld, const char *name);
+static void      _e_module_load_open(E_Module_Load *ld);
+static void      _e_module_load_setup(E_Module_Load *ld);
+static void      _e_module_load_enable(E_Module_Loader *loader, E_Module_Load *ld, Eina_Bool force, Eina_List **defer);
 
 /* local subsystem globals */
 static Eina_List *_e_modules = NULL;
@@ -23,6 +53,11 @@ static Eina_Bool _e_modules_init_end = EINA_FALSE;
 
 static Eina_Hash *_e_module_path_hash = NULL;
 
+/* modules waiting for the first frame before they are initialized */
+static Eina_List *_e_modules_deferred = NULL;
+static Ecore_Idler *_e_modules_deferred_idler = NULL;
+static Eina_Bool _e_modules_deferred_render_cb = EINA_FALSE;
+
 E_API int E_EVENT_MODULE_UPDATE = 0;
 E_API int E_EVENT_MODULE_INIT_END = 0;
 
@@ -42,6 +77,26 @@ _module_is_nosave(const char *name)
    return !strncmp(name, "wl_", 3); //block wl_* modules from being saved
 }
 
+/* modules nothing else waits on; they are initialized after the first
+ * frame is shown so they don't hold up startup. out of tree modules can
+ * ask for the same by exporting a non-zero "int e_modapi_deferred". */
+static Eina_Bool
+_module_is_deferred(const char *name)
+{
+   const char *list[] =
+   {
+      "geolocation",
+      "music-control",
+      "packagekit",
+      "procstats",
+   };
+   unsigned int i;
+
+   for (i = 0; i < EINA_C_ARRAY_LENGTH(list); i++)
+     if (eina_streq(name, list[i])) return EINA_TRUE;
+   return EINA_FALSE;
+}
+
 static Eina_Bool
 _module_is_important(const char *name)
 {
@@ -88,6 +143,13 @@ e_module_shutdown(void)
    VALGRIND_DO_LEAK_CHECK
 #endif
 
+   E_FREE_FUNC(_e_modules_deferred_idler, ecore_idler_del);
+   if (_e_modules_deferred_render_cb && e_comp && e_comp->evas)
+     evas_event_callback_del(e_comp->evas, EVAS_CALLBACK_RENDER_POST,
+                             _e_module_deferred_cb_render_post);
+   _e_modules_deferred_render_cb = EINA_FALSE;
+   E_FREE_LIST(_e_modules_deferred, e_object_unref);
+
    /* do not use EINA_LIST_FREE! e_object_del modifies list */
    if (x_fatal)
      e_module_save_all();
@@ -117,7 +179,8 @@ e_module_all_load(void)
 {
    Eina_List *l, *ll;
    E_Config_Module *em, *em2;
-   char buf[128];
+   E_Module_Loader loader;
+   unsigned int i;
 
    _e_modules_initting = EINA_TRUE;
 
@@ -138,6 +201,8 @@ e_module_all_load(void)
           }
      }
 
+   memset(&loader, 0, sizeof(loader));
+   loader.loads = calloc(eina_list_count(e_config->modules) + 1, sizeof(E_Module_Load));
    EINA_LIST_FOREACH_SAFE(e_config->modules, l, ll, em)
      {
         if ((!em) || (!em->name)) continue;
@@ -149,25 +214,54 @@ e_module_all_load(void)
              free(em);
              continue;
           }
-        if (em->enabled)
-          {
-             E_Module *m;
-
-             if (eina_hash_find(_e_modules_hash, em->name)) continue;
-
-             e_util_env_set("E_MODULE_LOAD", em->name);
-             snprintf(buf, sizeof(buf), _("Loading Module: %s"), em->name);
+        if ((!em->enabled) || (!loader.loads)) continue;
+        if (eina_hash_find(_e_modules_hash, em->name)) continue;
+        _e_module_load_resolve(&loader.loads[loader.count++], em->name);
+     }
 
-             m = e_module_new(em->name);
-             if (m) e_module_enable(m);
-          }
+   /* dlopen() everything, then create the modules and run their init in
+    * dependency order. dlopen() stays on the main loop, one at a time:
+    * E_MODULE_LOAD has to name the module whose constructors are running
+    * so a crash in them gets it disabled on restart, and glibc serializes
+    * dlopen() anyway */
+   if (loader.count)
+     {
+        for (i = 0; i < loader.count; i++)
+          _e_module_load_open(&loader.loads[i]);
+        for (i = 0; i < loader.count; i++)
+          _e_module_load_setup(&loader.loads[i]);
+        for (i = 0; i < loader.count; i++)
+          _e_module_load_enable(&loader, &loader.loads[i], EINA_FALSE, NULL);
+        /* whatever is left is deferred, queued in the same order */
+        for (i = 0; i < loader.count; i++)
+          _e_module_load_enable(&loader, &loader.loads[i], EINA_TRUE,
+                                &_e_modules_deferred);
+     }
+   for (i = 0; i < loader.count; i++)
+     {
+        eina_stringshare_del(loader.loads[i].name);
+        eina_stringshare_del(loader.loads[i].modpath);
+        free(loader.loads[i].err);
      }
+   free(loader.loads);
+
    ecore_event_add(E_EVENT_MODULE_INIT_END, NULL, NULL, NULL);
+   e_path_cache_save(path_modules);
    _e_modules_init_end = EINA_TRUE;
    _e_modules_initting = EINA_FALSE;
    _e_module_whitelist_check();
 
    unsetenv("E_MODULE_LOAD");
+
+   if (!_e_modules_deferred) return;
+   if (e_comp && e_comp->evas)
+     {
+        evas_event_callback_add(e_comp->evas, EVAS_CALLBACK_RENDER_POST,
+                                _e_module_deferred_cb_render_post, NULL);
+        _e_modules_deferred_render_cb = EINA_TRUE;
+     }
+   else
+     _e_modules_deferred_idler = ecore_idler_add(_e_module_deferred_cb_idler, NULL);
 }
 
 E_API Eina_Bool
@@ -180,16 +274,13 @@ E_API E_Module *
 e_module_new(const char *name)
 {
    E_Module *m;
-   char buf[PATH_MAX];
-   char body[PATH_MAX + 256], title[1024];
+   char buf[PATH_MAX] = "";
    const char *modpath = NULL;
-   char *s;
-   int in_list = 0;
+   void *handle = NULL;
 
    if (!name) return NULL;
    if (eina_hash_find(_e_modules_hash, name)) return NULL;
 
-   m = E_OBJECT_ALLOC(E_Module, E_MODULE_TYPE, _e_module_free);
    if (name[0] != '/')
      {
         snprintf(buf, sizeof(buf), "%s/%s/module.so", name, MODULE_ARCH);
@@ -197,114 +288,8 @@ e_module_new(const char *name)
      }
    else if (eina_str_has_extension(name, ".so"))
      modpath = eina_stringshare_add(name);
-   if (!modpath)
-     {
-        snprintf(body, sizeof(body),
-                 _("There was an error loading the module named: %s<ps/>"
-                   "No module named %s could be found in the<ps/>"
-                   "module search directories.<ps/>"), name, buf);
-        _e_module_dialog_disable_create(_("Error loading Module"), body, m);
-        m->error = 1;
-        goto init_done;
-     }
-   m->handle = dlopen(modpath, (RTLD_NOW | RTLD_LOCAL));
-   if (!m->handle)
-     {
-        snprintf(body, sizeof(body),
-                 _("There was an error loading the module named: %s<ps/>"
-                   "The full path to this module is:<ps/>"
-                   "%s<ps/>"
-                   "The error reported was:<ps/>"
-                   "%s<ps/>"), name, buf, dlerror());
-        _e_module_dialog_disable_create(_("Error loading Module"), body, m);
-        m->error = 1;
-        goto init_done;
-     }
-   m->file = eina_stringshare_ref(modpath);
-   m->api = dlsym(m->handle, "e_modapi");
-   m->func.init = dlsym(m->handle, "e_modapi_init");
-   m->func.shutdown = dlsym(m->handle, "e_modapi_shutdown");
-   m->func.save = dlsym(m->handle, "e_modapi_save");
-
-   if ((!m->func.init) || (!m->api))
-     {
-        snprintf(body, sizeof(body),
-                 _("There was an error loading the module named: %s<ps/>"
-                   "The full path to this module is:<ps/>"
-                   "%s<ps/>"
-                   "The error reported was:<ps/>"
-                   "%s<ps/>"),
-                 name, buf, _("Module does not contain all needed functions"));
-        _e_module_dialog_disable_create(_("Error loading Module"), body, m);
-        m->api = NULL;
-        m->func.init = NULL;
-        m->func.shutdown = NULL;
-        m->func.save = NULL;
-
-        dlclose(m->handle);
-        m->handle = NULL;
-        m->error = 1;
-        goto init_done;
-     }
-   if (m->api->version != E_MODULE_API_VERSION)
-     {
-        snprintf(body, sizeof(body),
-                 _("Module API Error<ps/>Error initializing Module: %s<ps/>"
-                   "It requires a module API version of: %i.<ps/>"
-                   "The module API advertized by Enlightenment is: %i.<ps/>"),
-                 _(m->api->name), m->api->version, E_MODULE_API_VERSION);
-
-        snprintf(title, sizeof(title), _("Enlightenment %s Module"),
-                 _(m->api->name));
-
-        _e_module_dialog_disable_create(title, body, m);
-        m->api = NULL;
-        m->func.init = NULL;
-        m->func.shutdown = NULL;
-        m->func.save = NULL;
-        dlclose(m->handle);
-        m->handle = NULL;
-        m->error = 1;
-        goto init_done;
-     }
-
-init_done:
-
-   _e_modules = eina_list_append(_e_modules, m);
-   if (!_e_modules_hash)
-     {
-        /* wayland module preloading */
-        if (!e_module_init())
-          CRI("WTFFFFF");
-     }
-   eina_hash_add(_e_modules_hash, name, m);
-   m->name = eina_stringshare_add(name);
-   if (modpath)
-     {
-        s = ecore_file_dir_get(modpath);
-        if (s)
-          {
-             char *s2;
-
-             s2 = ecore_file_dir_get(s);
-             free(s);
-             if (s2)
-               {
-                  m->dir = eina_stringshare_add(s2);
-                  free(s2);
-               }
-          }
-     }
-   if (!in_list)
-     {
-        E_Config_Module *module;
-
-        module = E_NEW(E_Config_Module, 1);
-        module->name = eina_stringshare_add(m->name);
-        module->enabled = 0;
-        e_config->modules = eina_list_append(e_config->modules, module);
-        e_config_save_queue();
-     }
+   if (modpath) handle = dlopen(modpath, (RTLD_NOW | RTLD_LOCAL));
+   m = _e_module_setup(name, buf, modpath, handle, handle ? NULL : dlerror());
    if (modpath) eina_stringshare_del(modpath);
    return m;
 }
@@ -538,6 +523,243 @@ e_module_desktop_free(E_Module_Desktop *md)
 
 /* local subsystem functions */
 
+/* the part of loading a module that has to happen on the main loop, given
+ * the path it resolved to and what dlopen() made of it */
+static E_Module *
+_e_module_setup(const char *name, const char *buf, const char *modpath, void *handle, const char *err)
+{
+   E_Module *m;
+   char body[PATH_MAX + 256], title[1024];
+   char *s;
+   int in_list = 0;
+
+   m = E_OBJECT_ALLOC(E_Module, E_MODULE_TYPE, _e_module_free);
+   if (!modpath)
+     {
+        snprintf(body, sizeof(body),
+                 _("There was an error loading the module named: %s<ps/>"
+                   "No module named %s could be found in the<ps/>"
+                   "module search directories.<ps/>"), name, buf);
+        _e_module_dialog_disable_create(_("Error loading Module"), body, m);
+        m->error = 1;
+        goto init_done;
+     }
+   m->handle = handle;
+   if (!m->handle)
+     {
+        snprintf(body, sizeof(body),
+                 _("There was an error loading the module named: %s<ps/>"
+                   "The full path to this module is:<ps/>"
+                   "%s<ps/>"
+                   "The error reported was:<ps/>"
+                   "%s<ps/>"), name, buf, err ? err : "");
+        _e_module_dialog_disable_create(_("Error loading Module"), body, m);
+        m->error = 1;
+        goto init_done;
+     }
+   m->file = eina_stringshare_ref(modpath);
+   m->api = dlsym(m->handle, "e_modapi");
+   m->func.init = dlsym(m->handle, "e_modapi_init");
+   m->func.shutdown = dlsym(m->handle, "e_modapi_shutdown");
+   m->func.save = dlsym(m->handle, "e_modapi_save");
+
+   if ((!m->func.init) || (!m->api))
+     {
+        snprintf(body, sizeof(body),
+                 _("There was an error loading the module named: %s<ps/>"
+                   "The full path to this module is:<ps/>"
+                   "%s<ps/>"
+                   "The error reported was:<ps/>"
+                   "%s<ps/>"),
+                 name, buf, _("Module does not contain all needed functions"));
+        _e_module_dialog_disable_create(_("Error loading Module"), body, m);
+        m->api = NULL;
+        m->func.init = NULL;
+        m->func.shutdown = NULL;
+        m->func.save = NULL;
+
+        dlclose(m->handle);
+        m->handle = NULL;
+        m->error = 1;
+        goto init_done;
+     }
+   if (m->api->version != E_MODULE_API_VERSION)
+     {
+        snprintf(body, sizeof(body),
+                 _("Module API Error<ps/>Error initializing Module: %s<ps/>"
+                   "It requires a module API version of: %i.<ps/>"
+                   "The module API advertized by Enlightenment is: %i.<ps/>"),
+                 _(m->api->name), m->api->version, E_MODULE_API_VERSION);
+
+        snprintf(title, sizeof(title), _("Enlightenment %s Module"),
+                 _(m->api->name));
+
+        _e_module_dialog_disable_create(title, body, m);
+        m->api = NULL;
+        m->func.init = NULL;
+        m->func.shutdown = NULL;
+        m->func.save = NULL;
+        dlclose(m->handle);
+        m->handle = NULL;
+        m->error = 1;
+        goto init_done;
+     }
+
+init_done:
+
+   _e_modules = eina_list_append(_e_modules, m);
+   if (!_e_modules_hash)
+     {
+        /* wayland module preloading */
+        if (!e_module_init())
+          CRI("WTFFFFF");
+     }
+   eina_hash_add(_e_modules_hash, name, m);
+   m->name = eina_stringshare_add(name);
+   if (modpath)
+     {
+        s = ecore_file_dir_get(modpath);
+        if (s)
+          {
+             char *s2;
+
+             s2 = ecore_file_dir_get(s);
+             free(s);
+             if (s2)
+               {
+                  m->dir = eina_stringshare_add(s2);
+                  free(s2);
+               }
+          }
+     }
+   if (!in_list)
+     {
+        E_Config_Module *module;
+
+        module = E_NEW(E_Config_Module, 1);
+        module->name = eina_stringshare_add(m->name);
+        module->enabled = 0;
+        e_config->modules = eina_list_append(e_config->modules, module);
+        e_config_save_queue();
+     }
+   return m;
+}
+
+static void
+_e_module_load_resolve(E_Module_Load *ld, const char *name)
+{
+   ld->name = eina_stringshare_add(name);
+   if (name[0] != '/')
+     {
+        snprintf(ld->buf, sizeof(ld->buf), "%s/%s/module.so", name, MODULE_ARCH);
+        ld->modpath = e_path_find(path_modules, ld->buf);
+     }
+   else if (eina_str_has_extension(name, ".so"))
+     ld->modpath = eina_stringshare_add(name);
+}
+
+static void
+_e_module_load_open(E_Module_Load *ld)
+{
+   const char *err;
+
+   if (!ld->modpath) return;
+   e_util_env_set("E_MODULE_LOAD", ld->name);
+   ld->handle = dlopen(ld->modpath, (RTLD_NOW | RTLD_LOCAL));
+   unsetenv("E_MODULE_LOAD");
+   if ((!ld->handle) && (err = dlerror())) ld->err = strdup(err);
+}
+
+static void
+_e_module_load_setup(E_Module_Load *ld)
+{
+   int *deferred;
+
+   ld->module = _e_module_setup(ld->name, ld->buf, ld->modpath, ld->handle, ld->err);
+   if ((!ld->module) || (ld->module->error)) return;
+   deferred = dlsym(ld->module->handle, "e_modapi_deferred");
+   ld->deferred = ((deferred) && (*deferred)) || _module_is_deferred(ld->name);
+   if (_module_is_important(ld->name)) ld->deferred = EINA_FALSE;
+}
+
+static E_Module_Load *
+_e_module_load_find(E_Module_Loader *loader, const char *name)
+{
+   unsigned int i;
+
+   for (i = 0; i < loader->count; i++)
+     if (!strcmp(loader->loads[i].name, name)) return &loader->loads[i];
+   return NULL;
+}
+
+/* initialize a module after whatever it declares, in a NULL terminated
+ * "const char *e_modapi_depends[]", that is also being loaded. a deferred
+ * module something else needs is pulled forward. with defer set modules
+ * are queued there instead of initialized now. */
+static void
+_e_module_load_enable(E_Module_Loader *loader, E_Module_Load *ld, Eina_Bool force, Eina_List **defer)
+{
+   const char **deps;
+   E_Module_Load *dep;
+
+   if ((ld->done) || (ld->visiting) || (!ld->module)) return;
+   if ((ld->deferred) && (!force)) return;
+   ld->visiting = EINA_TRUE;
+   if (ld->module->handle)
+     {
+        deps = dlsym(ld->module->handle, "e_modapi_depends");
+        for (; deps && *deps; deps++)
+          {
+             dep = _e_module_load_find(loader, *deps);
+             if (dep) _e_module_load_enable(loader, dep, EINA_TRUE, defer);
+          }
+     }
+   ld->visiting = EINA_FALSE;
+   ld->done = EINA_TRUE;
+
+   if (defer)
+     {
+        e_object_ref(E_OBJECT(ld->module));
+        *defer = eina_list_append(*defer, ld->module);
+        return;
+     }
+   e_util_env_set("E_MODULE_LOAD", ld->name);
+   e_module_enable(ld->module);
+}
+
+static Eina_Bool
+_e_module_deferred_cb_idler(void *data EINA_UNUSED)
+{
+   E_Module *m;
+
+   /* one per idle pass so input keeps being handled in between */
+   m = eina_list_data_get(_e_modules_deferred);
+   _e_modules_deferred = eina_list_remove_list(_e_modules_deferred, _e_modules_deferred);
+   if (m)
+     {
+        if (!e_object_is_del(E_OBJECT(m)))
+          {
+             e_util_env_set("E_MODULE_LOAD", m->name);
+             e_module_enable(m);
+             unsetenv("E_MODULE_LOAD");
+          }
+        e_object_unref(E_OBJECT(m));
+     }
+   if (_e_modules_deferred) return ECORE_CALLBACK_RENEW;
+   _e_modules_deferred_idler = NULL;
+   return ECORE_CALLBACK_CANCEL;
+}
+
+static void
+_e_module_deferred_cb_render_post(void *data EINA_UNUSED, Evas *e, void *event_info EINA_UNUSED)
+{
+   evas_event_callback_del(e, EVAS_CALLBACK_RENDER_POST,
+                           _e_module_deferred_cb_render_post);
+   _e_modules_deferred_render_cb = EINA_FALSE;
+   if (!_e_modules_deferred_idler)
+     _e_modules_deferred_idler = ecore_idler_add(_e_module_deferred_cb_idler, NULL);
+}
+
 static void
 _e_module_free(E_Module *m)
 {
@@ -8,12 +8,14 @@ static void            _e_msgbus_request_name_cb(void *data, const Eldbus_Messag
 static Eldbus_Message *_e_msgbus_core_version_cb(const Eldbus_Service_Interface *iface, const Eldbus_Message *msg);
 static Eldbus_Message *_e_msgbus_core_restart_cb(const Eldbus_Service_Interface *iface, const Eldbus_Message *msg);
 static Eldbus_Message *_e_msgbus_core_shutdown_cb(const Eldbus_Service_Interface *iface, const Eldbus_Message *msg);
+static Eldbus_Message *_e_msgbus_core_comp_profile_dump_cb(const Eldbus_Service_Interface *iface, const Eldbus_Message *msg);
 
 static const Eldbus_Method core_methods[] =
 {
    { "Version", NULL, ELDBUS_ARGS({"s", "version"}), _e_msgbus_core_version_cb, 0 },
    { "Restart", NULL, NULL, _e_msgbus_core_restart_cb, 0 },
    { "Shutdown", NULL, NULL, _e_msgbus_core_shutdown_cb, 0 },
+   { "CompProfileDump", NULL, ELDBUS_ARGS({"s", "file"}), _e_msgbus_core_comp_profile_dump_cb, 0 },
    { NULL, NULL, NULL, NULL, 0}
 };
 
@@ -127,3 +129,22 @@ _e_msgbus_core_shutdown_cb(const Eldbus_Service_Interface *iface EINA_UNUSED,
      e_sys_action_do(E_SYS_EXIT, NULL);
    return eldbus_message_method_return_new(msg);
 }
+
+static Eldbus_Message *
+_e_msgbus_core_comp_profile_dump_cb(const Eldbus_Service_Interface *iface EINA_UNUSED,
+                                    const Eldbus_Message *msg)
+{
+   Eldbus_Message *reply;
+   char buf[PATH_MAX];
+
+   /* only ever write into the user dir; the caller gets the path back */
+   e_user_dir_snprintf(buf, sizeof(buf), "comp-profile-%lld.json",
+                       (long long)ecore_time_unix_get());
+   if (!e_comp_profile_dump(buf))
+     return eldbus_message_error_new(msg, "org.enlightenment.wm.Error",
+                                     "Could not write profile");
+   reply = eldbus_message_method_return_new(msg);
+   EINA_SAFETY_ON_NULL_RETURN_VAL(reply, NULL);
+   eldbus_message_arguments_append(reply, "s", buf);
+   return reply;
+}
@@ -1,9 +1,62 @@
 #include "e.h"
 
+#define E_PATH_CACHE_MAX     4096
+#define E_PATH_CACHE_VERSION 2
+
+typedef struct _E_Path_Dir_Cache   E_Path_Dir_Cache;
+typedef struct _E_Path_Cache       E_Path_Cache;
+typedef struct _E_Path_Cache_Dir   E_Path_Cache_Dir;
+typedef struct _E_Path_Cache_Entry E_Path_Cache_Entry;
+
+struct _E_Path_Dir_Cache
+{
+   E_Path             *ep;
+   const char         *dir;
+   Eina_Hash          *names; // NULL if the dir can't be watched
+   Ecore_File_Monitor *monitor;
+   Eina_Bool           stale E_BITFIELD;
+};
+
+/* on disk */
+struct _E_Path_Cache
+{
+   int        version;
+   Eina_List *dirs;
+   Eina_List *entries;
+};
+
+struct _E_Path_Cache_Dir
+{
+   const char *dir;
+   long long   mtime;
+};
+
+struct _E_Path_Cache_Entry
+{
+   const char *file;
+   const char *path;
+   long long   mtime; /* of path, which may be nested below a search dir */
+};
+
 /* local subsystem functions */
 static void      _e_path_free(E_Path *ep);
 static void      _e_path_cache_free(E_Path *ep);
 static Eina_Bool _e_path_cache_free_cb(const Eina_Hash *hash, const void *key, void *data, void *fdata);
+static Eina_Bool _e_path_dir_lookup(E_Path *ep, const char *dir, const char *file, char *buf, size_t size, Eina_Bool *certain);
+static void      _e_path_cache_add(E_Path *ep, const char *file, const char *path);
+static void      _e_path_cache_edd_ref(void);
+static void      _e_path_cache_edd_unref(void);
+static Eina_List *_e_path_cache_dirs_get(E_Path *ep);
+static void      _e_path_cache_data_free(E_Path_Cache *pc);
+
+/* local subsystem globals */
+/* stored in the lookup hash for files known not to be in any dir */
+static const char _e_path_miss[] = "";
+
+static E_Config_DD *_e_path_cache_edd = NULL;
+static E_Config_DD *_e_path_cache_dir_edd = NULL;
+static E_Config_DD *_e_path_cache_entry_edd = NULL;
+static int _e_path_cache_edd_refs = 0;
 
 /* externally accessible functions */
 E_API E_Path *
@@ -232,7 +285,7 @@ e_path_find(E_Path *ep, const char *file)
    Eina_List *l;
    E_Path_Dir *epd;
    char *str;
-   Eina_Stringshare *ret;
+   Eina_Bool certain = EINA_TRUE;
    char buf[PATH_MAX] = "";
 
    E_OBJECT_CHECK_RETURN(ep, NULL);
@@ -240,22 +293,17 @@ e_path_find(E_Path *ep, const char *file)
 
    if (!file) return NULL;
    str = eina_hash_find(ep->hash, file);
+   if (str == _e_path_miss) return NULL;
    if (str) return eina_stringshare_ref(str);
    /* Look in the default dir list */
    EINA_LIST_FOREACH(ep->default_dir_list, l, epd)
      {
         if (epd->dir)
           {
-             snprintf(buf, sizeof(buf), "%s/%s", epd->dir, file);
-             if (ecore_file_exists(buf))
+             if (_e_path_dir_lookup(ep, epd->dir, file, buf, sizeof(buf), &certain))
                {
-                  if (!ep->hash)
-                    ep->hash = eina_hash_string_superfast_new(NULL);
-                  if (eina_hash_population(ep->hash) >= 512)
-                    _e_path_cache_free(ep);
-                  ret = eina_stringshare_add(buf);
-                  eina_hash_add(ep->hash, file, ret);
-                  return eina_stringshare_ref(ret);
+                  _e_path_cache_add(ep, file, buf);
+                  return eina_stringshare_add(buf);
                }
           }
      }
@@ -264,19 +312,16 @@ e_path_find(E_Path *ep, const char *file)
      {
         if (epd->dir)
           {
-             snprintf(buf, sizeof(buf), "%s/%s", epd->dir, file);
-             if (ecore_file_exists(buf))
+             if (_e_path_dir_lookup(ep, epd->dir, file, buf, sizeof(buf), &certain))
                {
-                  if (!ep->hash)
-                    ep->hash = eina_hash_string_superfast_new(NULL);
-                  if (eina_hash_population(ep->hash) >= 512)
-                    _e_path_cache_free(ep);
-                  ret = eina_stringshare_add(buf);
-                  eina_hash_add(ep->hash, file, ret);
-                  return eina_stringshare_ref(ret);
+                  _e_path_cache_add(ep, file, buf);
+                  return eina_stringshare_add(buf);
                }
           }
      }
+   /* only remember the miss if every dir answered it from a watched
+    * listing, otherwise it can't be invalidated */
+   if (certain) _e_path_cache_add(ep, file, NULL);
    return NULL;
 }
 
@@ -343,6 +388,111 @@ e_path_dir_list_free(Eina_List *dir_list)
      }
 }
 
+/* keep the table of resolved files in the config domain given, and
+ * reload it now if none of the search dirs changed since it was saved */
+E_API void
+e_path_cache_persist(E_Path *ep, const char *domain)
+{
+   E_Path_Cache *pc;
+   E_Path_Cache_Dir *pcd;
+   E_Path_Cache_Entry *pce;
+   Eina_List *dirs, *l, *ll;
+   const char *dir;
+   Eina_Bool valid;
+
+   E_OBJECT_CHECK(ep);
+   E_OBJECT_TYPE_CHECK(ep, E_PATH_TYPE);
+
+   if (!ep->cache_domain) _e_path_cache_edd_ref();
+   eina_stringshare_replace(&ep->cache_domain, domain);
+   if (!domain)
+     {
+        _e_path_cache_edd_unref();
+        return;
+     }
+
+   pc = e_config_domain_load(domain, _e_path_cache_edd);
+   if (!pc) return;
+
+   /* the dirs must be the same, in the same order, and must not have had
+    * entries added or removed */
+   dirs = _e_path_cache_dirs_get(ep);
+   valid = ((pc->version == E_PATH_CACHE_VERSION) &&
+            (eina_list_count(dirs) == eina_list_count(pc->dirs)));
+   ll = pc->dirs;
+   EINA_LIST_FOREACH(dirs, l, dir)
+     {
+        if (!valid) break;
+        pcd = eina_list_data_get(ll);
+        ll = eina_list_next(ll);
+        if ((!pcd->dir) || (strcmp(pcd->dir, dir)) ||
+            (pcd->mtime != ecore_file_mod_time(dir)))
+          valid = EINA_FALSE;
+     }
+   eina_list_free(dirs);
+
+   if (valid)
+     {
+        EINA_LIST_FOREACH(pc->entries, l, pce)
+          {
+             if ((!pce->file) || (!pce->path)) continue;
+             /* the search dirs don't change when something below them is
+              * updated in place, so check each file is still the one seen */
+             if (pce->mtime != ecore_file_mod_time(pce->path)) continue;
+             if (!ep->hash)
+               ep->hash = eina_hash_string_superfast_new(NULL);
+             if (eina_hash_find(ep->hash, pce->file)) continue;
+             eina_hash_add(ep->hash, pce->file, eina_stringshare_add(pce->path));
+          }
+     }
+   _e_path_cache_data_free(pc);
+}
+
+static Eina_Bool
+_e_path_cache_save_cb(const Eina_Hash *hash EINA_UNUSED, const void *key, void *data, void *fdata)
+{
+   E_Path_Cache *pc = fdata;
+   E_Path_Cache_Entry *pce;
+
+   if (data == _e_path_miss) return EINA_TRUE;
+   pce = E_NEW(E_Path_Cache_Entry, 1);
+   pce->file = eina_stringshare_add(key);
+   pce->path = eina_stringshare_ref(data);
+   pce->mtime = ecore_file_mod_time(pce->path);
+   pc->entries = eina_list_append(pc->entries, pce);
+   return EINA_TRUE;
+}
+
+E_API void
+e_path_cache_save(E_Path *ep)
+{
+   E_Path_Cache *pc;
+   E_Path_Cache_Dir *pcd;
+   Eina_List *dirs;
+   const char *dir;
+
+   E_OBJECT_CHECK(ep);
+   E_OBJECT_TYPE_CHECK(ep, E_PATH_TYPE);
+
+   if ((!ep->cache_domain) || (!ep->cache_changed)) return;
+
+   pc = E_NEW(E_Path_Cache, 1);
+   pc->version = E_PATH_CACHE_VERSION;
+   dirs = _e_path_cache_dirs_get(ep);
+   EINA_LIST_FREE(dirs, dir)
+     {
+        pcd = E_NEW(E_Path_Cache_Dir, 1);
+        pcd->dir = eina_stringshare_add(dir);
+        pcd->mtime = ecore_file_mod_time(dir);
+        pc->dirs = eina_list_append(pc->dirs, pcd);
+     }
+   if (ep->hash)
+     eina_hash_foreach(ep->hash, _e_path_cache_save_cb, pc);
+   e_config_domain_save(ep->cache_domain, _e_path_cache_edd, pc);
+   _e_path_cache_data_free(pc);
+   ep->cache_changed = EINA_FALSE;
+}
+
 /* local subsystem functions */
 static void
 _e_path_free(E_Path *ep)
@@ -350,6 +500,12 @@ _e_path_free(E_Path *ep)
    E_Path_Dir *epd;
 
    _e_path_cache_free(ep);
+   E_FREE_FUNC(ep->dir_hash, eina_hash_free);
+   if (ep->cache_domain)
+     {
+        eina_stringshare_del(ep->cache_domain);
+        _e_path_cache_edd_unref();
+     }
    EINA_LIST_FREE(ep->default_dir_list, epd)
      {
         eina_stringshare_del(epd->dir);
@@ -370,7 +526,201 @@ _e_path_cache_free(E_Path *ep)
 static Eina_Bool
 _e_path_cache_free_cb(const Eina_Hash *hash EINA_UNUSED, const void *key EINA_UNUSED, void *data, void *fdata EINA_UNUSED)
 {
-   eina_stringshare_del(data);
+   if (data != _e_path_miss) eina_stringshare_del(data);
    return 1;
 }
 
+static void
+_e_path_cache_add(E_Path *ep, const char *file, const char *path)
+{
+   if (!ep->hash)
+     ep->hash = eina_hash_string_superfast_new(NULL);
+   if (eina_hash_population(ep->hash) >= E_PATH_CACHE_MAX)
+     _e_path_cache_free(ep);
+   if (!ep->hash)
+     ep->hash = eina_hash_string_superfast_new(NULL);
+   if (path)
+     {
+        eina_hash_add(ep->hash, file, eina_stringshare_add(path));
+        ep->cache_changed = EINA_TRUE;
+     }
+   else
+     eina_hash_add(ep->hash, file, (void *)_e_path_miss);
+}
+
+static void
+_e_path_cb_dir_monitor(void *data, Ecore_File_Monitor *em EINA_UNUSED, Ecore_File_Event event EINA_UNUSED, const char *path EINA_UNUSED)
+{
+   E_Path_Dir_Cache *dc = data;
+
+   /* the listing is re-read on the next lookup; anything resolved against
+    * it, hit or miss, may now be wrong */
+   dc->stale = EINA_TRUE;
+   _e_path_cache_free(dc->ep);
+}
+
+static void
+_e_path_dir_cache_clear(E_Path_Dir_Cache *dc)
+{
+   E_FREE_FUNC(dc->monitor, ecore_file_monitor_del);
+   E_FREE_FUNC(dc->names, eina_hash_free);
+}
+
+static void
+_e_path_dir_cache_free(void *data)
+{
+   E_Path_Dir_Cache *dc = data;
+
+   _e_path_dir_cache_clear(dc);
+   eina_stringshare_del(dc->dir);
+   free(dc);
+}
+
+static E_Path_Dir_Cache *
+_e_path_dir_cache_get(E_Path *ep, const char *dir)
+{
+   E_Path_Dir_Cache *dc;
+   Eina_List *files;
+   char *f;
+
+   if (!ep->dir_hash)
+     ep->dir_hash = eina_hash_string_superfast_new(_e_path_dir_cache_free);
+   dc = eina_hash_find(ep->dir_hash, dir);
+   if ((dc) && (!dc->stale)) return dc;
+   if (!dc)
+     {
+        dc = E_NEW(E_Path_Dir_Cache, 1);
+        dc->ep = ep;
+        dc->dir = eina_stringshare_add(dir);
+        eina_hash_add(ep->dir_hash, dir, dc);
+     }
+   else
+     _e_path_dir_cache_clear(dc);
+   dc->stale = EINA_FALSE;
+
+   /* watch first so nothing added while listing is missed. a dir that
+    * doesn't exist can't be watched and is stat()ed per lookup instead */
+   dc->monitor = ecore_file_monitor_add(dir, _e_path_cb_dir_monitor, dc);
+   if (!dc->monitor) return dc;
+   dc->names = eina_hash_string_superfast_new(NULL);
+   files = ecore_file_ls(dir);
+   EINA_LIST_FREE(files, f)
+     {
+        eina_hash_add(dc->names, f, dc);
+        free(f);
+     }
+   return dc;
+}
+
+/* check for dir/file, using the dir listing to skip the stat() for
+ * anything whose first path component isn't there. certain is cleared if
+ * a miss couldn't be answered from a watched listing. */
+static Eina_Bool
+_e_path_dir_lookup(E_Path *ep, const char *dir, const char *file, char *buf, size_t size, Eina_Bool *certain)
+{
+   E_Path_Dir_Cache *dc;
+   const char *p;
+   char first[PATH_MAX];
+   size_t len;
+
+   snprintf(buf, size, "%s/%s", dir, file);
+   dc = _e_path_dir_cache_get(ep, dir);
+   p = strchr(file, '/');
+   len = p ? (size_t)(p - file) : strlen(file);
+   if ((!dc->names) || (len >= sizeof(first)) ||
+       (!strncmp(file, ".", len)) || (!strncmp(file, "..", len)))
+     {
+        if (ecore_file_exists(buf)) return EINA_TRUE;
+        *certain = EINA_FALSE;
+        return EINA_FALSE;
+     }
+   memcpy(first, file, len);
+   first[len] = 0;
+   if (!eina_hash_find(dc->names, first)) return EINA_FALSE;
+   /* listed, but the entry may be a dangling link or the rest of the
+    * path may be missing */
+   if (ecore_file_exists(buf)) return EINA_TRUE;
+   if (p) *certain = EINA_FALSE;
+   return EINA_FALSE;
+}
+
+/* the search dirs in lookup order */
+static Eina_List *
+_e_path_cache_dirs_get(E_Path *ep)
+{
+   Eina_List *dirs = NULL, *l;
+   E_Path_Dir *epd;
+
+   EINA_LIST_FOREACH(ep->default_dir_list, l, epd)
+     if (epd->dir) dirs = eina_list_append(dirs, epd->dir);
+   if (ep->user_dir_list)
+     {
+        EINA_LIST_FOREACH(*(ep->user_dir_list), l, epd)
+          if (epd->dir) dirs = eina_list_append(dirs, epd->dir);
+     }
+   return dirs;
+}
+
+static void
+_e_path_cache_data_free(E_Path_Cache *pc)
+{
+   E_Path_Cache_Dir *pcd;
+   E_Path_Cache_Entry *pce;
+
+   EINA_LIST_FREE(pc->dirs, pcd)
+     {
+        eina_stringshare_del(pcd->dir);
+        free(pcd);
+     }
+   EINA_LIST_FREE(pc->entries, pce)
+     {
+        eina_stringshare_del(pce->file);
+        eina_stringshare_del(pce->path);
+        free(pce);
+     }
+   free(pc);
+}
+
+static void
+_e_path_cache_edd_ref(void)
+{
+   if (_e_path_cache_edd_refs++) return;
+
+   _e_path_cache_dir_edd = E_CONFIG_DD_NEW("E_Path_Cache_Dir", E_Path_Cache_Dir);
+#undef T
+#undef D
+#define T E_Path_Cache_Dir
+#define D _e_path_cache_dir_edd
+   E_CONFIG_VAL(D, T, dir, STR);
+   E_CONFIG_VAL(D, T, mtime, LL);
+
+   _e_path_cache_entry_edd = E_CONFIG_DD_NEW("E_Path_Cache_Entry", E_Path_Cache_Entry);
+#undef T
+#undef D
+#define T E_Path_Cache_Entry
+#define D _e_path_cache_entry_edd
+   E_CONFIG_VAL(D, T, file, STR);
+   E_CONFIG_VAL(D, T, path, STR);
+   E_CONFIG_VAL(D, T, mtime, LL);
+
+   _e_path_cache_edd = E_CONFIG_DD_NEW("E_Path_Cache", E_Path_Cache);
+#undef T
+#undef D
+#define T E_Path_Cache
+#define D _e_path_cache_edd
+   E_CONFIG_VAL(D, T, version, INT);
+   E_CONFIG_LIST(D, T, dirs, _e_path_cache_dir_edd);
+   E_CONFIG_LIST(D, T, entries, _e_path_cache_entry_edd);
+#undef T
+#undef D
+}
+
+static void
+_e_path_cache_edd_unref(void)
+{
+   if (--_e_path_cache_edd_refs) return;
+   E_CONFIG_DD_FREE(_e_path_cache_edd);
+   E_CONFIG_DD_FREE(_e_path_cache_entry_edd);
+   E_CONFIG_DD_FREE(_e_path_cache_dir_edd);
+}
+
@@ -19,6 +19,12 @@ struct _E_Path
    E_Object   e_obj_inherit;
 
    Eina_Hash *hash;
+   /* directory listings of the search dirs, dropped when inotify says
+    * they changed */
+   Eina_Hash *dir_hash;
+   /* config domain the resolved table is kept in across restarts */
+   const char *cache_domain;
+   Eina_Bool   cache_changed E_BITFIELD;
 
    Eina_List *default_dir_list;
    /* keep track of the associated e_config path */
@@ -40,6 +46,9 @@ E_API Eina_Stringshare *e_path_find(E_Path *ep, const char *file);
 E_API void        e_path_evas_append(E_Path *ep, Evas *evas);
 E_API Eina_List  *e_path_dir_list_get(E_Path *ep);
 E_API void	 e_path_dir_list_free(Eina_List *dir_list);
+/* persistent lookup table */
+E_API void        e_path_cache_persist(E_Path *ep, const char *domain);
+E_API void        e_path_cache_save(E_Path *ep);
 
 #endif
 #endif
@@ -82,35 +82,239 @@ ignore_client(const E_Client *ec, const Eina_List *skiplist)
    return EINA_FALSE;
 }
 
+/* covered area of the zone is kept as a summed area table over the
+ * grid of client edges. the table is built once per placement and
+ * then answers "how much of this rect is covered" with two binary
+ * searches, instead of walking every client for every candidate */
+typedef struct _E_Place_Coverage E_Place_Coverage;
+
+struct _E_Place_Coverage
+{
+   int       *gx, *gy; /* sorted, unique client edges */
+   int        gw, gh;
+   int       *xi, *yi; /* pixel -> grid cell, when the span is sane */
+   long long *sat; /* covered area of [gx[0], gx[i]] x [gy[0], gy[j]] */
+};
+
+/* above this many pixels of span, look grid cells up by bisection */
+#define E_PLACE_INDEX_MAX (1 << 18)
+/* most grid lines per axis. past this edges snap to a coarser grid so the
+ * table stays bounded whatever the number of clients */
+#define E_PLACE_GRID_MAX 256
+
+static int
+_e_place_edges_unique(int *a, int num)
+{
+   int i, n = 0;
+
+   qsort(a, num, sizeof(int), _e_place_cb_sort_cmp);
+   for (i = 0; i < num; i++)
+     {
+        if ((n > 0) && (a[n - 1] == a[i])) continue;
+        a[n++] = a[i];
+     }
+   return n;
+}
+
+/* snap sorted, unique edges down onto at most E_PLACE_GRID_MAX evenly
+ * spaced lines, keeping the outer edges. clients then cover whole coarse
+ * cells, which overestimates coverage by less than a cell per edge */
+static int
+_e_place_edges_snap(int *a, int num)
+{
+   int i, n = 1, step, v;
+
+   if (num <= E_PLACE_GRID_MAX) return num;
+   step = (a[num - 1] - a[0] + E_PLACE_GRID_MAX - 3) / (E_PLACE_GRID_MAX - 2);
+   for (i = 1; i < num - 1; i++)
+     {
+        v = a[0] + (((a[i] - a[0]) / step) * step);
+        if (v != a[n - 1]) a[n++] = v;
+     }
+   if (a[num - 1] != a[n - 1]) a[n++] = a[num - 1];
+   return n;
+}
+
+static int
+_e_place_edge_find(const int *a, int num, int v)
+{
+   int lo = 0, hi = num - 1, mid;
+
+   /* last edge <= v, always leaving a cell to the right of it */
+   while (lo < hi)
+     {
+        mid = (lo + hi + 1) / 2;
+        if (a[mid] <= v) lo = mid;
+        else hi = mid - 1;
+     }
+   if (lo > num - 2) lo = num - 2;
+   return lo;
+}
+
+static int *
+_e_place_edge_index_new(const int *a, int num)
+{
+   int *idx, span, v, i = 0;
+
+   span = a[num - 1] - a[0] + 1;
+   if (span > E_PLACE_INDEX_MAX) return NULL;
+   idx = malloc(span * sizeof(int));
+   if (!idx) return NULL;
+   for (v = 0; v < span; v++)
+     {
+        while ((i < num - 2) && (a[i + 1] <= a[0] + v)) i++;
+        idx[v] = i;
+     }
+   return idx;
+}
+
+static Eina_Bool
+_e_place_coverage_build(E_Place_Coverage *cov, const Eina_Rectangle *rects, int num)
+{
+   int i, j, n, i0, i1, j0, j1, *cnt;
+
+   memset(cov, 0, sizeof(E_Place_Coverage));
+   if (num <= 0) return EINA_TRUE;
+   cov->gx = malloc(2 * num * sizeof(int));
+   cov->gy = malloc(2 * num * sizeof(int));
+   if ((!cov->gx) || (!cov->gy)) goto err;
+   for (n = 0; n < num; n++)
+     {
+        cov->gx[(n * 2)] = rects[n].x;
+        cov->gx[(n * 2) + 1] = rects[n].x + rects[n].w;
+        cov->gy[(n * 2)] = rects[n].y;
+        cov->gy[(n * 2) + 1] = rects[n].y + rects[n].h;
+     }
+   cov->gw = _e_place_edges_snap(cov->gx, _e_place_edges_unique(cov->gx, 2 * num));
+   cov->gh = _e_place_edges_snap(cov->gy, _e_place_edges_unique(cov->gy, 2 * num));
+
+   /* count how many clients cover each grid cell - a 2d difference
+    * array per client, then integrate it */
+   cnt = calloc(cov->gw * cov->gh, sizeof(int));
+   cov->sat = calloc(cov->gw * cov->gh, sizeof(long long));
+   if ((!cnt) || (!cov->sat))
+     {
+        free(cnt);
+        goto err;
+     }
+   for (n = 0; n < num; n++)
+     {
+        i0 = _e_place_edge_find(cov->gx, cov->gw, rects[n].x);
+        i1 = _e_place_edge_find(cov->gx, cov->gw, rects[n].x + rects[n].w - 1) + 1;
+        j0 = _e_place_edge_find(cov->gy, cov->gh, rects[n].y);
+        j1 = _e_place_edge_find(cov->gy, cov->gh, rects[n].y + rects[n].h - 1) + 1;
+        cnt[(j0 * cov->gw) + i0]++;
+        cnt[(j0 * cov->gw) + i1]--;
+        cnt[(j1 * cov->gw) + i0]--;
+        cnt[(j1 * cov->gw) + i1]++;
+     }
+   for (j = 0; j < cov->gh; j++)
+     for (i = 0; i < cov->gw; i++)
+       {
+          if (i > 0) cnt[(j * cov->gw) + i] += cnt[(j * cov->gw) + i - 1];
+          if (j > 0) cnt[(j * cov->gw) + i] += cnt[((j - 1) * cov->gw) + i];
+          if ((i > 0) && (j > 0)) cnt[(j * cov->gw) + i] -= cnt[((j - 1) * cov->gw) + i - 1];
+       }
+   for (j = 1; j < cov->gh; j++)
+     for (i = 1; i < cov->gw; i++)
+       cov->sat[(j * cov->gw) + i] =
+         cov->sat[((j - 1) * cov->gw) + i] +
+         cov->sat[(j * cov->gw) + i - 1] -
+         cov->sat[((j - 1) * cov->gw) + i - 1] +
+         ((long long)cnt[((j - 1) * cov->gw) + i - 1] *
+          (cov->gx[i] - cov->gx[i - 1]) * (cov->gy[j] - cov->gy[j - 1]));
+   free(cnt);
+   cov->xi = _e_place_edge_index_new(cov->gx, cov->gw);
+   cov->yi = _e_place_edge_index_new(cov->gy, cov->gh);
+   return EINA_TRUE;
+err:
+   E_FREE(cov->gx);
+   E_FREE(cov->gy);
+   cov->gw = cov->gh = 0;
+   return EINA_FALSE;
+}
+
+static void
+_e_place_coverage_free(E_Place_Coverage *cov)
+{
+   E_FREE(cov->gx);
+   E_FREE(cov->gy);
+   E_FREE(cov->xi);
+   E_FREE(cov->yi);
+   E_FREE(cov->sat);
+}
+
+/* covered area of [gx[0], x] x [gy[0], y]. coverage is constant inside a
+ * grid cell so this is exactly bilinear between the cell's corners */
+static long long
+_e_place_coverage_at(const E_Place_Coverage *cov, int x, int y)
+{
+   const long long *s;
+   long long s00, s10, s01, s11;
+   int i, j, dx, dy, fx, fy;
+
+   if (x <= cov->gx[0]) return 0;
+   if (y <= cov->gy[0]) return 0;
+   if (x > cov->gx[cov->gw - 1]) x = cov->gx[cov->gw - 1];
+   if (y > cov->gy[cov->gh - 1]) y = cov->gy[cov->gh - 1];
+   if (cov->xi) i = cov->xi[x - cov->gx[0]];
+   else i = _e_place_edge_find(cov->gx, cov->gw, x);
+   if (cov->yi) j = cov->yi[y - cov->gy[0]];
+   else j = _e_place_edge_find(cov->gy, cov->gh, y);
+   s = cov->sat + (j * cov->gw) + i;
+   s00 = s[0];
+   s10 = s[1];
+   s01 = s[cov->gw];
+   s11 = s[cov->gw + 1];
+   dx = cov->gx[i + 1] - cov->gx[i];
+   dy = cov->gy[j + 1] - cov->gy[j];
+   fx = x - cov->gx[i];
+   fy = y - cov->gy[j];
+   return s00 +
+          ((fx * (s10 - s00)) / dx) +
+          ((fy * (s01 - s00)) / dy) +
+          ((long long)fx * fy * ((s11 - s10 - s01 + s00) / ((long long)dx * dy)));
+}
+
 static int
-_e_place_coverage_client_add(Eina_List *skiplist, int ar, int x, int y, int w, int h)
+_e_place_coverage_client_add(const E_Place_Coverage *cov, int ar, int x, int y, int w, int h)
+{
+   long long a;
+
+   if ((cov->gw < 2) || (cov->gh < 2)) return ar;
+   a = _e_place_coverage_at(cov, x + w, y + h) -
+       _e_place_coverage_at(cov, x, y + h) -
+       _e_place_coverage_at(cov, x + w, y) +
+       _e_place_coverage_at(cov, x, y);
+   a += ar;
+   if (a > 0x7ffffffe) a = 0x7ffffffe;
+   return a;
+}
+
+static Eina_Rectangle *
+_e_place_coverage_clients_get(Eina_List *skiplist, int *num)
 {
+   Eina_Rectangle *rects = NULL, *tmp;
+   int n = 0, alloc = 0;
    E_Client *ec;
-   int x2, y2, w2, h2;
-   int iw, ih;
-   int x0, x00, yy0, y00;
 
    E_CLIENT_REVERSE_FOREACH(ec)
      {
         if (ignore_client(ec, skiplist)) continue;
         if (ignore_client_and_break(ec)) break;
-        x2 = ec->x; y2 = ec->y; w2 = ec->w; h2 = ec->h;
-        if (E_INTERSECTS(x, y, w, h, x2, y2, w2, h2))
+        if ((ec->w <= 0) || (ec->h <= 0)) continue;
+        if (n == alloc)
           {
-             x0 = x;
-             if (x < x2) x0 = x2;
-             x00 = (x + w);
-             if ((x2 + w2) < (x + w)) x00 = (x2 + w2);
-             yy0 = y;
-             if (y < y2) yy0 = y2;
-             y00 = (y + h);
-             if ((y2 + h2) < (y + h)) y00 = (y2 + h2);
-             iw = x00 - x0;
-             ih = y00 - yy0;
-             ar += (iw * ih);
+             alloc += 32;
+             tmp = realloc(rects, alloc * sizeof(Eina_Rectangle));
+             if (!tmp) break;
+             rects = tmp;
           }
+        EINA_RECTANGLE_SET(&rects[n], ec->x, ec->y, ec->w, ec->h);
+        n++;
      }
-   return ar;
+   *num = n;
+   return rects;
 }
 
 static int
@@ -168,7 +372,7 @@ _e_place_array_resize(int *array, int *pos, int *size)
 }
 
 static void
-_e_place_desk_region_smart_obstacle_add(char *u_x, char *u_y, int **a_x, int **a_y, int *a_w, int *a_h, int *a_alloc_w, int *a_alloc_h, int zx, int zy, int zw, int zh, int bx, int by, int bw, int bh)
+_e_place_desk_region_smart_obstacle_add(int **a_x, int **a_y, int *a_w, int *a_h, int *a_alloc_w, int *a_alloc_h, int zx, int zy, int zw, int zh, int bx, int by, int bw, int bh)
 {
    if (bx < zx)
      {
@@ -184,30 +388,15 @@ _e_place_desk_region_smart_obstacle_add(char *u_x, char *u_y, int **a_x, int **a
      }
    if ((by + bh) > zy + zh) bh = zy + zh - by;
    if (by >= zy + zh) return;
-   if (!u_x[bx])
-     {
-        *a_x = _e_place_array_resize(*a_x, a_w, a_alloc_w);
-        (*a_x)[*a_w - 1] = bx;
-        u_x[bx] = 1;
-     }
-   if (!u_x[bx + bw])
-     {
-        *a_x = _e_place_array_resize(*a_x, a_w, a_alloc_w);
-        (*a_x)[*a_w - 1] = bx + bw;
-        u_x[bx + bw] = 1;
-     }
-   if (!u_y[by])
-     {
-        *a_y = _e_place_array_resize(*a_y, a_h, a_alloc_h);
-        (*a_y)[*a_h - 1] = by;
-        u_y[by] = 1;
-     }
-   if (!u_y[by + bh])
-     {
-        *a_y = _e_place_array_resize(*a_y, a_h, a_alloc_h);
-        (*a_y)[*a_h - 1] = by + bh;
-        u_y[by + bh] = 1;
-     }
+   /* duplicates are dropped once all edges are in */
+   *a_x = _e_place_array_resize(*a_x, a_w, a_alloc_w);
+   (*a_x)[*a_w - 1] = bx;
+   *a_x = _e_place_array_resize(*a_x, a_w, a_alloc_w);
+   (*a_x)[*a_w - 1] = bx + bw;
+   *a_y = _e_place_array_resize(*a_y, a_h, a_alloc_h);
+   (*a_y)[*a_h - 1] = by;
+   *a_y = _e_place_array_resize(*a_y, a_h, a_alloc_h);
+   (*a_y)[*a_h - 1] = by + bh;
 }
 
 /* determine whether the "overlapping" area for a given geometry
@@ -216,13 +405,13 @@ _e_place_desk_region_smart_obstacle_add(char *u_x, char *u_y, int **a_x, int **a
  * geometry to use
  */
 static int
-_e_place_desk_region_smart_area_check(Eina_List *skiplist, int x, int y, int w, int h, E_Desk *desk, int area, int *rx, int *ry)
+_e_place_desk_region_smart_area_check(const E_Place_Coverage *cov, int x, int y, int w, int h, E_Desk *desk, int area, int *rx, int *ry)
 {
    int ar = 0;
 
-   ar = _e_place_coverage_client_add(skiplist, ar, x, y, w, h);
+   ar = _e_place_coverage_client_add(cov, ar, x, y, w, h);
 
-   if (e_config->window_placement_policy == E_WINDOW_PLACEMENT_SMART)
+   if ((desk) && (e_config->window_placement_policy == E_WINDOW_PLACEMENT_SMART))
      ar = _e_place_coverage_zone_obstacles_add(desk, ar, x, y, w, h);
 
    if (ar < area)
@@ -236,69 +425,56 @@ _e_place_desk_region_smart_area_check(Eina_List *skiplist, int x, int y, int w,
 
 /* calculate optimal placement based on "overlapping" area using:
  * - an obstacle's top-left and bottom-right points
- * - list of clients to skip
+ * - coverage of the clients to avoid
  * - current desk
  * - current least overlapping area
  * - pointers to current coords to use for placement
  * and then return the new least overlapping area
  */
 static int
-_e_place_desk_region_smart_area_calc(int x, int y, int xx, int yy, int zx, int zy, int zw, int zh, int w, int h, Eina_List *skiplist, E_Desk *desk, int area, int *rx, int *ry)
+_e_place_desk_region_smart_area_calc(int x, int y, int xx, int yy, int zx, int zy, int zw, int zh, int w, int h, const E_Place_Coverage *cov, E_Desk *desk, int area, int *rx, int *ry)
 {
    /* check top-left corner placement */
    if ((x <= MAX(zx, zx + (zw - w))) && (y <= MAX(zy, zy + (zh - h))))
      {
-        int ar = _e_place_desk_region_smart_area_check(skiplist, x, y, w, h, desk, area, rx, ry);
+        int ar = _e_place_desk_region_smart_area_check(cov, x, y, w, h, desk, area, rx, ry);
         if (!ar) return ar;
         if (ar < area) area = ar;
      }
    /* check top-right corner placement */
    if ((MAX(zx, xx - w) > zx) && (y <= MAX(zy, zy + (zh - h))))
      {
-        int ar = _e_place_desk_region_smart_area_check(skiplist, xx - w, y, w, h, desk, area, rx, ry);
+        int ar = _e_place_desk_region_smart_area_check(cov, xx - w, y, w, h, desk, area, rx, ry);
         if (!ar) return ar;
         if (ar < area) area = ar;
      }
    /* check bottom-right corner placement */
    if ((MAX(zx, xx - w) > zx) && (MAX(zy, yy - h) > zy))
      {
-        int ar = _e_place_desk_region_smart_area_check(skiplist, xx - w, yy - h, w, h, desk, area, rx, ry);
+        int ar = _e_place_desk_region_smart_area_check(cov, xx - w, yy - h, w, h, desk, area, rx, ry);
         if (!ar) return ar;
         if (ar < area) area = ar;
      }
    /* check bottom-left corner placement */
    if ((x <= MAX(zx, zx + (zw - w))) && (MAX(zy, yy - h) > zy))
      {
-        int ar = _e_place_desk_region_smart_area_check(skiplist, x, yy - h, w, h, desk, area, rx, ry);
+        int ar = _e_place_desk_region_smart_area_check(cov, x, yy - h, w, h, desk, area, rx, ry);
         if (!ar) return ar;
         if (ar < area) area = ar;
      }
    return area;
 }
 
-E_API int
-e_place_desk_region_smart(E_Desk *desk, Eina_List *skiplist, int x, int y, int w, int h, int *rx, int *ry)
+/* the placement itself - desk is only used for zone obstacles and may be
+ * NULL, which lets it run against any set of client rects */
+static void
+_e_place_region_smart(E_Desk *desk, const Eina_Rectangle *rects, int num, int zx, int zy, int zw, int zh, int x, int y, int w, int h, int *rx, int *ry)
 {
    int a_w = 0, a_h = 0, a_alloc_w = 0, a_alloc_h = 0;
    int *a_x = NULL, *a_y = NULL;
-   int zx, zy, zw, zh;
-   char *u_x = NULL, *u_y = NULL;
-   E_Client *ec;
-
-   *rx = x;
-   *ry = y;
-#if 0
-   /* DISABLE placement entirely for speed testing */
-   return 1;
-#endif
+   int n;
+   E_Place_Coverage cov;
 
-   if ((w <= 0) || (h <= 0))
-     {
-        printf("EEEK! trying to place 0x0 window!!!!\n");
-        return 1;
-     }
-
-   /* FIXME: this NEEDS optimizing */
    a_w = 2;
    a_h = 2;
    a_x = E_NEW(int, 2);
@@ -306,25 +482,12 @@ e_place_desk_region_smart(E_Desk *desk, Eina_List *skiplist, int x, int y, int w
    a_alloc_w = 2;
    a_alloc_h = 2;
 
-   zx = desk->zone->x;
-   zy = desk->zone->y;
-   zw = desk->zone->w;
-   zh = desk->zone->h;
-
-   u_x = calloc(zx + zw + 1, sizeof(char));
-   u_y = calloc(zy + zh + 1, sizeof(char));
-
    a_x[0] = zx;
    a_x[1] = zx + zw;
    a_y[0] = zy;
    a_y[1] = zy + zh;
 
-   u_x[zx] = 1;
-   u_x[zx + zw] = 1;
-   u_y[zy] = 1;
-   u_y[zy + zh] = 1;
-
-   if (e_config->window_placement_policy == E_WINDOW_PLACEMENT_SMART)
+   if ((desk) && (e_config->window_placement_policy == E_WINDOW_PLACEMENT_SMART))
      {
         E_Zone_Obstacle *obs;
 
@@ -337,7 +500,7 @@ e_place_desk_region_smart(E_Desk *desk, Eina_List *skiplist, int x, int y, int w
              bw = obs->w;
              bh = obs->h;
              if (E_INTERSECTS(bx, by, bw, bh, zx, zy, zw, zh))
-               _e_place_desk_region_smart_obstacle_add(u_x, u_y, &a_x, &a_y,
+               _e_place_desk_region_smart_obstacle_add(&a_x, &a_y,
                  &a_w, &a_h, &a_alloc_w, &a_alloc_h, zx, zy, zw, zh, bx, by, bw, bh);
           }
         EINA_INLIST_FOREACH(desk->zone->obstacles, obs)
@@ -349,31 +512,28 @@ e_place_desk_region_smart(E_Desk *desk, Eina_List *skiplist, int x, int y, int w
              bw = obs->w;
              bh = obs->h;
              if (E_INTERSECTS(bx, by, bw, bh, zx, zy, zw, zh))
-               _e_place_desk_region_smart_obstacle_add(u_x, u_y, &a_x, &a_y,
+               _e_place_desk_region_smart_obstacle_add(&a_x, &a_y,
                  &a_w, &a_h, &a_alloc_w, &a_alloc_h, zx, zy, zw, zh, bx, by, bw, bh);
           }
      }
 
-   E_CLIENT_REVERSE_FOREACH(ec)
+   for (n = 0; n < num; n++)
      {
         int bx, by, bw, bh;
 
-        if (ignore_client(ec, skiplist)) continue;
-        if (ignore_client_and_break(ec)) break;
-
-        bx = ec->x;
-        by = ec->y;
-        bw = ec->w;
-        bh = ec->h;
+        bx = rects[n].x;
+        by = rects[n].y;
+        bw = rects[n].w;
+        bh = rects[n].h;
 
         if (E_INTERSECTS(bx, by, bw, bh, zx, zy, zw, zh))
-          _e_place_desk_region_smart_obstacle_add(u_x, u_y, &a_x, &a_y,
+          _e_place_desk_region_smart_obstacle_add(&a_x, &a_y,
             &a_w, &a_h, &a_alloc_w, &a_alloc_h, zx, zy, zw, zh, bx, by, bw, bh);
      }
-   qsort(a_x, a_w, sizeof(int), _e_place_cb_sort_cmp);
-   qsort(a_y, a_h, sizeof(int), _e_place_cb_sort_cmp);
-   free(u_x);
-   free(u_y);
+   a_w = _e_place_edges_unique(a_x, a_w);
+   a_h = _e_place_edges_unique(a_y, a_h);
+
+   _e_place_coverage_build(&cov, rects, num);
 
    {
       int i, j;
@@ -384,11 +544,11 @@ e_place_desk_region_smart(E_Desk *desk, Eina_List *skiplist, int x, int y, int w
         {
            int ar = 0;
 
-           ar = _e_place_coverage_client_add(skiplist, ar,
+           ar = _e_place_coverage_client_add(&cov, ar,
                                              x, y,
                                              w, h);
 
-           if (e_config->window_placement_policy == E_WINDOW_PLACEMENT_SMART)
+           if ((desk) && (e_config->window_placement_policy == E_WINDOW_PLACEMENT_SMART))
              ar = _e_place_coverage_zone_obstacles_add(desk, ar,
                                               x, y,
                                               w, h);
@@ -410,13 +570,43 @@ e_place_desk_region_smart(E_Desk *desk, Eina_List *skiplist, int x, int y, int w
         for (i = 0; i < a_w - 1; i++)
           {
              area = _e_place_desk_region_smart_area_calc(a_x[i], a_y[j], a_x[i + 1], a_y[j + 1],
-                                                         zx, zy, zw, zh, w, h, skiplist, desk, area, rx, ry);
+                                                         zx, zy, zw, zh, w, h, &cov, desk, area, rx, ry);
              if (!area) goto done;
           }
    }
 done:
+   _e_place_coverage_free(&cov);
    E_FREE(a_x);
    E_FREE(a_y);
+}
+
+E_API int
+e_place_desk_region_smart(E_Desk *desk, Eina_List *skiplist, int x, int y, int w, int h, int *rx, int *ry)
+{
+   Eina_Rectangle *rects;
+   int zx, zy, zw, zh, num = 0;
+
+   *rx = x;
+   *ry = y;
+#if 0
+   /* DISABLE placement entirely for speed testing */
+   return 1;
+#endif
+
+   if ((w <= 0) || (h <= 0))
+     {
+        printf("EEEK! trying to place 0x0 window!!!!\n");
+        return 1;
+     }
+
+   zx = desk->zone->x;
+   zy = desk->zone->y;
+   zw = desk->zone->w;
+   zh = desk->zone->h;
+
+   rects = _e_place_coverage_clients_get(skiplist, &num);
+   _e_place_region_smart(desk, rects, num, zx, zy, zw, zh, x, y, w, h, rx, ry);
+   free(rects);
 
    e_zone_desk_useful_geometry_get(desk->zone, desk, &zx, &zy, &zw, &zh);
 
@@ -430,6 +620,35 @@ done:
    return 1;
 }
 
+#ifdef ENABLE_BENCH
+/* place num windows of varying size one after the other, each avoiding
+ * the ones placed before it, and report how long that took */
+EINTERN void
+e_place_bench(int num, int zw, int zh)
+{
+   Eina_Rectangle *rects;
+   double t0, t;
+   int n, w, h, rx, ry;
+
+   rects = calloc(num, sizeof(Eina_Rectangle));
+   if (!rects) return;
+   srand(num);
+   t0 = ecore_time_get();
+   for (n = 0; n < num; n++)
+     {
+        w = 320 + (rand() % 1600);
+        h = 240 + (rand() % 1000);
+        rx = ry = 0;
+        _e_place_region_smart(NULL, rects, n, 0, 0, zw, zh, 0, 0, w, h, &rx, &ry);
+        EINA_RECTANGLE_SET(&rects[n], rx, ry, w, h);
+     }
+   t = ecore_time_get() - t0;
+   printf("PLACE: %i windows in %ix%i: %1.3fs (%1.3fms per window)\n",
+          num, zw, zh, t, (t * 1000.0) / num);
+   free(rects);
+}
+#endif
+
 E_API int
 e_place_zone_region_smart(E_Zone *zone, Eina_List *skiplist, int x, int y, int w, int h, int *rx, int *ry)
 {
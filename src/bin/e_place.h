@@ -8,6 +8,9 @@ E_API int e_place_zone_region_smart(E_Zone *zone, Eina_List *skiplist, int x, in
 E_API int e_place_desk_region_smart(E_Desk *desk, Eina_List *skiplist, int x, int y, int w, int h, int *rx, int *ry);
 E_API int e_place_zone_cursor(E_Zone *zone, int x, int y, int w, int h, int it, int *rx, int *ry);
 E_API int e_place_zone_manual(E_Zone *zone, int w, int h, int *rx, int *ry);
+#ifdef ENABLE_BENCH
+EINTERN void e_place_bench(int num, int zw, int zh);
+#endif
 
 #endif
 #endif
@@ -13,10 +13,33 @@ struct _E_Remember_List
    Eina_List *list;
 };
 
+/* remembers compiled into class -> name -> role buckets. each level has
+ * a hash of exact keys plus an "any" child for rules that don't match on
+ * that property or match it with a glob. leaves hold the rules in list
+ * order so the first hit found per leaf is the best one in that leaf. */
+typedef struct _E_Remember_Index_Node E_Remember_Index_Node;
+typedef struct _E_Remember_Index_Rule E_Remember_Index_Rule;
+
+#define E_REMEMBER_INDEX_DEPTH 3
+
+struct _E_Remember_Index_Node
+{
+   Eina_Hash             *children;
+   E_Remember_Index_Node *any;
+   Eina_Inarray          *rules;
+};
+
+struct _E_Remember_Index_Rule
+{
+   E_Remember  *rem;
+   unsigned int pos;
+};
+
 /* local subsystem functions */
 static void        _e_remember_free(E_Remember *rem);
 static void        _e_remember_update(E_Client *ec, E_Remember *rem);
 static E_Remember *_e_remember_find(E_Client *ec, int check_usable, Eina_Bool sr);
+static void        _e_remember_index_free(void);
 static void        _e_remember_cb_hook_pre_post_fetch(void *data, E_Client *ec);
 static void        _e_remember_cb_hook_eval_post_new_client(void *data, E_Client *ec);
 static void        _e_remember_init_edd(void);
@@ -29,6 +52,10 @@ static E_Remember_List *remembers = NULL;
 static Eina_List *handlers = NULL;
 static Ecore_Idler *remember_idler = NULL;
 static Eina_List *remember_idler_list = NULL;
+static E_Remember_Index_Node *remember_index = NULL;
+static Eina_List *remember_index_list = NULL;
+static unsigned int remember_index_count = 0;
+static Eina_Bool remember_index_dirty = EINA_TRUE;
 
 /* static Eina_List *e_remember_restart_list = NULL; */
 
@@ -101,6 +128,7 @@ e_remember_shutdown(void)
    if (remember_idler) ecore_idler_del(remember_idler);
    remember_idler = NULL;
    remember_idler_list = eina_list_free(remember_idler_list);
+   _e_remember_index_free();
 
    return 1;
 }
@@ -227,6 +255,7 @@ e_remember_new(void)
    rem = E_NEW(E_Remember, 1);
    if (!rem) return NULL;
    e_config->remembers = eina_list_prepend(e_config->remembers, rem);
+   remember_index_dirty = EINA_TRUE;
    return rem;
 }
 
@@ -612,11 +641,19 @@ e_remember_sr_find(E_Client *ec)
    return _e_remember_find(ec, 1, 1);
 }
 
+E_API void
+e_remember_match_index_invalidate(void)
+{
+   remember_index_dirty = EINA_TRUE;
+}
+
 E_API void
 e_remember_match_update(E_Remember *rem)
 {
    int max_count = 0;
 
+   remember_index_dirty = EINA_TRUE;
+
    if (rem->match & E_REMEMBER_MATCH_NAME) max_count += 2;
    if (rem->match & E_REMEMBER_MATCH_CLASS) max_count += 2;
    if (rem->match & E_REMEMBER_MATCH_TITLE) max_count += 2;
@@ -654,6 +691,7 @@ e_remember_default_match_set(E_Remember *rem, E_Client *ec)
    const char *title, *clasz, *name, *role;
    int match;
 
+   remember_index_dirty = EINA_TRUE;
    eina_stringshare_replace(&rem->name, NULL);
    eina_stringshare_replace(&rem->class, NULL);
    eina_stringshare_replace(&rem->title, NULL);
@@ -705,6 +743,7 @@ e_remember_update(E_Client *ec)
    if (((!ec->remember) || ec->remember->keep_settings) && (!ec->sr_remember)) return;
    if (ec->remember) _e_remember_update(ec, ec->remember);
    if (ec->sr_remember) _e_remember_update(ec, ec->sr_remember);
+   remember_index_dirty = EINA_TRUE;
    e_config_save_queue();
 }
 
@@ -848,6 +887,223 @@ _e_remember_update(E_Client *ec, E_Remember *rem)
 }
 
 /* local subsystem functions */
+#if REMEMBER_HIERARCHY
+static Eina_Bool
+_e_remember_match(E_Remember *rem, E_Client *ec)
+{
+   const char *title = "";
+
+   if (ec->netwm.name) title = ec->netwm.name;
+   else title = ec->icccm.title;
+
+   /* For each type of match, check whether the match is
+    * required, and if it is, check whether there's a match. If
+    * it fails, then go to the next remember */
+   if (rem->match & E_REMEMBER_MATCH_NAME &&
+       !e_util_glob_match(ec->icccm.name, rem->name))
+     return EINA_FALSE;
+   if (rem->match & E_REMEMBER_MATCH_CLASS &&
+       !e_util_glob_match(ec->icccm.class, rem->class))
+     return EINA_FALSE;
+   if (rem->match & E_REMEMBER_MATCH_TITLE &&
+       !e_util_glob_match(title, rem->title))
+     return EINA_FALSE;
+   if (rem->match & E_REMEMBER_MATCH_ROLE &&
+       e_util_strcmp(rem->role, ec->icccm.window_role) &&
+       !e_util_both_str_empty(rem->role, ec->icccm.window_role))
+     return EINA_FALSE;
+   if (rem->match & E_REMEMBER_MATCH_TYPE &&
+       rem->type != (int)ec->netwm.type)
+     return EINA_FALSE;
+   if (rem->match & E_REMEMBER_MATCH_TRANSIENT &&
+       !(rem->transient && ec->icccm.transient_for != 0) &&
+       !(!rem->transient) && (ec->icccm.transient_for == 0))
+     return EINA_FALSE;
+
+   return EINA_TRUE;
+}
+
+static void
+_e_remember_index_node_free(E_Remember_Index_Node *node)
+{
+   if (!node) return;
+   if (node->children) eina_hash_free(node->children);
+   _e_remember_index_node_free(node->any);
+   if (node->rules) eina_inarray_free(node->rules);
+   free(node);
+}
+
+static void
+_e_remember_index_node_hash_free(void *data)
+{
+   _e_remember_index_node_free(data);
+}
+
+/* the key a rule is bucketed under at each level, or NULL if it has to go
+ * in the "any" child. only exact, non-empty values are keyed: globs and
+ * empty strings are left to the full match. */
+static const char *
+_e_remember_index_rule_key(const E_Remember *rem, int depth)
+{
+   const char *key = NULL;
+
+   switch (depth)
+     {
+      case 0:
+        if (rem->match & E_REMEMBER_MATCH_CLASS) key = rem->class;
+        break;
+      case 1:
+        if (rem->match & E_REMEMBER_MATCH_NAME) key = rem->name;
+        break;
+      case 2:
+        /* role is compared exactly, never globbed */
+        if ((rem->match & E_REMEMBER_MATCH_ROLE) && (rem->role) && (rem->role[0]))
+          return rem->role;
+        return NULL;
+      default:
+        break;
+     }
+   if ((!key) || (!key[0])) return NULL;
+   if (strpbrk(key, "*?[\\")) return NULL;
+   return key;
+}
+
+static const char *
+_e_remember_index_client_key(const E_Client *ec, int depth)
+{
+   switch (depth)
+     {
+      case 0: return ec->icccm.class;
+      case 1: return ec->icccm.name;
+      case 2: return ec->icccm.window_role;
+      default: break;
+     }
+   return NULL;
+}
+
+static void
+_e_remember_index_insert(E_Remember_Index_Node *node, E_Remember_Index_Rule *rule, int depth)
+{
+   E_Remember_Index_Node *child;
+   const char *key;
+
+   if (depth == E_REMEMBER_INDEX_DEPTH)
+     {
+        if (!node->rules)
+          node->rules = eina_inarray_new(sizeof(E_Remember_Index_Rule), 4);
+        eina_inarray_push(node->rules, rule);
+        return;
+     }
+
+   key = _e_remember_index_rule_key(rule->rem, depth);
+   if (key)
+     {
+        if (!node->children)
+          node->children = eina_hash_string_superfast_new(_e_remember_index_node_hash_free);
+        child = eina_hash_find(node->children, key);
+        if (!child)
+          {
+             child = E_NEW(E_Remember_Index_Node, 1);
+             eina_hash_add(node->children, key, child);
+          }
+     }
+   else
+     {
+        if (!node->any) node->any = E_NEW(E_Remember_Index_Node, 1);
+        child = node->any;
+     }
+   _e_remember_index_insert(child, rule, depth + 1);
+}
+
+static void
+_e_remember_index_free(void)
+{
+   _e_remember_index_node_free(remember_index);
+   remember_index = NULL;
+   remember_index_list = NULL;
+   remember_index_count = 0;
+   remember_index_dirty = EINA_TRUE;
+}
+
+static void
+_e_remember_index_build(void)
+{
+   E_Remember_Index_Rule rule;
+   Eina_List *l;
+   E_Remember *rem;
+   unsigned int pos = 0;
+
+   _e_remember_index_free();
+   remember_index = E_NEW(E_Remember_Index_Node, 1);
+   EINA_LIST_FOREACH(e_config->remembers, l, rem)
+     {
+        rule.rem = rem;
+        rule.pos = pos++;
+        _e_remember_index_insert(remember_index, &rule, 0);
+     }
+   remember_index_list = e_config->remembers;
+   remember_index_count = pos;
+   remember_index_dirty = EINA_FALSE;
+}
+
+static void
+_e_remember_index_lookup(E_Remember_Index_Node *node, E_Client *ec, int check_usable,
+                         int depth, E_Remember_Index_Rule *best)
+{
+   E_Remember_Index_Node *child;
+   E_Remember_Index_Rule *rule;
+   const char *key;
+
+   if (depth == E_REMEMBER_INDEX_DEPTH)
+     {
+        if (!node->rules) return;
+        EINA_INARRAY_FOREACH(node->rules, rule)
+          {
+             /* rules are in list order, nothing later can beat best */
+             if (rule->pos >= best->pos) return;
+             if ((check_usable) && (!e_remember_usable_get(rule->rem)))
+               continue;
+             if (rule->rem->apply & E_REMEMBER_APPLY_UUID) continue;
+             if (!_e_remember_match(rule->rem, ec)) continue;
+             *best = *rule;
+             return;
+          }
+        return;
+     }
+
+   key = _e_remember_index_client_key(ec, depth);
+   if ((key) && (node->children))
+     {
+        child = eina_hash_find(node->children, key);
+        if (child)
+          _e_remember_index_lookup(child, ec, check_usable, depth + 1, best);
+     }
+   if (node->any)
+     _e_remember_index_lookup(node->any, ec, check_usable, depth + 1, best);
+}
+
+static E_Remember *
+_e_remember_index_find(E_Client *ec, int check_usable)
+{
+   E_Remember_Index_Rule best = { NULL, UINT_MAX };
+
+   /* the list itself may be swapped or edited behind our back (config
+    * reloads, profile changes), so check it is still the one indexed */
+   if ((remember_index_dirty) || (!remember_index) ||
+       (remember_index_list != e_config->remembers) ||
+       (remember_index_count != eina_list_count(e_config->remembers)))
+     _e_remember_index_build();
+
+   _e_remember_index_lookup(remember_index, ec, check_usable, 0, &best);
+   return best.rem;
+}
+#else
+static void
+_e_remember_index_free(void)
+{
+}
+#endif
+
 static E_Remember *
 _e_remember_find(E_Client *ec, int check_usable, Eina_Bool sr)
 {
@@ -907,52 +1163,23 @@ _e_remember_find(E_Client *ec, int check_usable, Eina_Bool sr)
     * with the most possible matches at the start of the list. This
     * means, as soon as a valid match is found, it is a match
     * within the set of best possible matches. */
+   if (!sr) return _e_remember_index_find(ec, check_usable);
+
+   /* session recovery matches on uuid before anything else, so it can't
+    * use the index. it is rare enough to walk the list. */
    EINA_LIST_FOREACH(e_config->remembers, l, rem)
      {
-        const char *title = "";
-
         if ((check_usable) && (!e_remember_usable_get(rem)))
           continue;
 
-        if (sr)
+        if (!eina_streq(rem->uuid, ec->uuid)) continue;
+        if (rem->uuid)
           {
-             if (!eina_streq(rem->uuid, ec->uuid)) continue;
-             if (rem->uuid)
-               {
-                  if (rem->pid != ec->netwm.pid) continue;
-                  return rem;
-               }
+             if (rem->pid != ec->netwm.pid) continue;
+             return rem;
           }
-        else if (rem->apply & E_REMEMBER_APPLY_UUID) continue;
-
-        if (ec->netwm.name) title = ec->netwm.name;
-        else title = ec->icccm.title;
-
-        /* For each type of match, check whether the match is
-         * required, and if it is, check whether there's a match. If
-         * it fails, then go to the next remember */
-        if (rem->match & E_REMEMBER_MATCH_NAME &&
-            !e_util_glob_match(ec->icccm.name, rem->name))
-          continue;
-        if (rem->match & E_REMEMBER_MATCH_CLASS &&
-            !e_util_glob_match(ec->icccm.class, rem->class))
-          continue;
-        if (rem->match & E_REMEMBER_MATCH_TITLE &&
-            !e_util_glob_match(title, rem->title))
-          continue;
-        if (rem->match & E_REMEMBER_MATCH_ROLE &&
-            e_util_strcmp(rem->role, ec->icccm.window_role) &&
-            !e_util_both_str_empty(rem->role, ec->icccm.window_role))
-          continue;
-        if (rem->match & E_REMEMBER_MATCH_TYPE &&
-            rem->type != (int)ec->netwm.type)
-          continue;
-        if (rem->match & E_REMEMBER_MATCH_TRANSIENT &&
-            !(rem->transient && ec->icccm.transient_for != 0) &&
-            !(!rem->transient) && (ec->icccm.transient_for == 0))
-          continue;
 
-        return rem;
+        if (_e_remember_match(rem, ec)) return rem;
      }
 
    return NULL;
@@ -963,6 +1190,7 @@ static void
 _e_remember_free(E_Remember *rem)
 {
    e_config->remembers = eina_list_remove(e_config->remembers, rem);
+   remember_index_dirty = EINA_TRUE;
    if (rem->name) eina_stringshare_del(rem->name);
    if (rem->class) eina_stringshare_del(rem->class);
    if (rem->title) eina_stringshare_del(rem->title);
@@ -27,6 +27,18 @@ deskmirror_test(void *d EINA_UNUSED)
 
 #endif
 
+#if defined(PLACE_TEST) && defined(ENABLE_BENCH)
+
+static Eina_Bool
+place_test(void *d EINA_UNUSED)
+{
+   /* 3 8k screens side by side */
+   e_place_bench(1000, 3 * 7680, 4320);
+   return EINA_FALSE;
+}
+
+#endif
+
 E_API void
 e_test(void)
 {
@@ -35,6 +47,9 @@ e_test(void)
 #ifdef DESKMIRROR_TEST
    ecore_timer_loop_add(2.0, deskmirror_test, NULL);
 #endif
+#if defined(PLACE_TEST) && defined(ENABLE_BENCH)
+   ecore_timer_loop_add(2.0, place_test, NULL);
+#endif
 }
 
 #if 0
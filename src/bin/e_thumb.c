@@ -1,6 +1,20 @@
 #include "e.h"
 
 typedef struct _E_Thumb E_Thumb;
+typedef struct _E_Thumb_Worker E_Thumb_Worker;
+
+/* how many requests each thumbnailer may hold at once. keep this small so */
+/* the queue order (and cancels) stay on our side where they are cheap */
+#define E_THUMB_WORKER_JOBS 2
+#define E_THUMB_WORKERS_MAX 8
+/* thumbnail cache size cap in MB, least recently used thumbs go first */
+#define E_THUMB_CACHE_MAX   512
+
+struct _E_Thumb_Worker
+{
+   Ecore_Ipc_Client *cli;
+   Eina_List        *jobs;
+};
 
 struct _E_Thumb
 {
@@ -13,14 +27,24 @@ struct _E_Thumb
       int x, y, x_count, y_count;
    } desk_pan;
    Eina_List    *sigsrc;
+   E_Thumb_Worker *worker;
+   const char   *thumb;
    unsigned char queued E_BITFIELD;
+   unsigned char hit E_BITFIELD;
    unsigned char busy E_BITFIELD;
    unsigned char done E_BITFIELD;
 };
 
 /* local subsystem functions */
-static void         _e_thumb_gen_begin(int objid, const char *file, const char *key, int w, int h, int desk_x, int desk_y, int desk_x_count, int desk_y_count, Eina_List *sigsrc);
-static void         _e_thumb_gen_end(int objid);
+static void         _e_thumb_gen_begin(E_Thumb_Worker *w, E_Thumb *eth);
+static void         _e_thumb_gen_end(E_Thumb *eth);
+static void         _e_thumb_cancel(E_Thumb *eth);
+static void         _e_thumb_queue_run(void);
+static E_Thumb_Worker *_e_thumb_worker_find(Ecore_Ipc_Client *cli);
+static void         _e_thumb_thumbnailers_spawn(void);
+static Eina_Bool    _e_thumb_cache_check(E_Thumb *eth);
+static void         _e_thumb_cache_set(const char *thumb, time_t mtime);
+static void         _e_thumb_cb_hits(void *data);
 static void         _e_thumb_del_hook(void *data, Evas *e, Evas_Object *obj, void *event_info);
 static void         _e_thumb_hash_add(int objid, Evas_Object *obj);
 static void         _e_thumb_hash_del(int objid);
@@ -40,6 +64,11 @@ static int _pending = 0;
 static int _num_thumbnailers = 1;
 static Ecore_Event_Handler *_exe_del_handler = NULL;
 static Ecore_Timer *_kill_timer = NULL;
+/* thumb path -> mtime of thumbs we have seen, saves a stat per lookup */
+static Eina_Hash *_thumb_index = NULL;
+static Eina_List *_thumb_hits = NULL;
+static Ecore_Job *_thumb_hits_job = NULL;
+static Eina_Bool _thumb_trimmed = EINA_FALSE;
 
 /* externally accessible functions */
 EINTERN int
@@ -48,20 +77,42 @@ e_thumb_init(void)
    _exe_del_handler = ecore_event_handler_add(ECORE_EXE_EVENT_DEL,
                                               _e_thumb_cb_exe_event_del,
                                               NULL);
+   /* one thumbnailer process per core. evas canvases are not thread safe */
+   /* so processes are how we get thumbs decoding in parallel */
+   _num_thumbnailers = eina_cpu_count();
+   if (_num_thumbnailers < 1) _num_thumbnailers = 1;
+   else if (_num_thumbnailers > E_THUMB_WORKERS_MAX)
+     _num_thumbnailers = E_THUMB_WORKERS_MAX;
    _thumbs = eina_hash_string_superfast_new(NULL);
+   _thumb_index = eina_hash_string_superfast_new(free);
    return 1;
 }
 
 EINTERN int
 e_thumb_shutdown(void)
 {
+   E_Thumb_Worker *w;
+   E_Thumb *eth;
+
    _e_thumb_thumbnailers_kill_cancel();
    _e_thumb_cb_kill(NULL);
    if (_exe_del_handler) ecore_event_handler_del(_exe_del_handler);
    _exe_del_handler = NULL;
-   _thumbnailers = eina_list_free(_thumbnailers);
+   EINA_LIST_FREE(_thumbnailers, w)
+     {
+        EINA_LIST_FREE(w->jobs, eth)
+          {
+             eth->worker = NULL;
+             eth->busy = 0;
+          }
+        free(w);
+     }
    E_FREE_LIST(_thumbnailers_exe, ecore_exe_free);
    _thumb_queue = eina_list_free(_thumb_queue);
+   E_FREE_FUNC(_thumb_hits_job, ecore_job_del);
+   _thumb_hits = eina_list_free(_thumb_hits);
+   E_FREE_FUNC(_thumb_index, eina_hash_free);
+   _thumb_trimmed = EINA_FALSE;
    _objid = 0;
    eina_hash_free(_thumbs);
    _thumbs = NULL;
@@ -104,6 +155,7 @@ e_thumb_icon_file_set(Evas_Object *obj, const char *file, const char *key)
    if (!eth) return;
    eina_stringshare_replace(&eth->file, file);
    eina_stringshare_replace(&eth->key, key);
+   eina_stringshare_replace(&eth->thumb, NULL);
    E_FREE(eth->sort_id);
 }
 
@@ -115,6 +167,8 @@ e_thumb_icon_size_set(Evas_Object *obj, int w, int h)
    eth = evas_object_data_get(obj, "e_thumbdata");
    if (!eth) return;
    if ((w < 1) || (h < 1)) return;
+   if ((eth->w != w) || (eth->h != h))
+     eina_stringshare_replace(&eth->thumb, NULL);
    eth->w = w;
    eth->h = h;
 }
@@ -122,50 +176,30 @@ e_thumb_icon_size_set(Evas_Object *obj, int w, int h)
 E_API void
 e_thumb_icon_begin(Evas_Object *obj)
 {
-   E_Thumb *eth, *eth2;
-   char buf[4096];
+   E_Thumb *eth;
 
    eth = evas_object_data_get(obj, "e_thumbdata");
    if (!eth) return;
    if (eth->queued) return;
    if (eth->busy) return;
+   if (eth->hit) return;
    if (eth->done) return;
    if (!eth->file) return;
-   if (!_thumbnailers)
+   if (_e_thumb_cache_check(eth))
      {
-        while ((int)eina_list_count(_thumbnailers_exe) < _num_thumbnailers)
-          {
-             Ecore_Exe *exe;
-
-             snprintf(buf, sizeof(buf), "%s/enlightenment/utils/enlightenment_thumb --nice=%d", e_prefix_lib_get(),
-                      e_config->thumb_nice);
-             exe = e_util_exe_safe_run(buf, NULL);
-             _thumbnailers_exe = eina_list_append(_thumbnailers_exe, exe);
-          }
-        _thumb_queue = eina_list_append(_thumb_queue, eth);
-        eth->queued = 1;
+        /* already thumbed and still valid - no need for a round trip */
+        eth->hit = 1;
+        _thumb_hits = eina_list_append(_thumb_hits, eth);
+        if (!_thumb_hits_job)
+          _thumb_hits_job = ecore_job_add(_e_thumb_cb_hits, NULL);
         return;
      }
-   EINA_LIST_FREE(_thumb_queue, eth2)
-     {
-        eth2->queued = 0;
-        eth2->busy = 1;
-        _pending++;
-        if (_pending == 1) _e_thumb_thumbnailers_kill_cancel();
-        _e_thumb_gen_begin(eth2->objid, eth2->file, eth2->key,
-                           eth2->w, eth2->h,
-                           eth2->desk_pan.x, eth2->desk_pan.y,
-                           eth2->desk_pan.x_count, eth2->desk_pan.y_count,
-                           eth2->sigsrc);
-     }
-   eth->busy = 1;
+   _e_thumb_thumbnailers_spawn();
+   _thumb_queue = eina_list_append(_thumb_queue, eth);
+   eth->queued = 1;
    _pending++;
    if (_pending == 1) _e_thumb_thumbnailers_kill_cancel();
-   _e_thumb_gen_begin(eth->objid, eth->file, eth->key,
-                      eth->w, eth->h,
-                      eth->desk_pan.x, eth->desk_pan.y,
-                      eth->desk_pan.x_count, eth->desk_pan.y_count,
-                      eth->sigsrc);
+   _e_thumb_queue_run();
 }
 
 E_API void
@@ -175,18 +209,7 @@ e_thumb_icon_end(Evas_Object *obj)
 
    eth = evas_object_data_get(obj, "e_thumbdata");
    if (!eth) return;
-   if (eth->queued)
-     {
-        _thumb_queue = eina_list_remove(_thumb_queue, eth);
-        eth->queued = 0;
-     }
-   if (eth->busy)
-     {
-        _e_thumb_gen_end(eth->objid);
-        eth->busy = 0;
-        _pending--;
-        if (_pending == 0) _e_thumb_thumbnailers_kill();
-     }
+   _e_thumb_cancel(eth);
 }
 
 E_API void
@@ -222,6 +245,7 @@ e_thumb_signal_add(Evas_Object *obj, const char *sig, const char *src)
    if (!eth) return;
    eth->sigsrc = eina_list_append(eth->sigsrc, eina_stringshare_add(sig));
    eth->sigsrc = eina_list_append(eth->sigsrc, eina_stringshare_add(src));
+   eina_stringshare_replace(&eth->thumb, NULL);
 }
 
 #define A(v)          (((v) >> 24) & 0xff)
@@ -268,10 +292,29 @@ e_thumb_client_data(Ecore_Ipc_Event_Client_Data *e)
    int objid;
    char *icon;
    E_Thumb *eth;
+   E_Thumb_Worker *w;
    Evas_Object *obj;
+   time_t mtime;
 
-   if (!eina_list_data_find(_thumbnailers, e->client))
-     _thumbnailers = eina_list_prepend(_thumbnailers, e->client);
+   w = _e_thumb_worker_find(e->client);
+   if (!w)
+     {
+        w = E_NEW(E_Thumb_Worker, 1);
+        w->cli = e->client;
+        _thumbnailers = eina_list_prepend(_thumbnailers, w);
+        /* one thumbnailer per session keeps the cache under its cap */
+        if (!_thumb_trimmed)
+          {
+             ecore_ipc_client_send(w->cli, E_IPC_DOMAIN_THUMB, 4,
+                                   E_THUMB_CACHE_MAX, 0, 0, NULL, 0);
+             _thumb_trimmed = EINA_TRUE;
+          }
+     }
+   if (e->minor == 3)
+     {
+        /* cache was trimmed - what we remember may be gone now */
+        if (_thumb_index) eina_hash_free_buckets(_thumb_index);
+     }
    if (e->minor == 2)
      {
         objid = e->ref;
@@ -282,14 +325,19 @@ e_thumb_client_data(Ecore_Ipc_Event_Client_Data *e)
              if (obj)
                {
                   eth = evas_object_data_get(obj, "e_thumbdata");
-                  if (eth)
+                  /* a reply for a request we already cancelled is stale */
+                  if ((eth) && (eth->busy) && (eth->worker == w))
                     {
+                       w->jobs = eina_list_remove(w->jobs, eth);
+                       eth->worker = NULL;
                        eth->busy = 0;
                        _pending--;
                        eth->done = 1;
                        if (_pending == 0) _e_thumb_thumbnailers_kill();
-                       if (ecore_file_exists(icon))
+                       mtime = ecore_file_mod_time(icon);
+                       if (mtime > 0)
                          {
+                            _e_thumb_cache_set(icon, mtime);
                             e_icon_preload_set(obj, 1);
                             e_icon_file_key_set(obj, icon, "/thumbnail/data");
                             _e_thumb_key_load(eth, icon);
@@ -299,53 +347,51 @@ e_thumb_client_data(Ecore_Ipc_Event_Client_Data *e)
                }
           }
      }
-   if (e->minor == 1)
-     {
-        /* hello message */
-        EINA_LIST_FREE(_thumb_queue, eth)
-          {
-             eth->queued = 0;
-             eth->busy = 1;
-             _pending++;
-             if (_pending == 1) _e_thumb_thumbnailers_kill_cancel();
-             _e_thumb_gen_begin(eth->objid, eth->file, eth->key,
-                                eth->w, eth->h,
-                                eth->desk_pan.x, eth->desk_pan.y,
-                                eth->desk_pan.x_count, eth->desk_pan.y_count,
-                                eth->sigsrc);
-          }
-     }
+   /* minor 1 is the hello message - this worker is now ready for work */
+   _e_thumb_queue_run();
 }
 
 E_API void
 e_thumb_client_del(Ecore_Ipc_Event_Client_Del *e)
 {
-   if (!eina_list_data_find(_thumbnailers, e->client)) return;
-   _thumbnailers = eina_list_remove(_thumbnailers, e->client);
+   E_Thumb_Worker *w;
+   E_Thumb *eth;
+
+   w = _e_thumb_worker_find(e->client);
+   if (!w) return;
+   _thumbnailers = eina_list_remove(_thumbnailers, w);
+   /* put whatever it was working on back at the head of the queue */
+   EINA_LIST_FREE(w->jobs, eth)
+     {
+        eth->worker = NULL;
+        eth->busy = 0;
+        eth->queued = 1;
+        _thumb_queue = eina_list_prepend(_thumb_queue, eth);
+     }
+   free(w);
    if ((!_thumbs) && (!_thumbnailers)) _objid = 0;
+   if (_thumb_queue) _e_thumb_thumbnailers_spawn();
+   _e_thumb_queue_run();
 }
 
 /* local subsystem functions */
 static void
-_e_thumb_gen_begin(int objid, const char *file, const char *key, int w, int h,
-                   int desk_x, int desk_y, int desk_x_count, int desk_y_count,
-                   Eina_List *sigsrc)
+_e_thumb_gen_begin(E_Thumb_Worker *w, E_Thumb *eth)
 {
    char *buf, *p;
    int l1, l2, size, *desk;
-   Ecore_Ipc_Client *cli;
    Eina_List *l;
    const char *s;
 
    /* send thumb req */
    // figure out buffer size needed
-   l1 = strlen(file);
+   l1 = strlen(eth->file);
    l2 = 0;
-   if (key) l2 = strlen(key);
+   if (eth->key) l2 = strlen(eth->key);
    size = (4 * sizeof(int)); // desk_x/y/count
    size += l1 + 1; // file
    size += l2 + 1; // key
-   EINA_LIST_FOREACH(sigsrc, l, s)
+   EINA_LIST_FOREACH(eth->sigsrc, l, s)
      {
         size += strlen(s) + 1;
      }
@@ -367,16 +413,16 @@ _e_thumb_gen_begin(int objid, const char *file, const char *key, int w, int h,
    //  [char[]]src2
    //  ...
    desk = (int *)(void *)buf;
-   desk[0] = desk_x;
-   desk[1] = desk_y;
-   desk[2] = desk_x_count;
-   desk[3] = desk_y_count;
+   desk[0] = eth->desk_pan.x;
+   desk[1] = eth->desk_pan.y;
+   desk[2] = eth->desk_pan.x_count;
+   desk[3] = eth->desk_pan.y_count;
    p += (4 * sizeof(int));
-   strcpy(p, file);
+   strcpy(p, eth->file);
    p += l1 + 1;
-   if (key)
+   if (eth->key)
      {
-        strcpy(p, key);
+        strcpy(p, eth->key);
         p += l2 + 1;
      }
    else
@@ -384,30 +430,112 @@ _e_thumb_gen_begin(int objid, const char *file, const char *key, int w, int h,
         p[0] = 0;
         p += 1;
      }
-   EINA_LIST_FOREACH(sigsrc, l, s)
+   EINA_LIST_FOREACH(eth->sigsrc, l, s)
      {
         strcpy(p, s);
         p += strlen(s) + 1;
      }
 
    // actually send it off
-   cli = eina_list_data_get(_thumbnailers);
-   if (!cli) return;
-   _thumbnailers = eina_list_remove_list(_thumbnailers, _thumbnailers);
-   _thumbnailers = eina_list_append(_thumbnailers, cli);
-   ecore_ipc_client_send(cli, E_IPC_DOMAIN_THUMB, 1, objid, w, h, buf, size);
+   eth->worker = w;
+   eth->busy = 1;
+   w->jobs = eina_list_append(w->jobs, eth);
+   ecore_ipc_client_send(w->cli, E_IPC_DOMAIN_THUMB, 1, eth->objid,
+                         eth->w, eth->h, buf, size);
+}
+
+static void
+_e_thumb_gen_end(E_Thumb *eth)
+{
+   E_Thumb_Worker *w = eth->worker;
+
+   if (!w) return;
+   /* send thumb cancel - only the thumbnailer that has it needs to know */
+   ecore_ipc_client_send(w->cli, E_IPC_DOMAIN_THUMB, 2, eth->objid, 0, 0, NULL, 0);
+   w->jobs = eina_list_remove(w->jobs, eth);
+   eth->worker = NULL;
+}
+
+static void
+_e_thumb_cancel(E_Thumb *eth)
+{
+   if (eth->hit)
+     {
+        _thumb_hits = eina_list_remove(_thumb_hits, eth);
+        eth->hit = 0;
+     }
+   if (eth->queued)
+     {
+        _thumb_queue = eina_list_remove(_thumb_queue, eth);
+        eth->queued = 0;
+        _pending--;
+        if (_pending == 0) _e_thumb_thumbnailers_kill();
+     }
+   if (eth->busy)
+     {
+        _e_thumb_gen_end(eth);
+        eth->busy = 0;
+        _pending--;
+        if (_pending == 0) _e_thumb_thumbnailers_kill();
+        _e_thumb_queue_run();
+     }
 }
 
 static void
-_e_thumb_gen_end(int objid)
+_e_thumb_queue_run(void)
 {
+   E_Thumb_Worker *w, *w_idle;
+   E_Thumb *eth;
    Eina_List *l;
-   Ecore_Ipc_Client *cli;
 
-   /* send thumb cancel */
-   EINA_LIST_FOREACH(_thumbnailers, l, cli)
+   /* hand queued requests, oldest first, to the least loaded thumbnailer. */
+   /* anything scrolled out of view is cancelled while still queued here, */
+   /* so what is visible now gets to a thumbnailer first */
+   while (_thumb_queue)
      {
-        ecore_ipc_client_send(cli, E_IPC_DOMAIN_THUMB, 2, objid, 0, 0, NULL, 0);
+        w_idle = NULL;
+        EINA_LIST_FOREACH(_thumbnailers, l, w)
+          {
+             if ((!w_idle) ||
+                 (eina_list_count(w->jobs) < eina_list_count(w_idle->jobs)))
+               w_idle = w;
+          }
+        if (!w_idle) break;
+        if (eina_list_count(w_idle->jobs) >= E_THUMB_WORKER_JOBS) break;
+        eth = eina_list_data_get(_thumb_queue);
+        _thumb_queue = eina_list_remove_list(_thumb_queue, _thumb_queue);
+        eth->queued = 0;
+        _e_thumb_gen_begin(w_idle, eth);
+     }
+}
+
+static E_Thumb_Worker *
+_e_thumb_worker_find(Ecore_Ipc_Client *cli)
+{
+   E_Thumb_Worker *w;
+   Eina_List *l;
+
+   EINA_LIST_FOREACH(_thumbnailers, l, w)
+     {
+        if (w->cli == cli) return w;
+     }
+   return NULL;
+}
+
+static void
+_e_thumb_thumbnailers_spawn(void)
+{
+   char buf[4096];
+
+   while ((int)eina_list_count(_thumbnailers_exe) < _num_thumbnailers)
+     {
+        Ecore_Exe *exe;
+
+        snprintf(buf, sizeof(buf), "%s/enlightenment/utils/enlightenment_thumb --nice=%d", e_prefix_lib_get(),
+                 e_config->thumb_nice);
+        exe = e_util_exe_safe_run(buf, NULL);
+        if (!exe) break;
+        _thumbnailers_exe = eina_list_append(_thumbnailers_exe, exe);
      }
 }
 
@@ -421,22 +549,78 @@ _e_thumb_del_hook(void *data EINA_UNUSED, Evas *e EINA_UNUSED, Evas_Object *obj,
    if (!eth) return;
    evas_object_data_del(obj, "e_thumbdata");
    _e_thumb_hash_del(eth->objid);
-   if (eth->busy)
-     {
-        _e_thumb_gen_end(eth->objid);
-        eth->busy = 0;
-        _pending--;
-        if (_pending == 0) _e_thumb_thumbnailers_kill();
-     }
-   if (eth->queued)
-     _thumb_queue = eina_list_remove(_thumb_queue, eth);
+   _e_thumb_cancel(eth);
    if (eth->file) eina_stringshare_del(eth->file);
    if (eth->key) eina_stringshare_del(eth->key);
+   if (eth->thumb) eina_stringshare_del(eth->thumb);
    free(eth->sort_id);
    EINA_LIST_FREE(eth->sigsrc, s) eina_stringshare_del(s);
    free(eth);
 }
 
+static Eina_Bool
+_e_thumb_cache_check(E_Thumb *eth)
+{
+   char buf[PATH_MAX];
+   time_t *cached, mtime_orig, mtime_thumb;
+
+   if (!eth->thumb)
+     {
+        if (!e_thumb_cache_path_get(buf, sizeof(buf), eth->file, eth->key,
+                                    eth->w, eth->h, eth->sigsrc))
+          return EINA_FALSE;
+        eth->thumb = eina_stringshare_add(buf);
+     }
+   mtime_orig = ecore_file_mod_time(eth->file);
+   if (mtime_orig <= 0) return EINA_FALSE;
+   cached = eina_hash_find(_thumb_index, eth->thumb);
+   if (cached) mtime_thumb = *cached;
+   else
+     {
+        mtime_thumb = ecore_file_mod_time(eth->thumb);
+        if (mtime_thumb <= 0) return EINA_FALSE;
+        _e_thumb_cache_set(eth->thumb, mtime_thumb);
+     }
+   /* same rule as enlightenment_thumb uses to decide to regenerate */
+   return mtime_thumb > mtime_orig;
+}
+
+static void
+_e_thumb_cache_set(const char *thumb, time_t mtime)
+{
+   time_t *cached;
+
+   if (!_thumb_index) return;
+   cached = eina_hash_find(_thumb_index, thumb);
+   if (!cached)
+     {
+        cached = malloc(sizeof(time_t));
+        if (!cached) return;
+        eina_hash_add(_thumb_index, thumb, cached);
+     }
+   *cached = mtime;
+}
+
+static void
+_e_thumb_cb_hits(void *data EINA_UNUSED)
+{
+   E_Thumb *eth;
+   Evas_Object *obj;
+
+   _thumb_hits_job = NULL;
+   EINA_LIST_FREE(_thumb_hits, eth)
+     {
+        eth->hit = 0;
+        obj = _e_thumb_hash_find(eth->objid);
+        if (!obj) continue;
+        eth->done = 1;
+        e_icon_preload_set(obj, 1);
+        e_icon_file_key_set(obj, eth->thumb, "/thumbnail/data");
+        _e_thumb_key_load(eth, eth->thumb);
+        evas_object_smart_callback_call(obj, "e_thumb_gen", NULL);
+     }
+}
+
 static void
 _e_thumb_hash_add(int objid, Evas_Object *obj)
 {
@@ -508,18 +692,7 @@ _e_thumb_cb_exe_event_del(void *data EINA_UNUSED, int type EINA_UNUSED, void *ev
           }
      }
    if ((!_thumbnailers_exe) && (_thumb_queue))
-     {
-        while ((int)eina_list_count(_thumbnailers_exe) < _num_thumbnailers)
-          {
-             Ecore_Exe *exe_thumb;
-             char buf[4096];
-
-             snprintf(buf, sizeof(buf), "%s/enlightenment/utils/enlightenment_thumb --nice=%d", e_prefix_lib_get(),
-                      e_config->thumb_nice);
-             exe_thumb = e_util_exe_safe_run(buf, NULL);
-             _thumbnailers_exe = eina_list_append(_thumbnailers_exe, exe_thumb);
-          }
-     }
+     _e_thumb_thumbnailers_spawn();
    return ECORE_CALLBACK_PASS_ON;
 }
 
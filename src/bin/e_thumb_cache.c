@@ -0,0 +1,56 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdio.h>
+#include <string.h>
+#include <Eina.h>
+
+#include "e_macros.h"
+#include "e_sha1.h"
+#include "e_user.h"
+#include "e_thumb_cache.h"
+
+static char _e_thumb_cache_dir[4096] = "";
+
+/* externally accessible functions */
+E_API size_t
+e_thumb_cache_path_get(char *dst, size_t size, const char *file, const char *key, int w, int h, const Eina_List *sigsrc)
+{
+   const char *chmap = "0123456789abcdef", *str;
+   const Eina_List *l;
+   Eina_Strbuf *sbuf;
+   unsigned char id[20];
+   char s[41];
+   int i, n;
+
+   if (!_e_thumb_cache_dir[0])
+     e_user_dir_concat_static(_e_thumb_cache_dir, "fileman/thumbnails");
+
+   sbuf = eina_strbuf_new();
+   if (!sbuf) return 0;
+   EINA_LIST_FOREACH(sigsrc, l, str)
+     {
+        eina_strbuf_append_printf(sbuf, "<<%s>>", str);
+     }
+   /* desk pan is not part of the id - see _e_thumb_generate() */
+   eina_strbuf_append_printf(sbuf, "|%i.%i.%i.%i|", 0, 0, 1, 1);
+   eina_strbuf_append_printf(sbuf, "///%s", file);
+   if (key) eina_strbuf_append_printf(sbuf, "/%s", key);
+
+   e_sha1_sum((unsigned char *)eina_strbuf_string_get(sbuf),
+              eina_strbuf_length_get(sbuf), id);
+   eina_strbuf_free(sbuf);
+
+   for (i = 0; i < 20; i++)
+     {
+        s[(i * 2) + 0] = chmap[(id[i] >> 4) & 0xf];
+        s[(i * 2) + 1] = chmap[(id[i]) & 0xf];
+     }
+   s[(i * 2)] = 0;
+
+   /* first 2 hex digits pick the shard directory */
+   n = snprintf(dst, size, "%s/%c%c/%s-%ix%i.thm",
+                _e_thumb_cache_dir, s[0], s[1], s + 2, w, h);
+   if ((n < 0) || ((size_t)n >= size)) return 0;
+   return n;
+}
@@ -0,0 +1,11 @@
+#ifdef E_TYPEDEFS
+#else
+#ifndef E_THUMB_CACHE_H
+#define E_THUMB_CACHE_H
+
+/* shared by enlightenment and enlightenment_thumb so both agree on where */
+/* the thumbnail for a given file lives without having to ask each other */
+E_API size_t e_thumb_cache_path_get(char *dst, size_t size, const char *file, const char *key, int w, int h, const Eina_List *sigsrc);
+
+#endif
+#endif
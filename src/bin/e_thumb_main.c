@@ -29,8 +29,10 @@ void *alloca(size_t);
 #include <Eet.h>
 #include <Edje.h>
 #include <Emotion.h>
+#include <sys/stat.h>
 #include "e_sha1.h"
 #include "e_user.h"
+#include "e_thumb_cache.h"
 
 typedef struct _E_Thumb E_Thumb;
 
@@ -56,20 +58,17 @@ static Eina_Bool _e_ipc_cb_server_data(void *data,
                                        int type,
                                        void *event);
 static Eina_Bool _e_cb_idle_enterer(void *data);
+static void      _cb_wakeup(void *data);
 static void      _e_thumb_generate(E_Thumb *eth);
-static char     *_e_thumb_file_id(char *file,
-                                  char *key,
-                                  int desk_x,
-                                  int desk_y,
-                                  int desk_x_count,
-                                  int desk_y_count,
-                                  Eina_List *sigsrc);
+static void      _e_thumb_cache_trim(unsigned long long max);
 
 /* local subsystem globals */
 static Ecore_Idle_Enterer *_idle_enterer = NULL;
 static Ecore_Ipc_Server *_e_ipc_server = NULL;
 static Eina_List *_thumblist = NULL;
 static char _thumbdir[4096] = "";
+static Ecore_Evas *_thumb_ee = NULL;
+static unsigned long long _thumb_trim_max = 0;
 
 /* externally accessible functions */
 int
@@ -116,13 +115,29 @@ main(int argc,
    e_user_dir_concat_static(_thumbdir, "fileman/thumbnails");
    ecore_file_mkpath(_thumbdir);
 
+   /* one canvas for the life of the thumbnailer - every thumb source is */
+   /* different so caching images or fonts between them buys nothing */
+   edje_file_cache_set(0);
+   edje_collection_cache_set(0);
+   _thumb_ee = ecore_evas_buffer_new(1, 1);
+   if (_thumb_ee)
+     {
+        evas_image_cache_set(ecore_evas_get(_thumb_ee), 0);
+        evas_font_cache_set(ecore_evas_get(_thumb_ee), 0);
+     }
+
    _idle_enterer = ecore_idle_enterer_add(_e_cb_idle_enterer, NULL);
    if (_idle_enterer)
      {
-        if (_e_ipc_init()) ecore_main_loop_begin();
+        if ((_thumb_ee) && (_e_ipc_init())) ecore_main_loop_begin();
         ecore_idle_enterer_del(_idle_enterer);
         _idle_enterer = NULL;
      }
+   if (_thumb_ee)
+     {
+        ecore_evas_free(_thumb_ee);
+        _thumb_ee = NULL;
+     }
 
    if (_e_ipc_server)
      {
@@ -270,6 +285,15 @@ _e_ipc_cb_server_data(void *data EINA_UNUSED,
         ecore_main_loop_quit();
         break;
 
+      case 4:
+        /* trim cache down to ref MB once the queue is empty */
+        if (e->ref > 0)
+          {
+             _thumb_trim_max = (unsigned long long)e->ref * 1024 * 1024;
+             ecore_job_add(_cb_wakeup, NULL);
+          }
+        break;
+
       default:
         break;
      }
@@ -298,7 +322,13 @@ _e_cb_idle_enterer(void *data EINA_UNUSED)
         free(eth->file);
         free(eth->key);
         free(eth);
-        if (_thumblist) ecore_job_add(_cb_wakeup, NULL);
+        if ((_thumblist) || (_thumb_trim_max)) ecore_job_add(_cb_wakeup, NULL);
+     }
+   else if (_thumb_trim_max)
+     {
+        _e_thumb_cache_trim(_thumb_trim_max);
+        _thumb_trim_max = 0;
+        ecore_ipc_server_send(_e_ipc_server, 5, 3, 0, 0, 0, NULL, 0);
      }
    return ECORE_CALLBACK_RENEW;
 }
@@ -316,7 +346,7 @@ struct _Color
 static void
 _e_thumb_generate(E_Thumb *eth)
 {
-   char buf[PATH_MAX + 200], dbuf[PATH_MAX + 2], *id, *td, *ext = NULL;
+   char buf[PATH_MAX + 200], dbuf[PATH_MAX + 2], *p, *ext = NULL;
    Evas *evas = NULL, *evas_im = NULL;
    Ecore_Evas *ee = NULL, *ee_im = NULL;
    Evas_Object *im = NULL, *edje = NULL;
@@ -325,26 +355,13 @@ _e_thumb_generate(E_Thumb *eth)
    const unsigned int *data = NULL;
    time_t mtime_orig, mtime_thumb;
 
-   id = _e_thumb_file_id(eth->file, eth->key,
-                         0, 0, 1, 1,
-//                         eth->desk_x, eth->desk_y,
-//                         eth->desk_x_count, eth->desk_y_count,
-                         eth->sigsrc);
-   if (!id) return;
-
-   td = strdup(id);
-   if (!td)
-     {
-        free(id);
-        return;
-     }
-   td[2] = 0;
-
-   snprintf(dbuf, sizeof(dbuf), "%s/%s", _thumbdir, td);
-   snprintf(buf, sizeof(buf), "%s/%s/%s-%ix%i.thm",
-            _thumbdir, td, id + 2, eth->w, eth->h);
-   free(id);
-   free(td);
+   /* desk pan is left out of the id on purpose so all pans share a thumb */
+   if (!e_thumb_cache_path_get(buf, sizeof(buf), eth->file, eth->key,
+                               eth->w, eth->h, eth->sigsrc))
+     return;
+   eina_strlcpy(dbuf, buf, sizeof(dbuf));
+   p = strrchr(dbuf, '/');
+   if (p) *p = 0;
 
    mtime_orig = ecore_file_mod_time(eth->file);
    mtime_thumb = ecore_file_mod_time(buf);
@@ -360,12 +377,8 @@ _e_thumb_generate(E_Thumb *eth)
 
         ecore_file_mkdir(dbuf);
 
-        edje_file_cache_set(0);
-        edje_collection_cache_set(0);
-        ee = ecore_evas_buffer_new(1, 1);
+        ee = _thumb_ee;
         evas = ecore_evas_get(ee);
-        evas_image_cache_set(evas, 0);
-        evas_font_cache_set(evas, 0);
         ww = 0;
         hh = 0;
         alpha = 1;
@@ -689,7 +702,8 @@ end:
         else if (im) evas_object_del(im);
         if (im2) evas_object_del(im2);
         if (bg) evas_object_del(bg);
-        ecore_evas_free(ee);
+        /* keep the canvas around for the next thumb, just drop its buffer */
+        ecore_evas_resize(ee, 1, 1);
         eet_clearcache();
         break;
      }
@@ -697,43 +711,76 @@ end:
    ecore_ipc_server_send(_e_ipc_server, 5, 2, eth->objid, 0, 0, buf, strlen(buf) + 1);
 }
 
-static char *
-_e_thumb_file_id(char *file,
-                 char *key,
-                 int desk_x,
-                 int desk_y,
-                 int desk_x_count,
-                 int desk_y_count,
-                 Eina_List *sigsrc)
+typedef struct _E_Thumb_Cache_File E_Thumb_Cache_File;
+
+struct _E_Thumb_Cache_File
 {
-   char s[64];
-   const char *chmap = "0123456789abcdef", *str;
-   unsigned char id[20], *st;
-   Eina_Strbuf *sbuf;
-   int i;
-   Eina_List *l;
+   char              *path;
+   time_t             used;
+   unsigned long long size;
+};
 
-   sbuf = eina_strbuf_new();
-   EINA_LIST_FOREACH(sigsrc, l, str)
-     {
-        eina_strbuf_append_printf(sbuf, "<<%s>>", str);
-     }
-   eina_strbuf_append_printf(sbuf, "|%i.%i.%i.%i|",
-                             desk_x, desk_y, desk_x_count, desk_y_count);
-   eina_strbuf_append_printf(sbuf, "///%s", file);
-   if (key) eina_strbuf_append_printf(sbuf, "/%s", key);
+static int
+_e_thumb_cache_file_cmp(const void *d1, const void *d2)
+{
+   const E_Thumb_Cache_File *f1 = d1, *f2 = d2;
 
-   st = (unsigned char *)eina_strbuf_string_get(sbuf);
-   e_sha1_sum(st, eina_strbuf_length_get(sbuf), id);
+   if (f1->used < f2->used) return -1;
+   if (f1->used > f2->used) return 1;
+   return 0;
+}
 
-   for (i = 0; i < 20; i++)
+static void
+_e_thumb_cache_trim(unsigned long long max)
+{
+   Eina_Iterator *it, *it2;
+   Eina_File_Direct_Info *info, *info2;
+   Eina_List *files = NULL;
+   E_Thumb_Cache_File *cf;
+   unsigned long long total = 0;
+   struct stat st;
+
+   /* the cache is <thumbdir>/<xx>/<id>.thm. least recently used is the */
+   /* newer of atime and mtime - rethumbing bumps mtime, showing a cached */
+   /* thumb bumps atime (coarsely under relatime, which is fine here) */
+   it = eina_file_direct_ls(_thumbdir);
+   if (!it) return;
+   EINA_ITERATOR_FOREACH(it, info)
      {
-        s[(i * 2) + 0] = chmap[(id[i] >> 4) & 0xf];
-        s[(i * 2) + 1] = chmap[(id[i]) & 0xf];
+        if (info->type != EINA_FILE_DIR) continue;
+        it2 = eina_file_direct_ls(info->path);
+        if (!it2) continue;
+        EINA_ITERATOR_FOREACH(it2, info2)
+          {
+             if (!eina_str_has_extension(info2->path, ".thm")) continue;
+             if (stat(info2->path, &st) != 0) continue;
+             if (!S_ISREG(st.st_mode)) continue;
+             cf = malloc(sizeof(E_Thumb_Cache_File));
+             if (!cf) continue;
+             cf->path = strdup(info2->path);
+             cf->used = (st.st_atime > st.st_mtime) ? st.st_atime : st.st_mtime;
+             cf->size = st.st_size;
+             total += cf->size;
+             files = eina_list_append(files, cf);
+          }
+        eina_iterator_free(it2);
      }
-   s[(i * 2)] = 0;
-   eina_strbuf_free(sbuf);
+   eina_iterator_free(it);
 
-   return strdup(s);
+   if (total > max)
+     {
+        files = eina_list_sort(files, 0, _e_thumb_cache_file_cmp);
+        EINA_LIST_FREE(files, cf)
+          {
+             if ((total > max) && (cf->path) && (!unlink(cf->path)))
+               total -= cf->size;
+             free(cf->path);
+             free(cf);
+          }
+     }
+   EINA_LIST_FREE(files, cf)
+     {
+        free(cf->path);
+        free(cf);
+     }
 }
-
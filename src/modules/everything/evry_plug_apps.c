@@ -20,7 +20,10 @@
 typedef struct _Plugin        Plugin;
 typedef struct _Module_Config Module_Config;
 typedef struct _E_Exe         E_Exe;
+typedef struct _E_Exe_Dir     E_Exe_Dir;
 typedef struct _E_Exe_List    E_Exe_List;
+typedef struct _Exe_Scan_Dir  Exe_Scan_Dir;
+typedef struct _Exe_Scan      Exe_Scan;
 typedef struct _Item_Menu     Item_Menu;
 
 struct _Plugin
@@ -45,9 +48,31 @@ struct _E_Exe
   const char *path;
 };
 
+struct _E_Exe_Dir
+{
+   const char *path;
+   double      mtime;
+   Eina_List  *list;
+};
+
 struct _E_Exe_List
 {
    Eina_List *list;
+   Eina_List *dirs;
+};
+
+struct _Exe_Scan_Dir
+{
+   char      *path;
+   double     mtime_old;
+   double     mtime;
+   Eina_List *files;
+   Eina_Bool  unchanged;
+};
+
+struct _Exe_Scan
+{
+   Eina_List *dirs;
 };
 
 struct _Module_Config
@@ -84,13 +109,14 @@ static Eina_Bool update_path;
 static char *current_path = NULL;
 static Eina_List *dir_monitors = NULL;
 static Eina_List *exe_path = NULL;
-static Ecore_Idler *exe_scan_idler = NULL;
+static Eina_List *exe_dirs = NULL;
+static Ecore_Thread *exe_scan_thread = NULL;
 static E_Config_DD *exelist_exe_edd = NULL;
+static E_Config_DD *exelist_dir_edd = NULL;
 static E_Config_DD *exelist_edd = NULL;
-static Eina_Iterator *exe_dir = NULL;
-static Eina_List *exe_files = NULL;
 
 static void _scan_executables();
+static void _exe_dir_free(E_Exe_Dir *ed);
 
 #define GET_MENU(_m, _it) Item_Menu * _m = (Item_Menu *)_it
 
@@ -263,7 +289,7 @@ _fetch_exe(Evry_Plugin *plugin, const char *input)
         if ((tmp = strchr(input, ' ')))
           end = tmp - input;
 
-        if ((!exe_list) && (!exe_scan_idler))
+        if ((!exe_list) && (!exe_scan_thread))
           _scan_executables();
         EINA_LIST_FOREACH (exe_list, l, ee)
           {
@@ -343,6 +369,7 @@ _finish_exe(Evry_Plugin *plugin)
    GET_PLUGIN(p, plugin);
    char *str;
    E_Exe *ee;
+   E_Exe_Dir *ed;
 
    EVRY_PLUGIN_ITEMS_CLEAR(p);
    EVRY_ITEM_FREE(p->command);
@@ -350,18 +377,15 @@ _finish_exe(Evry_Plugin *plugin)
    if (p->added)
      eina_hash_free(p->added);
 
-   if (exe_dir)
-     {
-        eina_iterator_free(exe_dir);
-        exe_dir = NULL;
-     }
    EINA_LIST_FREE (exe_path, str)
      free(str);
 
-   if (exe_scan_idler)
+   if (exe_scan_thread)
      {
-        ecore_idler_del(exe_scan_idler);
-        exe_scan_idler = NULL;
+        Ecore_Thread *thread = exe_scan_thread;
+
+        exe_scan_thread = NULL;
+        ecore_thread_cancel(thread);
      }
 
    EINA_LIST_FREE (exe_list, ee)
@@ -370,8 +394,8 @@ _finish_exe(Evry_Plugin *plugin)
         free(ee);
      }
 
-   EINA_LIST_FREE (exe_files, str)
-     eina_stringshare_del(str);
+   EINA_LIST_FREE (exe_dirs, ed)
+     _exe_dir_free(ed);
 
    E_FREE(p);
 }
@@ -1468,12 +1492,21 @@ evry_plug_apps_init(E_Module *m)
 #define D exelist_exe_edd
    E_CONFIG_VAL(D, T, path, STR);
    E_CONFIG_VAL(D, T, len, UINT);
+   exelist_dir_edd = E_CONFIG_DD_NEW("E_Exe_Dir", E_Exe_Dir);
+#undef T
+#undef D
+#define T E_Exe_Dir
+#define D exelist_dir_edd
+   E_CONFIG_VAL(D, T, path, STR);
+   E_CONFIG_VAL(D, T, mtime, DOUBLE);
+   E_CONFIG_LIST(D, T, list, exelist_exe_edd);
    exelist_edd = E_CONFIG_DD_NEW("E_Exe_List", E_Exe_List);
 #undef T
 #undef D
 #define T E_Exe_List
 #define D exelist_edd
    E_CONFIG_LIST(D, T, list, exelist_exe_edd);
+   E_CONFIG_LIST(D, T, dirs, exelist_dir_edd);
 
    return EINA_TRUE;
 }
@@ -1486,6 +1519,7 @@ evry_plug_apps_shutdown(void)
    _conf_shutdown();
 
    E_CONFIG_DD_FREE(exelist_edd);
+   E_CONFIG_DD_FREE(exelist_dir_edd);
    E_CONFIG_DD_FREE(exelist_exe_edd);
 }
 
@@ -1498,126 +1532,186 @@ evry_plug_apps_save(void)
 /***************************************************************************/
 
 /* taken from e_exebuf.c */
-static Eina_Bool
-_scan_idler(void *data EINA_UNUSED)
+static void
+_scan_func(void *data, Ecore_Thread *thread)
 {
-   char *dir;
+   Exe_Scan *es = data;
+   Exe_Scan_Dir *sd;
+   Eina_List *l;
+   Eina_Iterator *it;
+   Eina_File_Direct_Info *info;
+   struct stat st;
 
-   /* no more path items left - stop scanning */
-   if (!exe_path)
+   EINA_LIST_FOREACH(es->dirs, l, sd)
      {
-        Eina_Bool different = EINA_FALSE;
+        if (ecore_thread_check(thread)) return;
 
-        if (eina_list_count(exe_list) == eina_list_count(exe_files))
+        if (stat(sd->path, &st) != 0) continue;
+        sd->mtime = st.st_mtime;
+        /* nothing was added to or removed from it since the last scan */
+        if ((sd->mtime_old > 0) && (sd->mtime == sd->mtime_old))
           {
-             E_Exe *ee;
-             Eina_List *l, *l2 = exe_files;
-
-             EINA_LIST_FOREACH(exe_list, l ,ee)
-               {
-                  if (ee->path != l2->data)
-                    {
-                       different = EINA_TRUE;
-                       break;
-                    }
-                  l2 = l2->next;
-               }
-          }
-        else
-          {
-             different = EINA_TRUE;
+             sd->unchanged = EINA_TRUE;
+             continue;
           }
 
-        if (different)
+        it = eina_file_direct_ls(sd->path);
+        if (!it) continue;
+        INF("scan dir: %s", sd->path);
+        EINA_ITERATOR_FOREACH(it, info)
           {
-             E_Exe *ee;
-
-             EINA_LIST_FREE (exe_list, ee)
-               {
-                  eina_stringshare_del(ee->path);
-                  free(ee);
-               }
+             Eina_Stat est;
 
-             const char *s;
-             E_Exe_List *el;
+             /* the type comes from d_type, only stat when it doesn't say */
+             if (info->type == EINA_FILE_DIR) continue;
+             if ((info->type != EINA_FILE_REG) &&
+                 ((eina_file_statat(eina_iterator_container_get(it), info, &est)) ||
+                  (S_ISDIR(est.mode))))
+               continue;
+             if (access(info->path, X_OK)) continue;
+             sd->files = eina_list_append(sd->files,
+                                          strdup(info->path + info->name_start));
+             if (ecore_thread_check(thread)) break;
+          }
+        eina_iterator_free(it);
+     }
+}
 
-             el = calloc(1, sizeof(E_Exe_List));
-             if (!el) return ECORE_CALLBACK_CANCEL;
+static void
+_scan_free(Exe_Scan *es)
+{
+   Exe_Scan_Dir *sd;
+   char *str;
 
-             el->list = NULL;
+   EINA_LIST_FREE(es->dirs, sd)
+     {
+        EINA_LIST_FREE(sd->files, str)
+          free(str);
+        free(sd->path);
+        free(sd);
+     }
+   free(es);
+}
 
-             EINA_LIST_FREE(exe_files, s)
-               {
-                  ee = calloc(1, sizeof(E_Exe));
-                  if (!ee) continue ;
+static void
+_exe_dir_free(E_Exe_Dir *ed)
+{
+   E_Exe *ee;
 
-                  ee->path = s;
-                  ee->len = strlen(s);
-                  el->list = eina_list_append(el->list, ee);
-               }
+   EINA_LIST_FREE(ed->list, ee)
+     {
+        eina_stringshare_del(ee->path);
+        free(ee);
+     }
+   eina_stringshare_del(ed->path);
+   free(ed);
+}
 
-             e_config_domain_save(_exebuf_cache_file, exelist_edd, el);
-             INF("plugin exebuf save: %s, %d", _exebuf_cache_file, eina_list_count(el->list));
+static void
+_exe_list_build(void)
+{
+   E_Exe_Dir *ed;
+   E_Exe *ee, *ee2;
+   Eina_List *l, *ll;
 
-             exe_list = el->list;
-             free(el);
-          }
-        else
+   EINA_LIST_FREE(exe_list, ee)
+     {
+        eina_stringshare_del(ee->path);
+        free(ee);
+     }
+   EINA_LIST_FOREACH(exe_dirs, l, ed)
+     {
+        EINA_LIST_FOREACH(ed->list, ll, ee)
           {
-             const char *str;
-              EINA_LIST_FREE(exe_files, str)
-                eina_stringshare_del(str);
+             ee2 = calloc(1, sizeof(E_Exe));
+             if (!ee2) continue;
+             ee2->path = eina_stringshare_ref(ee->path);
+             ee2->len = ee->len;
+             exe_list = eina_list_append(exe_list, ee2);
           }
-
-        exe_scan_idler = NULL;
-        return ECORE_CALLBACK_CANCEL;
      }
-   /* no dir is open - open the first path item */
-   if (!exe_dir)
-     {
-        dir = exe_path->data;
-        exe_dir = eina_file_direct_ls(dir);
-        INF("scan dir: %s", dir);
+}
 
-     }
-   /* if we have an opened dir - scan the next item */
-   if (exe_dir)
+static void
+_scan_end_func(void *data, Ecore_Thread *thread)
+{
+   Exe_Scan *es = data;
+   Exe_Scan_Dir *sd;
+   E_Exe_Dir *ed;
+   E_Exe *ee;
+   E_Exe_List *el;
+   Eina_List *l, *ll, *dirs = NULL;
+   Eina_Bool different = EINA_FALSE;
+   char *str;
+
+   /* the plugin was finished while the result was on its way */
+   if (exe_scan_thread != thread)
      {
-        Eina_File_Direct_Info *info;
+        _scan_free(es);
+        return;
+     }
+   exe_scan_thread = NULL;
 
-        if (eina_iterator_next(exe_dir, (void**) &info))
+   /* take over the result in path order, reusing cached dirs as they were */
+   EINA_LIST_FOREACH(es->dirs, l, sd)
+     {
+        ed = NULL;
+        if (sd->unchanged)
           {
-             Eina_Stat st;
-
-             if (!eina_file_statat(eina_iterator_container_get(exe_dir), info, &st) &&
-                 (!S_ISDIR(st.mode)) &&
-                 (!access(info->path, X_OK)))
-               exe_files = eina_list_append(exe_files,
-                                            eina_stringshare_add(info->path + info->name_start));
+             EINA_LIST_FOREACH(exe_dirs, ll, ed)
+               {
+                  if (!strcmp(ed->path, sd->path))
+                    {
+                       exe_dirs = eina_list_remove_list(exe_dirs, ll);
+                       break;
+                    }
+                  ed = NULL;
+               }
           }
-        else
+        if (!ed)
           {
-             /* we reached the end of a dir - remove the dir at the head
-              * of the path list so we advance and next loop we will pick up
-              * the next item, or if null- abort
-              */
-             dir = exe_path->data;
-             free(dir);
-
-             eina_iterator_free(exe_dir);
-             exe_dir = NULL;
-
-             exe_path = eina_list_remove_list(exe_path, exe_path);
+             ed = calloc(1, sizeof(E_Exe_Dir));
+             if (!ed) continue;
+             ed->path = eina_stringshare_add(sd->path);
+             ed->mtime = sd->mtime;
+             EINA_LIST_FREE(sd->files, str)
+               {
+                  ee = calloc(1, sizeof(E_Exe));
+                  if (ee)
+                    {
+                       ee->path = eina_stringshare_add(str);
+                       ee->len = strlen(str);
+                       ed->list = eina_list_append(ed->list, ee);
+                    }
+                  free(str);
+               }
+             different = EINA_TRUE;
           }
+        dirs = eina_list_append(dirs, ed);
      }
-   /* obviously the dir open failed - so remove the first path item */
-   else
-     {
-        free(eina_list_data_get(exe_path));
-        exe_path = eina_list_remove_list(exe_path, exe_path);
-     }
-   /* we have more scannign to do */
-   return ECORE_CALLBACK_RENEW;
+   /* anything left over is no longer in $PATH */
+   if (exe_dirs) different = EINA_TRUE;
+   EINA_LIST_FREE(exe_dirs, ed)
+     _exe_dir_free(ed);
+   exe_dirs = dirs;
+   _scan_free(es);
+
+   if ((!different) && (exe_list)) return;
+
+   _exe_list_build();
+   el = calloc(1, sizeof(E_Exe_List));
+   if (!el) return;
+   el->dirs = exe_dirs;
+   e_config_domain_save(_exebuf_cache_file, exelist_edd, el);
+   INF("plugin exebuf save: %s, %d", _exebuf_cache_file, eina_list_count(exe_list));
+   free(el);
+}
+
+static void
+_scan_cancel_func(void *data, Ecore_Thread *thread)
+{
+   if (exe_scan_thread == thread) exe_scan_thread = NULL;
+   _scan_free(data);
 }
 
 
@@ -1675,19 +1769,60 @@ static void
 _scan_executables()
 {
    E_Exe_List *el;
+   E_Exe_Dir *ed;
+   E_Exe *ee;
+   Exe_Scan *es;
+   Exe_Scan_Dir *sd;
+   Eina_List *l;
+   char *dir;
 
-   el = e_config_domain_load(_exebuf_cache_file, exelist_edd);
-   if (el)
+   if (!exe_dirs)
      {
-        exe_list = el->list;
-        INF("plugin exebuf load: %s, %d", _exebuf_cache_file, eina_list_count(el->list));
+        el = e_config_domain_load(_exebuf_cache_file, exelist_edd);
+        if (el)
+          {
+             exe_dirs = el->dirs;
+             /* caches from before dirs were stored only have the flat
+              * list, use it until the first scan replaces it */
+             if (exe_dirs)
+               {
+                  _exe_list_build();
+                  EINA_LIST_FREE(el->list, ee)
+                    {
+                       eina_stringshare_del(ee->path);
+                       free(ee);
+                    }
+               }
+             else
+               exe_list = el->list;
+             INF("plugin exebuf load: %s, %d", _exebuf_cache_file, eina_list_count(exe_list));
 
-        free(el);
+             free(el);
+          }
      }
+   else if (!exe_list)
+     _exe_list_build();
 
+   if (exe_scan_thread) return;
    if (_exe_path_list())
      {
-        exe_scan_idler = ecore_idler_add(_scan_idler, NULL);
+        es = E_NEW(Exe_Scan, 1);
+        EINA_LIST_FREE(exe_path, dir)
+          {
+             sd = E_NEW(Exe_Scan_Dir, 1);
+             sd->path = dir;
+             EINA_LIST_FOREACH(exe_dirs, l, ed)
+               {
+                  if (!strcmp(ed->path, dir))
+                    {
+                       sd->mtime_old = ed->mtime;
+                       break;
+                    }
+               }
+             es->dirs = eina_list_append(es->dirs, sd);
+          }
+        exe_scan_thread = ecore_thread_run(_scan_func, _scan_end_func,
+                                           _scan_cancel_func, es);
         update_path = EINA_FALSE;
      }
 }
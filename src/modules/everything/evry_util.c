@@ -57,9 +57,55 @@ _evry_utf8_next(const char *buf, int *iindex)
    return u;
 }
 
+/* one bit per character a match needs to find somewhere in str: a-z
+ * (case folded), 0-9, the rest of ascii folded into the bits left and
+ * anything non-ascii sharing the top bit. a string missing a bit the
+ * match has can never score, so this rejects most items for the cost of
+ * one pass over the label instead of running the scorer on them */
+static inline unsigned long long
+_evry_fuzzy_char_bit(unsigned char c)
+{
+   if (c >= 0x80) return 1ULL << 63;
+   if ((c >= 'A') && (c <= 'Z')) c += 'a' - 'A';
+   if ((c >= 'a') && (c <= 'z')) return 1ULL << (c - 'a');
+   if ((c >= '0') && (c <= '9')) return 1ULL << (26 + c - '0');
+   return 1ULL << (36 + (c % 27));
+}
+
+static unsigned long long
+_evry_fuzzy_match_mask(const char *match)
+{
+   unsigned long long mask = 0;
+   unsigned int words = 0;
+   const char *m = match;
+
+   /* only the first MAX_WORDS words of match are ever tested */
+   while ((*m != 0) && (words < MAX_WORDS))
+     {
+        for (; (*m != 0) && isspace(*m); m++) ;
+        if (*m == 0) break;
+        for (; (*m != 0) && !isspace(*m); m++)
+          mask |= _evry_fuzzy_char_bit(*m);
+        words++;
+     }
+   return mask;
+}
+
+static unsigned long long
+_evry_fuzzy_str_mask(const char *str)
+{
+   unsigned long long mask = 0;
+   const unsigned char *s;
+
+   for (s = (const unsigned char *)str; *s; s++)
+     mask |= _evry_fuzzy_char_bit(*s);
+   return mask;
+}
+
 int
 evry_fuzzy_match(const char *str, const char *match)
 {
+   unsigned long long mask;
    const char *p, *m, *next;
    int sum = 0;
 
@@ -85,6 +131,10 @@ evry_fuzzy_match(const char *str, const char *match)
    for (; (*match != 0) && isspace(*match); match++) ;
    for (; (*str != 0) && isspace(*str); str++) ;
 
+   mask = _evry_fuzzy_match_mask(match);
+   if ((_evry_fuzzy_str_mask(str) & mask) != mask)
+     return 0;
+
    /* count words in match */
    for (m = match; (*m != 0) && (m_num < MAX_WORDS); )
      {
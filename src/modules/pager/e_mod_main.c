@@ -525,7 +525,7 @@ _pager_desk_new(Pager *p, E_Desk *desk, int xpos, int ypos, Eina_Bool invert)
                                   _pager_desk_cb_mouse_wheel, pd);
    evas_object_show(o);
 
-   pd->o_layout = e_deskmirror_add(desk, 1, 0);
+   pd->o_layout = e_deskmirror_thumb_add(desk, 1, 0, pager_config->preview_rate);
    evas_object_smart_callback_add(pd->o_layout, "mirror_add", (Evas_Smart_Cb)_pager_cb_mirror_add, pd);
 
    l = e_deskmirror_mirror_list(pd->o_layout);
@@ -2129,6 +2129,7 @@ e_modapi_init(E_Module *m EINA_UNUSED)
    E_CONFIG_VAL(D, T, flip_desk, UCHAR);
    E_CONFIG_VAL(D, T, plain, UCHAR);
    E_CONFIG_VAL(D, T, permanent_plain, UCHAR);
+   E_CONFIG_VAL(D, T, preview_rate, DOUBLE);
 
    pager_config = e_config_domain_load("module.pager", conf_edd);
 
@@ -2150,6 +2151,7 @@ e_modapi_init(E_Module *m EINA_UNUSED)
         pager_config->flip_desk = 0;
         pager_config->plain = 0;
         pager_config->permanent_plain = 0;
+        pager_config->preview_rate = 5.0;
      }
    E_CONFIG_LIMIT(pager_config->popup, 0, 1);
    E_CONFIG_LIMIT(pager_config->popup_speed, 0.1, 10.0);
@@ -2166,6 +2168,10 @@ e_modapi_init(E_Module *m EINA_UNUSED)
    E_CONFIG_LIMIT(pager_config->btn_desk, 0, 32);
    E_CONFIG_LIMIT(pager_config->plain, 0, 1);
    E_CONFIG_LIMIT(pager_config->permanent_plain, 0, 1);
+   /* configs from before previews were throttled have no rate */
+   if (pager_config->preview_rate <= 0.0)
+     pager_config->preview_rate = 5.0;
+   E_CONFIG_LIMIT(pager_config->preview_rate, 0.5, 60.0);
 
    p = e_module_find("pager_plain");
    if (p && p->enabled)
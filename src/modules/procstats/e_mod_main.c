@@ -1,8 +1,10 @@
 #include <e.h>
-#include "process.h"
+#include "sampler.h"
 
-static Eina_List   *_clients = NULL;
-static Ecore_Timer *_clients_timer = NULL;
+static Eina_List    *_clients = NULL;
+static Ecore_Timer  *_clients_timer = NULL;
+static Proc_Sampler *_sampler = NULL;
+static Ecore_Thread *_sampler_thread = NULL;
 
 #define _TIMER_FREQ 3.0
 
@@ -103,20 +105,12 @@ _proc_stats_item_gone(Proc_Stats *item)
    return 1;
 }
 
-static void
-_proc_stats_item_children_update(Eina_List *children, Proc_Stats *item)
+typedef struct _Proc_Stats_Job
 {
-   Eina_List *l;
-   Proc_Info *child;
-
-   EINA_LIST_FOREACH(children, l, child)
-    {
-       item->mem_size += child->mem_size;
-       item->cpu_time += child->cpu_time;
-       if (child->children)
-         _proc_stats_item_children_update(child->children, item);
-    }
-}
+   Proc_Sampler *sampler;
+   Proc_Sample  *samples;
+   unsigned int  count;
+} Proc_Stats_Job;
 
 static void
 _proc_stats_item_display(Proc_Stats *item)
@@ -142,33 +136,78 @@ _proc_stats_item_display(Proc_Stats *item)
 }
 
 static void
-_proc_stats_item_update(Eina_List *procs, Proc_Stats *item)
+_proc_stats_item_update(Proc_Stats_Job *job, Proc_Stats *item)
 {
-   Proc_Info *proc;
-   Eina_List *l;
+   unsigned int i;
 
-   EINA_LIST_FOREACH(procs, l, proc)
+   for (i = 0; i < job->count; i++)
      {
-        if (proc->pid == item->pid)
+        if (job->samples[i].pid != item->pid) continue;
+        if (job->samples[i].found)
           {
-             item->cpu_time = item->mem_size = 0;
-             item->mem_size += proc->mem_size;
-             item->cpu_time +=  proc->cpu_time;
-             _proc_stats_item_children_update(proc->children, item);
-             break;
+             item->mem_size = job->samples[i].mem_size;
+             item->cpu_time = job->samples[i].cpu_time;
           }
+        break;
      }
    _proc_stats_item_display(item);
    item->cpu_time_prev = item->cpu_time;
 }
 
+static void
+_proc_stats_job_free(Proc_Stats_Job *job)
+{
+   /* the module went away while this job was running */
+   if (job->sampler != _sampler) proc_sampler_free(job->sampler);
+   free(job->samples);
+   free(job);
+}
+
+/* only the trees below managed clients are read, and not on the main loop */
+static void
+_proc_stats_sample_cb(void *data, Ecore_Thread *thread EINA_UNUSED)
+{
+   Proc_Stats_Job *job = data;
+
+   proc_sampler_run(job->sampler, job->samples, job->count);
+}
+
+static void
+_proc_stats_sample_end_cb(void *data, Ecore_Thread *thread)
+{
+   Proc_Stats_Job *job = data;
+   Eina_List *l, *ll;
+   Proc_Stats *item;
+
+   if (_sampler_thread == thread) _sampler_thread = NULL;
+   if (job->sampler == _sampler)
+     {
+        EINA_LIST_FOREACH_SAFE(_clients, l, ll, item)
+          {
+             if (_proc_stats_item_gone(item))
+               _proc_stats_item_remove(item);
+             else
+               _proc_stats_item_update(job, item);
+          }
+     }
+   _proc_stats_job_free(job);
+}
+
+static void
+_proc_stats_sample_cancel_cb(void *data, Ecore_Thread *thread)
+{
+   if (_sampler_thread == thread) _sampler_thread = NULL;
+   _proc_stats_job_free(data);
+}
+
 static Eina_Bool
 _proc_stats_timer_cb(void *data EINA_UNUSED)
 {
-   Eina_List *procs, *l;
+   Proc_Stats_Job *job;
+   Eina_List *l;
    E_Client *ec;
-   Proc_Info *proc;
    Proc_Stats *item;
+   unsigned int i = 0;
 
    EINA_LIST_FOREACH(e_comp->clients, l, ec)
      {
@@ -176,20 +215,27 @@ _proc_stats_timer_cb(void *data EINA_UNUSED)
           _proc_stats_item_add(ec);
      }
 
-   procs = proc_info_all_children_get();
+   /* still busy with the last tick: skip this one */
+   if (_sampler_thread) return ECORE_CALLBACK_RENEW;
+   if (!_clients) return ECORE_CALLBACK_RENEW;
 
-   EINA_LIST_FOREACH(_clients, l, item)
+   job = calloc(1, sizeof(Proc_Stats_Job));
+   if (!job) return ECORE_CALLBACK_RENEW;
+   job->count = eina_list_count(_clients);
+   job->samples = calloc(job->count, sizeof(Proc_Sample));
+   if (!job->samples)
      {
-        if (_proc_stats_item_gone(item))
-          _proc_stats_item_remove(item);
-        else
-         _proc_stats_item_update(procs, item);
+        free(job);
+        return ECORE_CALLBACK_RENEW;
      }
+   job->sampler = _sampler;
+   EINA_LIST_FOREACH(_clients, l, item)
+     job->samples[i++].pid = item->pid;
 
-   EINA_LIST_FREE(procs, proc)
-     proc_info_free(proc);
-
-   return 1;
+   _sampler_thread = ecore_thread_run(_proc_stats_sample_cb,
+                                      _proc_stats_sample_end_cb,
+                                      _proc_stats_sample_cancel_cb, job);
+   return ECORE_CALLBACK_RENEW;
 }
 
 E_API E_Module_Api e_modapi =
@@ -201,6 +247,8 @@ E_API E_Module_Api e_modapi =
 E_API int
 e_modapi_init(E_Module *m EINA_UNUSED)
 {
+   _sampler = proc_sampler_new();
+   if (!_sampler) return 0;
    _proc_stats_timer_cb(NULL);
 
    _clients_timer = ecore_timer_add(_TIMER_FREQ, _proc_stats_timer_cb, NULL);
@@ -218,6 +266,16 @@ e_modapi_shutdown(E_Module *m EINA_UNUSED)
 
    _clients_timer = NULL;
 
+   if (_sampler_thread)
+     {
+        ecore_thread_cancel(_sampler_thread);
+        ecore_thread_wait(_sampler_thread, 1.0);
+     }
+   /* a job still running frees the sampler itself once it sees it orphaned */
+   if (!_sampler_thread) proc_sampler_free(_sampler);
+   _sampler = NULL;
+   _sampler_thread = NULL;
+
    EINA_LIST_FREE(_clients, item)
      _proc_stats_item_del(item);
 
@@ -0,0 +1,438 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <sys/types.h>
+
+#include "sampler.h"
+#include "process.h"
+
+#if defined(__linux__)
+
+/* most files kept open between runs, the rest are reopened every run */
+# define PROC_FDS_MAX   256
+/* deepest process tree followed */
+# define PROC_DEPTH_MAX 64
+
+typedef struct _Proc_Node
+{
+   Proc_Sampler      *ps;
+   pid_t              pid;
+   unsigned long long start_time;
+   int                stat_fd;
+   int                statm_fd;
+   int                children_fd;
+   int                numthreads;
+   unsigned int       generation;
+   uint64_t           mem_size;
+   uint64_t           cpu_time;
+   Eina_Inarray      *children; // pid_t
+} Proc_Node;
+
+struct _Proc_Sampler
+{
+   Eina_Hash   *nodes; // pid -> Proc_Node
+   Eina_Hash   *ppids; // ppid -> Eina_Inarray of pid_t, only without children files
+   char        *buf;
+   size_t       buf_size;
+   unsigned int generation;
+   int          fds;
+   int          children_files; // -1 not probed yet, 0 not supported, 1 supported
+   long         pagesize;
+};
+
+static void
+_fd_close(Proc_Sampler *ps, int *fd)
+{
+   if (*fd < 0) return;
+   close(*fd);
+   *fd = -1;
+   ps->fds--;
+}
+
+static void
+_node_free(Proc_Node *node)
+{
+   _fd_close(node->ps, &node->stat_fd);
+   _fd_close(node->ps, &node->statm_fd);
+   _fd_close(node->ps, &node->children_fd);
+   eina_inarray_free(node->children);
+   free(node);
+}
+
+/* read all of path into ps->buf. with fd given the file stays open for the
+ * next run (while under PROC_FDS_MAX) and is re-read with pread()
+ * returns the length read or -1
+ */
+static ssize_t
+_proc_read(Proc_Sampler *ps, int *fd, const char *path)
+{
+   ssize_t len = 0, r;
+   int f = fd ? *fd : -1;
+
+   if (f < 0)
+     {
+        f = open(path, O_RDONLY | O_CLOEXEC);
+        if (f < 0) return -1;
+        if (fd && (ps->fds < PROC_FDS_MAX))
+          {
+             *fd = f;
+             ps->fds++;
+          }
+     }
+   for (;;)
+     {
+        if ((size_t)len + 1 >= ps->buf_size)
+          {
+             size_t size = ps->buf_size ? ps->buf_size * 2 : 4096;
+             char *tmp = realloc(ps->buf, size);
+
+             if (!tmp)
+               {
+                  len = -1;
+                  break;
+               }
+             ps->buf = tmp;
+             ps->buf_size = size;
+          }
+        r = pread(f, ps->buf + len, ps->buf_size - len - 1, len);
+        if (r < 0)
+          {
+             if (errno == EINTR) continue;
+             len = -1;
+             break;
+          }
+        if (r == 0) break;
+        len += r;
+     }
+   if (len >= 0) ps->buf[len] = 0;
+   if ((!fd) || (*fd != f)) close(f);
+   else if (len < 0) _fd_close(ps, fd);
+   return len;
+}
+
+static void
+_pids_parse(Eina_Inarray *pids, const char *s)
+{
+   char *end;
+   long val;
+
+   while (*s)
+     {
+        val = strtol(s, &end, 10);
+        if (end == s)
+          {
+             s++;
+             continue;
+          }
+        if (val > 0)
+          {
+             pid_t pid = val;
+
+             eina_inarray_push(pids, &pid);
+          }
+        s = end;
+     }
+}
+
+static Eina_Bool
+_node_stat_read(Proc_Sampler *ps, Proc_Node *node)
+{
+   char path[64], *p, *end;
+   unsigned long long val, utime = 0, stime = 0, start = 0, threads = 0;
+   int field;
+
+   snprintf(path, sizeof(path), "/proc/%d/stat", node->pid);
+   if (_proc_read(ps, &node->stat_fd, path) <= 0) return EINA_FALSE;
+   /* the command name can contain anything: fields resume after the last ')' */
+   p = strrchr(ps->buf, ')');
+   if (!p) return EINA_FALSE;
+   p++;
+   for (field = 3; field <= 22; field++)
+     {
+        while (*p == ' ') p++;
+        if (!*p) return EINA_FALSE;
+        if (field == 3) /* state */
+          {
+             p++;
+             continue;
+          }
+        val = strtoull(p, &end, 10);
+        if (end == p) return EINA_FALSE;
+        p = end;
+        if (field == 14) utime = val;
+        else if (field == 15) stime = val;
+        else if (field == 20) threads = val;
+        else if (field == 22) start = val;
+     }
+   if (node->start_time && (node->start_time != start))
+     {
+        /* pid was reused: nothing else we hold belongs to this process */
+        _fd_close(ps, &node->statm_fd);
+        _fd_close(ps, &node->children_fd);
+        eina_inarray_flush(node->children);
+     }
+   node->start_time = start;
+   node->cpu_time = utime + stime;
+   node->numthreads = threads;
+   return EINA_TRUE;
+}
+
+static void
+_node_statm_read(Proc_Sampler *ps, Proc_Node *node)
+{
+   char path[64];
+   unsigned long long size, resident, shared;
+
+   node->mem_size = 0;
+   snprintf(path, sizeof(path), "/proc/%d/statm", node->pid);
+   if (_proc_read(ps, &node->statm_fd, path) <= 0) return;
+   if (sscanf(ps->buf, "%llu %llu %llu", &size, &resident, &shared) != 3) return;
+   if (resident > shared)
+     node->mem_size = (resident - shared) * ps->pagesize;
+}
+
+static void
+_node_children_read(Proc_Sampler *ps, Proc_Node *node)
+{
+   char path[64];
+   struct dirent *de;
+   DIR *dir;
+   int tid;
+
+   eina_inarray_flush(node->children);
+   if (ps->children_files)
+     {
+        if (node->numthreads <= 1)
+          {
+             snprintf(path, sizeof(path), "/proc/%d/task/%d/children", node->pid, node->pid);
+             if (_proc_read(ps, &node->children_fd, path) >= 0)
+               _pids_parse(node->children, ps->buf);
+             return;
+          }
+        /* children are listed under the thread that forked them */
+        _fd_close(ps, &node->children_fd);
+        snprintf(path, sizeof(path), "/proc/%d/task", node->pid);
+        dir = opendir(path);
+        if (!dir) return;
+        while ((de = readdir(dir)))
+          {
+             tid = atoi(de->d_name);
+             if (tid <= 0) continue;
+             snprintf(path, sizeof(path), "/proc/%d/task/%d/children", node->pid, tid);
+             if (_proc_read(ps, NULL, path) >= 0)
+               _pids_parse(node->children, ps->buf);
+          }
+        closedir(dir);
+     }
+   else
+     {
+        Eina_Inarray *pids = eina_hash_find(ps->ppids, &node->pid);
+        pid_t *pid;
+
+        if (!pids) return;
+        EINA_INARRAY_FOREACH(pids, pid)
+          eina_inarray_push(node->children, pid);
+     }
+}
+
+/* without children files: one pass over /proc reading only each ppid */
+static void
+_ppids_build(Proc_Sampler *ps)
+{
+   char path[64], *p;
+   struct dirent *de;
+   Eina_Inarray *pids;
+   DIR *dir;
+   pid_t pid, ppid;
+
+   dir = opendir("/proc");
+   if (!dir) return;
+   while ((de = readdir(dir)))
+     {
+        pid = atoi(de->d_name);
+        if (pid <= 0) continue;
+        snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+        if (_proc_read(ps, NULL, path) <= 0) continue;
+        p = strrchr(ps->buf, ')');
+        if ((!p) || (sscanf(p + 1, " %*c %d", &ppid) != 1)) continue;
+        pids = eina_hash_find(ps->ppids, &ppid);
+        if (!pids)
+          {
+             pids = eina_inarray_new(sizeof(pid_t), 0);
+             eina_hash_add(ps->ppids, &ppid, pids);
+          }
+        eina_inarray_push(pids, &pid);
+     }
+   closedir(dir);
+}
+
+static Eina_Bool
+_node_sample(Proc_Sampler *ps, pid_t pid, int depth, Proc_Sample *sample)
+{
+   Proc_Node *node;
+   pid_t *child;
+
+   if (depth > PROC_DEPTH_MAX) return EINA_FALSE;
+   node = eina_hash_find(ps->nodes, &pid);
+   if (!node)
+     {
+        node = calloc(1, sizeof(Proc_Node));
+        if (!node) return EINA_FALSE;
+        node->ps = ps;
+        node->pid = pid;
+        node->stat_fd = node->statm_fd = node->children_fd = -1;
+        node->children = eina_inarray_new(sizeof(pid_t), 0);
+        eina_hash_add(ps->nodes, &pid, node);
+     }
+   /* nested roots share subtrees: read each process once per run */
+   if (node->generation != ps->generation)
+     {
+        if (!_node_stat_read(ps, node))
+          {
+             /* a kept fd dies with its process even if the pid came back */
+             _fd_close(ps, &node->stat_fd);
+             if (!_node_stat_read(ps, node))
+               {
+                  eina_hash_del_by_key(ps->nodes, &pid);
+                  return EINA_FALSE;
+               }
+          }
+        node->generation = ps->generation;
+        _node_statm_read(ps, node);
+        _node_children_read(ps, node);
+     }
+   sample->mem_size += node->mem_size;
+   sample->cpu_time += node->cpu_time;
+   EINA_INARRAY_FOREACH(node->children, child)
+     _node_sample(ps, *child, depth + 1, sample);
+   return EINA_TRUE;
+}
+
+Proc_Sampler *
+proc_sampler_new(void)
+{
+   Proc_Sampler *ps;
+
+   ps = calloc(1, sizeof(Proc_Sampler));
+   if (!ps) return NULL;
+   ps->nodes = eina_hash_int32_new((Eina_Free_Cb)_node_free);
+   ps->ppids = eina_hash_int32_new((Eina_Free_Cb)eina_inarray_free);
+   ps->children_files = -1;
+   ps->pagesize = getpagesize();
+   return ps;
+}
+
+void
+proc_sampler_free(Proc_Sampler *ps)
+{
+   if (!ps) return;
+   eina_hash_free(ps->nodes);
+   eina_hash_free(ps->ppids);
+   free(ps->buf);
+   free(ps);
+}
+
+void
+proc_sampler_run(Proc_Sampler *ps, Proc_Sample *samples, unsigned int count)
+{
+   Eina_Iterator *it;
+   Eina_List *stale = NULL;
+   Proc_Node *node;
+   unsigned int i;
+
+   if (ps->children_files < 0)
+     {
+        char path[64];
+
+        /* needs CONFIG_PROC_CHILDREN */
+        snprintf(path, sizeof(path), "/proc/%d/task/%d/children", getpid(), getpid());
+        ps->children_files = !access(path, R_OK);
+     }
+   if (!++ps->generation) ps->generation++;
+   if (!ps->children_files) _ppids_build(ps);
+
+   for (i = 0; i < count; i++)
+     {
+        samples[i].mem_size = samples[i].cpu_time = 0;
+        samples[i].found = _node_sample(ps, samples[i].pid, 0, &samples[i]);
+     }
+
+   /* forget (and close) whatever is no longer below a root */
+   it = eina_hash_iterator_data_new(ps->nodes);
+   EINA_ITERATOR_FOREACH(it, node)
+     {
+        if (node->generation != ps->generation)
+          stale = eina_list_append(stale, node);
+     }
+   eina_iterator_free(it);
+   EINA_LIST_FREE(stale, node)
+     eina_hash_del_by_key(ps->nodes, &node->pid);
+   if (!ps->children_files) eina_hash_free_buckets(ps->ppids);
+}
+
+#else
+
+struct _Proc_Sampler
+{
+   int dummy;
+};
+
+Proc_Sampler *
+proc_sampler_new(void)
+{
+   return calloc(1, sizeof(Proc_Sampler));
+}
+
+void
+proc_sampler_free(Proc_Sampler *ps)
+{
+   free(ps);
+}
+
+static void
+_children_sum(Eina_List *children, Proc_Sample *sample, int depth)
+{
+   Eina_List *l;
+   Proc_Info *child;
+
+   if (depth > 64) return;
+   EINA_LIST_FOREACH(children, l, child)
+     {
+        sample->mem_size += child->mem_size;
+        sample->cpu_time += child->cpu_time;
+        _children_sum(child->children, sample, depth + 1);
+     }
+}
+
+void
+proc_sampler_run(Proc_Sampler *ps EINA_UNUSED, Proc_Sample *samples, unsigned int count)
+{
+   Eina_List *procs, *l;
+   Proc_Info *proc;
+   unsigned int i;
+
+   /* no cheap per-process access here: one full listing per run */
+   procs = proc_info_all_children_get();
+   for (i = 0; i < count; i++)
+     {
+        samples[i].mem_size = samples[i].cpu_time = 0;
+        samples[i].found = EINA_FALSE;
+        EINA_LIST_FOREACH(procs, l, proc)
+          {
+             if (proc->pid != samples[i].pid) continue;
+             samples[i].found = EINA_TRUE;
+             samples[i].mem_size = proc->mem_size;
+             samples[i].cpu_time = proc->cpu_time;
+             _children_sum(proc->children, &samples[i], 0);
+             break;
+          }
+     }
+   EINA_LIST_FREE(procs, proc)
+     proc_info_free(proc);
+}
+
+#endif
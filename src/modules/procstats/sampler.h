@@ -0,0 +1,32 @@
+#ifndef __SAMPLER_H__
+#define __SAMPLER_H__
+
+#include <Eina.h>
+#include <stdint.h>
+#include <unistd.h>
+
+/* totals for one root process and all of its descendants */
+typedef struct _Proc_Sample
+{
+   pid_t     pid; // filled in by the caller
+   uint64_t  mem_size;
+   uint64_t  cpu_time; // clock ticks
+   Eina_Bool found;
+} Proc_Sample;
+
+typedef struct _Proc_Sampler Proc_Sampler;
+
+Proc_Sampler *
+proc_sampler_new(void);
+
+void
+proc_sampler_free(Proc_Sampler *ps);
+
+/* fill in samples[0..count-1]. state (open fds, known children) is kept
+ * between runs so only the tracked trees are read. not thread safe: one
+ * run at a time, but the run may happen on any thread.
+ */
+void
+proc_sampler_run(Proc_Sampler *ps, Proc_Sample *samples, unsigned int count);
+
+#endif
@@ -172,7 +172,7 @@ _e_qa_entry_border_props_restore(E_Quick_Access_Entry *entry EINA_UNUSED, E_Clie
 
    ec->netwm.state.skip_taskbar = 0;
    ec->netwm.state.skip_pager = 0;
-   ec->changed = 1;
+   EC_CHANGED(ec);
 }
 
 static void
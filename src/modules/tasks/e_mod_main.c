@@ -35,10 +35,15 @@ struct _Tasks
    E_Comp_Object_Mover *iconify_provider;
    Evas_Object     *o_items; // Table of items
    Eina_List       *items; // List of items
+   Eina_Hash       *item_hash; // Client -> item
    Eina_List       *clients; // List of clients
    E_Zone          *zone; // Current Zone
    Config_Item     *config; // Configuration
    int              horizontal;
+   unsigned int     generation; // Bumped on every reconcile
+   Evas_Coord       item_w, item_h; // Cached item min size
+   Evas_Coord       item_size_limit; // Box height (or width) it was calculated for
+   Eina_Bool        item_size_valid E_BITFIELD;
 };
 
 struct _Tasks_Item
@@ -49,6 +54,7 @@ struct _Tasks_Item
    Evas_Object *o_icon; // The icon
    Evas_Object *o_preview; // The preview
    Ecore_Timer *timer; // The preview timer
+   unsigned int generation; // Last reconcile that wanted this item
    Eina_Bool skip_taskbar E_BITFIELD;
    Eina_Bool focused E_BITFIELD;
    Eina_Bool urgent E_BITFIELD;
@@ -58,14 +64,14 @@ struct _Tasks_Item
 static Tasks       *_tasks_new(Evas *e, E_Zone *zone, const char *id);
 static void         _tasks_free(Tasks *tasks);
 static void         _tasks_refill(Tasks *tasks);
+static void         _tasks_reconcile(Tasks *tasks);
 static void         _tasks_refill_all();
 static void         _tasks_refill_border(E_Client *ec);
 
 static Tasks_Item  *_tasks_item_find(Tasks *tasks, E_Client *ec);
 static Tasks_Item  *_tasks_item_new(Tasks *tasks, E_Client *ec);
 
-static int          _tasks_item_check_add(Tasks *tasks, E_Client *ec);
-static void         _tasks_item_add(Tasks *tasks, E_Client *ec);
+static Eina_Bool    _tasks_item_wanted(Tasks *tasks, E_Client *ec);
 static void         _tasks_item_remove(Tasks_Item *item);
 static void         _tasks_item_refill(Tasks_Item *item);
 static void         _tasks_item_fill(Tasks_Item *item);
@@ -382,6 +388,7 @@ _tasks_new(Evas *e, E_Zone *zone, const char *id)
    tasks = E_NEW(Tasks, 1);
    tasks->config = _tasks_config_item_get(id);
    tasks->o_items = elm_box_add(e_win_evas_win_get(e));
+   tasks->item_hash = eina_hash_pointer_new(NULL);
    tasks->horizontal = 1;
    EINA_LIST_FOREACH(e_comp->clients, l, ec)
      {
@@ -405,32 +412,46 @@ _tasks_free(Tasks *tasks)
    e_comp_object_effect_mover_del(tasks->iconify_provider);
    EINA_LIST_FREE(tasks->items, item)
      _tasks_item_free(item);
+   eina_hash_free(tasks->item_hash);
    eina_list_free(tasks->clients);
    evas_object_del(tasks->o_items);
    free(tasks);
 }
 
+/* throw away every item and build them again, for changes that affect
+ * how items look (orientation, config) */
 static void
 _tasks_refill(Tasks *tasks)
 {
-   Eina_List *l;
-   E_Client *ec;
    Tasks_Item *item;
-   Evas_Coord w, h, tw, th;
 
    while (tasks->items)
      {
         item = tasks->items->data;
         _tasks_item_remove(item);
      }
-   EINA_LIST_FOREACH(tasks->clients, l, ec)
+   tasks->item_size_valid = EINA_FALSE;
+   _tasks_reconcile(tasks);
+}
+
+static void
+_tasks_min_size_update(Tasks *tasks)
+{
+   Tasks_Item *item;
+   Evas_Coord w, h, tw, th, limit;
+
+   if (!tasks->items)
      {
-        _tasks_item_check_add(tasks, ec);
+        e_gadcon_client_min_size_set(tasks->gcc, 0, 0);
+        return;
      }
-   if (tasks->items)
+   evas_object_geometry_get(tasks->o_items, NULL, NULL, &tw, &th);
+   limit = tasks->horizontal ? th : tw;
+   /* items are homogeneous, so one calc holds until the theme, config or
+    * the space we have changes */
+   if ((!tasks->item_size_valid) || (tasks->item_size_limit != limit))
      {
         item = tasks->items->data;
-        evas_object_geometry_get(tasks->o_items, NULL, NULL, &tw, &th);
 //        edje_object_size_min_calc(item->o_item, &w, &h);
         if (tasks->horizontal)
           edje_object_size_min_restricted_calc(item->o_item, &w, &h, 0, th);
@@ -446,20 +467,91 @@ _tasks_refill(Tasks *tasks)
              if (h < tasks->config->minh) h = tasks->config->minh;
              if (tasks->config->icon_only) h = w;
           }
-        if (!tasks->gcc->resizable)
+        tasks->item_w = w;
+        tasks->item_h = h;
+        tasks->item_size_limit = limit;
+        tasks->item_size_valid = EINA_TRUE;
+     }
+   if (!tasks->gcc->resizable)
+     {
+        if (tasks->horizontal)
+          e_gadcon_client_min_size_set(tasks->gcc,
+                                       tasks->item_w * eina_list_count(tasks->items),
+                                       tasks->item_h);
+        else
+          e_gadcon_client_min_size_set(tasks->gcc,
+                                       tasks->item_w,
+                                       tasks->item_h * eina_list_count(tasks->items));
+     }
+}
+
+static void
+_tasks_item_pack(Tasks *tasks, Tasks_Item *item, Tasks_Item *prev)
+{
+   if (prev)
+     elm_box_pack_after(tasks->o_items, item->o_item, prev->o_item);
+   else
+     elm_box_pack_start(tasks->o_items, item->o_item);
+}
+
+/* bring the items in line with the clients we should show, only creating,
+ * deleting or moving the items that changed */
+static void
+_tasks_reconcile(Tasks *tasks)
+{
+   Eina_List *l, *ll, *items = NULL, *cur;
+   Tasks_Item *item, *prev = NULL;
+   E_Client *ec;
+   Eina_Bool changed = EINA_FALSE;
+
+   tasks->generation++;
+   EINA_LIST_FOREACH(tasks->clients, l, ec)
+     {
+        if (!_tasks_item_wanted(tasks, ec)) continue;
+        item = eina_hash_find(tasks->item_hash, &ec);
+        if (!item)
           {
-             if (tasks->horizontal)
-               e_gadcon_client_min_size_set(tasks->gcc,
-                                            w * eina_list_count(tasks->items),
-                                            h);
-             else
-               e_gadcon_client_min_size_set(tasks->gcc,
-                                            w,
-                                            h * eina_list_count(tasks->items));
+             item = _tasks_item_new(tasks, ec);
+             E_EXPAND(item->o_item);
+             E_FILL(item->o_item);
           }
+        else if (item->generation == tasks->generation)
+          continue;
+        item->generation = tasks->generation;
+        items = eina_list_append(items, item);
      }
-   else
-     e_gadcon_client_min_size_set(tasks->gcc, 0, 0);
+
+   /* drop what is no longer wanted */
+   EINA_LIST_FOREACH_SAFE(tasks->items, l, ll, item)
+     {
+        if (item->generation == tasks->generation) continue;
+        _tasks_item_remove(item);
+        changed = EINA_TRUE;
+     }
+
+   /* then pack new items and move existing ones where the order changed */
+   cur = tasks->items;
+   EINA_LIST_FOREACH(items, l, item)
+     {
+        if ((cur) && (cur->data == item))
+          cur = cur->next;
+        else
+          {
+             if (eina_list_data_find(cur, item))
+               {
+                  cur = eina_list_remove(cur, item);
+                  elm_box_unpack(tasks->o_items, item->o_item);
+               }
+             _tasks_item_pack(tasks, item, prev);
+             changed = EINA_TRUE;
+          }
+        prev = item;
+     }
+   eina_list_free(tasks->items);
+   tasks->items = items;
+
+   if ((changed) || (!tasks->item_size_valid))
+     _tasks_min_size_update(tasks);
 }
 
 static Eina_Bool
@@ -489,7 +581,7 @@ _tasks_refill_all(void)
 
    EINA_LIST_FOREACH(tasks_config->tasks, l, tasks)
      {
-        _tasks_refill(tasks);
+        _tasks_reconcile(tasks);
      }
 }
 
@@ -498,49 +590,27 @@ _tasks_refill_border(E_Client *ec)
 {
    const Eina_List *l;
    Tasks *tasks;
+   Tasks_Item *item;
    Eina_Bool found = EINA_FALSE;
 
    EINA_LIST_FOREACH(tasks_config->tasks, l, tasks)
      {
-        const Eina_List *m;
-        Tasks_Item *item;
-        EINA_LIST_FOREACH(tasks->items, m, item)
-          {
-             E_Client *ec2;
-
-             ec2 = e_client_stack_bottom_get(item->client);
-             for (; ec2; ec2 = ec2->stack.next)
-               {
-                  if (ec2 == ec)
-                    {
-                       _tasks_item_refill(item);
-                       found = EINA_TRUE;
-                       goto done;
-                    }
-               }
-          }
+        if (!(item = _tasks_item_find(tasks, ec))) continue;
+        _tasks_item_refill(item);
+        found = EINA_TRUE;
      }
-done:
    if (!found) _tasks_refill_all();
 }
 
 static Tasks_Item *
 _tasks_item_find(Tasks *tasks, E_Client *ec)
 {
-   const Eina_List *l;
-   Tasks_Item *item;
+   E_Client *bottom;
 
-   EINA_LIST_FOREACH(tasks->items, l, item)
-     {
-        E_Client *ec2;
-
-        ec2 = e_client_stack_bottom_get(item->client);
-        for (; ec2; ec2 = ec2->stack.next)
-          {
-             if (ec2 == ec) return item;
-          }
-     }
-   return NULL;
+   /* items are keyed by the bottom of their client's stack */
+   bottom = e_client_stack_bottom_get(ec);
+   if (!bottom) return NULL;
+   return eina_hash_find(tasks->item_hash, &bottom);
 }
 
 static Tasks_Item *
@@ -552,6 +622,7 @@ _tasks_item_new(Tasks *tasks, E_Client *ec)
    e_object_ref(E_OBJECT(ec));
    item->tasks = tasks;
    item->client = ec;
+   eina_hash_add(tasks->item_hash, &item->client, item);
    item->skip_taskbar = ec->netwm.state.skip_taskbar;
    item->o_item = edje_object_add(evas_object_evas_get(tasks->o_items));
    if (tasks->horizontal)
@@ -595,35 +666,21 @@ _tasks_item_new(Tasks *tasks, E_Client *ec)
    return item;
 }
 
-static int
-_tasks_item_check_add(Tasks *tasks, E_Client *ec)
+static Eina_Bool
+_tasks_item_wanted(Tasks *tasks, E_Client *ec)
 {
-   if (ec->user_skip_winlist) return 1;
-   if (ec->netwm.state.skip_taskbar) return 1;
-   if (ec->stack.prev) return 1;
-   if (_tasks_item_find(tasks, ec)) return 1;
-   if (!tasks->config) return 1;
+   if (ec->user_skip_winlist) return EINA_FALSE;
+   if (ec->netwm.state.skip_taskbar) return EINA_FALSE;
+   if (ec->stack.prev) return EINA_FALSE;
+   if (!tasks->config) return EINA_FALSE;
    if (!(tasks->config->show_all))
      {
-        if (ec->zone != tasks->zone) return 1;
+        if (ec->zone != tasks->zone) return EINA_FALSE;
         if ((ec->desk != e_desk_current_get(ec->zone)) &&
             (!ec->sticky))
-          return 1;
+          return EINA_FALSE;
      }
-   _tasks_item_add(tasks, ec);
-   return 0;
-}
-
-static void
-_tasks_item_add(Tasks *tasks, E_Client *ec)
-{
-   Tasks_Item *item;
-
-   item = _tasks_item_new(tasks, ec);
-   E_EXPAND(item->o_item);
-   E_FILL(item->o_item);
-   elm_box_pack_end(tasks->o_items, item->o_item);
-   tasks->items = eina_list_append(tasks->items, item);
+   return EINA_TRUE;
 }
 
 static void
@@ -643,6 +700,7 @@ _tasks_item_preview_del(Tasks_Item *item)
 static void
 _tasks_item_free(Tasks_Item *item)
 {
+   eina_hash_del_by_key(item->tasks->item_hash, &item->client);
    if (item->o_icon) evas_object_del(item->o_icon);
    if (e_object_is_del(E_OBJECT(item->client)))
      item->tasks->clients = eina_list_remove(item->tasks->clients, item->client);
@@ -657,7 +715,7 @@ _tasks_item_refill(Tasks_Item *item)
 {
    if (item->client->netwm.state.skip_taskbar != item->skip_taskbar)
      {
-        _tasks_refill(item->tasks);
+        _tasks_reconcile(item->tasks);
         return;
      }
    if (item->o_icon) evas_object_del(item->o_icon);
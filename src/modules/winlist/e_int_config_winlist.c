@@ -15,6 +15,7 @@ struct _E_Config_Dialog_Data
    int    iconified;
    int    iconified_other_desks;
    int    iconified_other_screens;
+   int    previews;
 
    int    focus, raise, uncover;
    int    warp_while_selecting;
@@ -75,6 +76,7 @@ _fill_data(E_Config_Dialog_Data *cfdata)
      e_config->winlist_list_show_other_desk_iconified;
    cfdata->iconified_other_screens =
      e_config->winlist_list_show_other_screen_iconified;
+   cfdata->previews = e_config->winlist_list_show_previews;
 
    cfdata->warp_while_selecting = e_config->winlist_warp_while_selecting;
    cfdata->warp_at_end = e_config->winlist_warp_at_end;
@@ -119,6 +121,7 @@ _basic_apply(E_Config_Dialog *cfd EINA_UNUSED, E_Config_Dialog_Data *cfdata)
    DO(list_show_other_screen_iconified, iconified_other_screens);
    DO(list_show_other_desk_windows, windows_other_desks);
    DO(list_show_other_screen_windows, windows_other_screens);
+   DO(list_show_previews, previews);
    DO(list_uncover_while_selecting, uncover);
    DO(list_jump_desk_while_selecting, jump_desk);
    DO(list_move_after_select, move_after_select);
@@ -155,6 +158,7 @@ _basic_check_changed(E_Config_Dialog *cfd EINA_UNUSED, E_Config_Dialog_Data *cfd
    DO(list_show_other_screen_iconified, iconified_other_screens);
    DO(list_show_other_desk_windows, windows_other_desks);
    DO(list_show_other_screen_windows, windows_other_screens);
+   DO(list_show_previews, previews);
    DO(list_uncover_while_selecting, uncover);
    DO(list_jump_desk_while_selecting, jump_desk);
    DO(list_move_after_select, move_after_select);
@@ -201,6 +205,8 @@ _basic_create(E_Config_Dialog *cfd EINA_UNUSED, Evas *evas, E_Config_Dialog_Data
                            &(cfdata->iconified_other_screens));
    e_widget_list_object_append(ol, ob, 1, 0, 0.0);
    e_widget_check_widget_disable_on_unchecked_add(iconified, ob);
+   ob = e_widget_check_add(evas, _("Window previews"), &(cfdata->previews));
+   e_widget_list_object_append(ol, ob, 1, 0, 0.0);
    e_widget_toolbook_page_append(otb, NULL, _("Display"), ol,
                                  1, 1, 1, 0, 0.0, 0.0);
 
@@ -1,19 +1,54 @@
 #include "e.h"
 #include "e_mod_main.h"
 
+/* rows past this many in the focus stack are unrealized on hide */
+#define E_WINLIST_ROWS_KEEP 64
+/* preview snapshots: longest side in (unscaled) pixels, refreshes per second */
+#define E_WINLIST_PREVIEW_SIZE 64
+#define E_WINLIST_PREVIEW_RATE 4.0
+
 /* local subsystem functions */
 typedef struct _E_Winlist_Win E_Winlist_Win;
 
+typedef enum
+{
+   E_WINLIST_WIN_STATE_NORMAL,
+   E_WINLIST_WIN_STATE_SHADED,
+   E_WINLIST_WIN_STATE_ICONIFIED,
+   E_WINLIST_WIN_STATE_INVISIBLE
+} E_Winlist_Win_State;
+
+/* one per client ever listed, kept until the client is freed so its row
+ * objects can be reused by the next show */
 struct _E_Winlist_Win
 {
-   Evas_Object  *bg_object;
-   Evas_Object  *icon_object;
-   E_Client     *client;
+   Evas_Object    *bg_object;
+   Evas_Object    *icon_object;
+   E_Client       *client;
+   E_Object_Delfn *delfn;
+   const char     *title; // label currently set on bg_object
+   Evas_Coord      w; // min width of bg_object
+   unsigned char   state; // E_Winlist_Win_State wanted for this show
+   unsigned char   shown_state; // state bg_object was told about
    unsigned char was_iconified E_BITFIELD;
    unsigned char was_shaded E_BITFIELD;
+   unsigned char listed E_BITFIELD;
+   unsigned char icon_dirty E_BITFIELD;
+   unsigned char preview E_BITFIELD; // icon_object is a snapshot
+   unsigned char previews E_BITFIELD; // previews were on when icon was set
+   unsigned char preview_dirty E_BITFIELD;
 };
 
 static void      _e_winlist_size_adjust(void);
+static void      _e_winlist_rows_update(void);
+static void      _e_winlist_win_realize(E_Winlist_Win *ww);
+static void      _e_winlist_win_unrealize(E_Winlist_Win *ww);
+static void      _e_winlist_win_update(E_Winlist_Win *ww);
+static void      _e_winlist_win_selected_set(E_Winlist_Win *ww, Eina_Bool selected);
+static void      _e_winlist_win_free_cb(void *data);
+static Eina_Bool _e_winlist_cache_trim_cb(const Eina_Hash *hash, const void *key, void *data, void *fdata);
+static void      _e_winlist_preview_queue(void);
+static Eina_Bool _e_winlist_cb_event_client_property(void *data, int type, void *event);
 static Eina_Bool _e_winlist_client_add(E_Client *ec, E_Zone *zone, E_Desk *desk);
 static void      _e_winlist_client_del(E_Client *ec);
 static void      _e_winlist_activate_nth(int n);
@@ -57,6 +92,23 @@ static double _scroll_align_to = 0.0;
 static double _scroll_align = 0.0;
 static Ecore_Timer *_scroll_timer = NULL;
 static Ecore_Animator *_animator = NULL;
+static Eina_Hash *_win_cache = NULL;
+static Eina_List *_cache_handlers = NULL;
+static Evas_Object *_spacer_top = NULL;
+static Evas_Object *_spacer_bottom = NULL;
+static Evas_Coord _row_h = 0;
+static Evas_Coord _list_h = 0;
+static int _row_first = -1;
+static int _row_last = -1;
+static Ecore_Timer *_preview_timer = NULL;
+
+static const char *_e_winlist_state_signals[] =
+{
+   NULL,
+   "e,state,shaded",
+   "e,state,iconified",
+   "e,state,invisible"
+};
 
 static Eina_Bool
 _wmclass_picked(const Eina_List *lst, const char *wmclass)
@@ -83,6 +135,8 @@ _cb_lost(void *data EINA_UNUSED)
 int
 e_winlist_init(void)
 {
+   _win_cache = eina_hash_pointer_new(_e_winlist_win_free_cb);
+   E_LIST_HANDLER_APPEND(_cache_handlers, E_EVENT_CLIENT_PROPERTY, _e_winlist_cb_event_client_property, NULL);
    return 1;
 }
 
@@ -90,6 +144,9 @@ int
 e_winlist_shutdown(void)
 {
    e_winlist_hide();
+   E_FREE_LIST(_cache_handlers, ecore_event_handler_del);
+   E_FREE_FUNC(_win_cache, eina_hash_free);
+   _row_h = 0;
    return 1;
 }
 
@@ -170,14 +227,24 @@ e_winlist_show(E_Zone *zone, E_Winlist_Filter filter)
    e_theme_edje_object_set(o, "base/theme/winlist",
                            "e/widgets/winlist/main");
 
+   /* not homogeneous: the spacers are taller than a row. rows all get
+    * _row_h as their height instead */
    o = elm_box_add(e_comp->elm);
    _list_object = o;
-   elm_box_homogeneous_set(o, 1);
    e_comp_object_util_del_list_append(_winlist, o);
    edje_object_part_swallow(_bg_object, "e.swallow.list", o);
    edje_object_part_text_set(_bg_object, "e.text.title", _("Select a window"));
    evas_object_show(o);
 
+   _spacer_top = o = evas_object_rectangle_add(e_comp->evas);
+   evas_object_color_set(o, 0, 0, 0, 0);
+   e_comp_object_util_del_list_append(_winlist, o);
+   _spacer_bottom = o = evas_object_rectangle_add(e_comp->evas);
+   evas_object_color_set(o, 0, 0, 0, 0);
+   e_comp_object_util_del_list_append(_winlist, o);
+   _list_h = h;
+   _row_first = _row_last = -1;
+
    _last_client = e_client_focused_get();
 
    desk = e_desk_current_get(_winlist_zone);
@@ -185,13 +252,17 @@ e_winlist_show(E_Zone *zone, E_Winlist_Filter filter)
      {
         Eina_Bool pick;
 
-        // skip if we already have it in winlist
-        EINA_LIST_FOREACH(_wins, ll, ww)
+        // skip if we already have it in winlist. only clients in a stack
+        // can share a stack bottom with one already listed
+        if ((ec->stack.prev) || (ec->stack.next))
           {
-             if (e_client_stack_bottom_get(ww->client) ==
-                 e_client_stack_bottom_get(ec)) break;
+             EINA_LIST_FOREACH(_wins, ll, ww)
+               {
+                  if (e_client_stack_bottom_get(ww->client) ==
+                      e_client_stack_bottom_get(ec)) break;
+               }
+             if (ll) continue;
           }
-        if (ll) continue;
         switch (filter)
           {
            case E_WINLIST_FILTER_CLASS_WINDOWS:
@@ -231,6 +302,8 @@ e_winlist_show(E_Zone *zone, E_Winlist_Filter filter)
 
    evas_event_thaw(e_comp->evas);
    _e_winlist_size_adjust();
+   /* cached previews show right away, refreshes follow at the capped rate */
+   if (e_config->winlist_list_show_previews) _e_winlist_preview_queue();
 
    E_LIST_HANDLER_APPEND(_handlers, E_EVENT_CLIENT_ADD, _e_winlist_cb_event_border_add, NULL);
    E_LIST_HANDLER_APPEND(_handlers, E_EVENT_CLIENT_REMOVE, _e_winlist_cb_event_border_remove, NULL);
@@ -250,6 +323,7 @@ e_winlist_hide(void)
 {
    E_Client *ec = NULL;
    E_Winlist_Win *ww;
+   int i;
 
    if (!_winlist) return;
    if (_win_selected)
@@ -258,14 +332,30 @@ e_winlist_hide(void)
         ec = ww->client;
      }
    evas_object_hide(_winlist);
+   /* rows outlive the popup: take them out of the box before it goes */
+   elm_box_unpack_all(_list_object);
+   eina_hash_foreach(_win_cache, _e_winlist_cache_trim_cb, NULL);
+   if (_win_selected) _e_winlist_win_selected_set(_win_selected->data, EINA_FALSE);
+   i = 0;
    EINA_LIST_FREE(_wins, ww)
      {
-        if ((!ec) || (ww->client != ec))
-          e_object_unref(E_OBJECT(ww->client));
-        free(ww);
+        E_Client *wec = ww->client;
+
+        ww->listed = 0;
+        if (ww->bg_object)
+          {
+             evas_object_hide(ww->bg_object);
+             if (i >= E_WINLIST_ROWS_KEEP) _e_winlist_win_unrealize(ww);
+          }
+        i++;
+        /* may free the client and with it ww */
+        if ((!ec) || (wec != ec))
+          e_object_unref(E_OBJECT(wec));
      }
    _win_selected = NULL;
    _icon_object = NULL;
+   _spacer_top = _spacer_bottom = NULL;
+   _row_first = _row_last = -1;
 
    evas_object_del(_winlist);
    e_client_focus_track_thaw();
@@ -279,6 +369,7 @@ e_winlist_hide(void)
 
    E_FREE_FUNC(_scroll_timer, ecore_timer_del);
    E_FREE_FUNC(_animator, ecore_animator_del);
+   E_FREE_FUNC(_preview_timer, ecore_timer_del);
 
 #ifndef HAVE_WAYLAND_ONLY
    if (e_comp->comp_type == E_PIXMAP_TYPE_X)
@@ -574,6 +665,313 @@ e_winlist_modifiers_set(int mod, E_Winlist_Activate_Type type)
 }
 
 /* local subsystem functions */
+static void
+_e_winlist_win_free_cb(void *data)
+{
+   E_Winlist_Win *ww = data;
+
+   _e_winlist_win_unrealize(ww);
+   if (ww->delfn) e_object_delfn_del(E_OBJECT(ww->client), ww->delfn);
+   free(ww);
+}
+
+static void
+_e_winlist_cb_client_free(void *data, void *obj EINA_UNUSED)
+{
+   E_Winlist_Win *ww = data;
+   E_Client *ec = ww->client;
+
+   ww->delfn = NULL;
+   eina_hash_del_by_key(_win_cache, &ec);
+}
+
+static E_Winlist_Win *
+_e_winlist_win_get(E_Client *ec)
+{
+   E_Winlist_Win *ww;
+
+   ww = eina_hash_find(_win_cache, &ec);
+   if (ww) return ww;
+   ww = E_NEW(E_Winlist_Win, 1);
+   if (!ww) return NULL;
+   ww->client = ec;
+   ww->delfn = e_object_delfn_add(E_OBJECT(ec), _e_winlist_cb_client_free, ww);
+   eina_hash_add(_win_cache, &ec, ww);
+   return ww;
+}
+
+static Eina_Bool
+_e_winlist_cache_trim_cb(const Eina_Hash *hash EINA_UNUSED, const void *key EINA_UNUSED,
+                         void *data, void *fdata EINA_UNUSED)
+{
+   E_Winlist_Win *ww = data;
+
+   /* not listed this time around: don't hold on to its objects */
+   if ((!ww->listed) && (ww->bg_object)) _e_winlist_win_unrealize(ww);
+   return EINA_TRUE;
+}
+
+static void
+_e_winlist_preview_size_get(E_Client *ec, int *w, int *h)
+{
+   int cw = 0, ch = 0, sz;
+
+   sz = E_WINLIST_PREVIEW_SIZE * e_scale;
+   evas_object_geometry_get(ec->frame, NULL, NULL, &cw, &ch);
+   if ((cw < 1) || (ch < 1)) cw = ch = 1;
+   if (cw >= ch)
+     {
+        *w = sz;
+        *h = MAX(1, (ch * sz) / cw);
+     }
+   else
+     {
+        *w = MAX(1, (cw * sz) / ch);
+        *h = sz;
+     }
+}
+
+static Eina_Bool
+_e_winlist_preview_snapshot(E_Winlist_Win *ww, Evas_Object *o)
+{
+   int w, h;
+
+   _e_winlist_preview_size_get(ww->client, &w, &h);
+   if (!e_comp_object_util_mirror_snapshot(ww->client->frame, o, w, h))
+     return EINA_FALSE;
+   evas_object_size_hint_aspect_set(o, EVAS_ASPECT_CONTROL_BOTH, w, h);
+   return EINA_TRUE;
+}
+
+static Eina_Bool
+_e_winlist_preview_cb(void *data EINA_UNUSED)
+{
+   E_Winlist_Win *ww;
+   Eina_List *l;
+   Eina_Bool updated = EINA_FALSE;
+
+   /* rows out of view stay dirty until they scroll in */
+   EINA_LIST_FOREACH(_wins, l, ww)
+     {
+        if ((!ww->preview) || (!ww->preview_dirty)) continue;
+        if (!evas_object_visible_get(ww->bg_object)) continue;
+        ww->preview_dirty = 0;
+        /* on failure keep showing the previous snapshot */
+        _e_winlist_preview_snapshot(ww, ww->icon_object);
+        updated = EINA_TRUE;
+     }
+   /* keep ticking while there is work so the next update is held back */
+   if (updated) return ECORE_CALLBACK_RENEW;
+   _preview_timer = NULL;
+   return ECORE_CALLBACK_CANCEL;
+}
+
+static void
+_e_winlist_preview_queue(void)
+{
+   if (_preview_timer) return;
+   _preview_timer = ecore_timer_loop_add(1.0 / E_WINLIST_PREVIEW_RATE,
+                                         _e_winlist_preview_cb, NULL);
+}
+
+static void
+_e_winlist_cb_preview_dirty(void *data, Evas_Object *obj EINA_UNUSED, void *event_info EINA_UNUSED)
+{
+   E_Winlist_Win *ww = data;
+
+   ww->preview_dirty = 1;
+   if (_winlist) _e_winlist_preview_queue();
+}
+
+static void
+_e_winlist_win_icon_del(E_Winlist_Win *ww)
+{
+   if ((ww->preview) && (ww->client->frame))
+     evas_object_smart_callback_del_full(ww->client->frame, "dirty",
+                                         _e_winlist_cb_preview_dirty, ww);
+   ww->preview = 0;
+   ww->preview_dirty = 0;
+   E_FREE_FUNC(ww->icon_object, evas_object_del);
+}
+
+static void
+_e_winlist_win_icon_set(E_Winlist_Win *ww)
+{
+   Evas_Object *o = NULL;
+
+   _e_winlist_win_icon_del(ww);
+   ww->icon_dirty = 0;
+   ww->previews = !!e_config->winlist_list_show_previews;
+   if (!edje_object_part_exists(ww->bg_object, "e.swallow.icon")) return;
+   if ((ww->previews) && (ww->client->frame))
+     {
+        o = evas_object_image_filled_add(e_comp->evas);
+        evas_object_image_smooth_scale_set(o, e_comp_config_get()->smooth_windows);
+        if (_e_winlist_preview_snapshot(ww, o))
+          {
+             ww->preview = 1;
+             evas_object_smart_callback_add(ww->client->frame, "dirty",
+                                            _e_winlist_cb_preview_dirty, ww);
+          }
+        /* no cpu-side pixels (native surface): show the icon instead */
+        else E_FREE_FUNC(o, evas_object_del);
+     }
+   if (!o) o = e_client_icon_add(ww->client, e_comp->evas);
+   ww->icon_object = o;
+   edje_object_part_swallow(ww->bg_object, "e.swallow.icon", o);
+   evas_object_show(o);
+}
+
+static Eina_Bool
+_e_winlist_win_title_set(E_Winlist_Win *ww, const char *title)
+{
+   if ((ww->title) && (eina_streq(ww->title, title))) return EINA_FALSE;
+   eina_stringshare_replace(&ww->title, title);
+   edje_object_part_text_set(ww->bg_object, "e.text.label", title);
+   return EINA_TRUE;
+}
+
+static void
+_e_winlist_win_size_calc(E_Winlist_Win *ww)
+{
+   Evas_Coord mw, mh;
+
+   edje_object_size_min_calc(ww->bg_object, &mw, &mh);
+   ww->w = mw;
+   /* rows all get the height of the tallest one seen so far */
+   if (mh > _row_h)
+     {
+        _row_h = mh;
+        _row_first = -1;
+     }
+}
+
+/* bring a realized row in line with its client */
+static void
+_e_winlist_win_update(E_Winlist_Win *ww)
+{
+   Eina_Bool changed = EINA_FALSE;
+
+   if (ww->state != ww->shown_state)
+     {
+        /* the item theme has no way back to the normal state */
+        if (ww->shown_state != E_WINLIST_WIN_STATE_NORMAL)
+          {
+             _e_winlist_win_unrealize(ww);
+             _e_winlist_win_realize(ww);
+             return;
+          }
+        edje_object_signal_emit(ww->bg_object,
+                                _e_winlist_state_signals[ww->state], "e");
+        ww->shown_state = ww->state;
+        changed = EINA_TRUE;
+     }
+   if ((ww->icon_dirty) ||
+       (ww->previews != !!e_config->winlist_list_show_previews))
+     {
+        _e_winlist_win_icon_set(ww);
+        changed = EINA_TRUE;
+     }
+   if (_e_winlist_win_title_set(ww, e_client_util_name_get
+                                (e_client_stack_active_adjust(ww->client))))
+     changed = EINA_TRUE;
+   if (changed) _e_winlist_win_size_calc(ww);
+}
+
+static void
+_e_winlist_win_realize(E_Winlist_Win *ww)
+{
+   Evas_Object *o;
+
+   if (ww->bg_object) return;
+   o = edje_object_add(e_comp->evas);
+   ww->bg_object = o;
+   e_theme_edje_object_set(o, "base/theme/winlist",
+                           "e/widgets/winlist/item");
+   E_WEIGHT(o, 1, 0);
+   E_FILL(o);
+   ww->shown_state = E_WINLIST_WIN_STATE_NORMAL;
+   ww->icon_dirty = 1;
+   _e_winlist_win_update(ww);
+}
+
+static void
+_e_winlist_win_unrealize(E_Winlist_Win *ww)
+{
+   _e_winlist_win_icon_del(ww);
+   E_FREE_FUNC(ww->bg_object, evas_object_del);
+   eina_stringshare_replace(&ww->title, NULL);
+   _row_first = -1;
+}
+
+static void
+_e_winlist_win_selected_set(E_Winlist_Win *ww, Eina_Bool selected)
+{
+   const char *sig = selected ? "e,state,selected" : "e,state,unselected";
+
+   if (!ww->bg_object) return;
+   edje_object_signal_emit(ww->bg_object, sig, "e");
+   if ((ww->icon_object) && (!ww->preview) && e_icon_edje_get(ww->icon_object))
+     e_icon_edje_emit(ww->icon_object, sig, "e");
+}
+
+/* keep the rows within a page of the visible part of the list realized and
+ * let two spacers stand in for the rest, so the list costs about the same
+ * to show with ten windows as with a thousand */
+static void
+_e_winlist_rows_update(void)
+{
+   E_Winlist_Win *ww;
+   Eina_List *l;
+   Evas_Coord over;
+   int i, n, top, vis, first, last;
+
+   if ((!_wins) || (!_spacer_top)) return;
+   /* the first row realized gives the row height */
+   if (_row_h < 1) _e_winlist_win_realize(eina_list_data_get(_wins));
+   if (_row_h < 1) _row_h = 1;
+   n = eina_list_count(_wins);
+   vis = (_list_h / _row_h) + 1;
+   over = (n * _row_h) - _list_h;
+   if (over < 0) over = 0;
+   /* the box lays out overflowing content at (1 - align) */
+   top = (_scroll_align * over) / _row_h;
+   first = MAX(top - vis, 0);
+   last = MIN(top + (2 * vis), n - 1);
+   if ((first == _row_first) && (last == _row_last)) return;
+   _row_first = first;
+   _row_last = last;
+
+   evas_event_freeze(e_comp->evas);
+   elm_box_unpack_all(_list_object);
+   i = 0;
+   EINA_LIST_FOREACH(_wins, l, ww)
+     {
+        if (((i < first) || (i > last)) && (ww->bg_object))
+          evas_object_hide(ww->bg_object);
+        i++;
+     }
+   evas_object_size_hint_min_set(_spacer_top, 0, first * _row_h);
+   elm_box_pack_end(_list_object, _spacer_top);
+   evas_object_show(_spacer_top);
+   i = 0;
+   EINA_LIST_FOREACH(_wins, l, ww)
+     {
+        if (i > last) break;
+        if (i++ < first) continue;
+        _e_winlist_win_realize(ww);
+        evas_object_size_hint_min_set(ww->bg_object, ww->w, _row_h);
+        evas_object_size_hint_max_set(ww->bg_object, 9999, _row_h);
+        elm_box_pack_end(_list_object, ww->bg_object);
+        evas_object_show(ww->bg_object);
+     }
+   evas_object_size_hint_min_set(_spacer_bottom, 0, (n - 1 - last) * _row_h);
+   elm_box_pack_end(_list_object, _spacer_bottom);
+   evas_object_show(_spacer_bottom);
+   evas_event_thaw(e_comp->evas);
+   if (e_config->winlist_list_show_previews) _e_winlist_preview_queue();
+}
+
 static void
 _e_winlist_size_adjust(void)
 {
@@ -604,14 +1002,16 @@ _e_winlist_size_adjust(void)
    y = zone->y + (double)(zone->h - h) * e_config->winlist_pos_align_y;
 
    evas_object_geometry_set(_winlist, x, y, w, h);
+   /* the whole popup, not just the list, but close enough to pick rows */
+   _list_h = h;
+   _e_winlist_rows_update();
 }
 
 static Eina_Bool
 _e_winlist_client_add(E_Client *ec, E_Zone *zone, E_Desk *desk)
 {
    E_Winlist_Win *ww;
-   Evas_Coord mw, mh;
-   Evas_Object *o;
+   E_Winlist_Win_State state = E_WINLIST_WIN_STATE_NORMAL;
 
    if ((!ec->icccm.accepts_focus) &&
        (!ec->icccm.take_focus)) return EINA_FALSE;
@@ -652,44 +1052,26 @@ _e_winlist_client_add(E_Client *ec, E_Zone *zone, E_Desk *desk)
           }
      }
 
-   ww = E_NEW(E_Winlist_Win, 1);
+   ww = _e_winlist_win_get(ec);
    if (!ww) return EINA_FALSE;
-   ww->client = ec;
-   _wins = eina_list_append(_wins, ww);
-   o = edje_object_add(e_comp->evas);
-   E_FILL(o);
-   e_comp_object_util_del_list_append(_winlist, o);
-   ww->bg_object = o;
-   e_theme_edje_object_set(o, "base/theme/winlist",
-                           "e/widgets/winlist/item");
-   edje_object_part_text_set(o, "e.text.label",
-                             e_client_util_name_get
-                             (e_client_stack_active_adjust(ww->client)));
-   evas_object_show(o);
-   if (edje_object_part_exists(ww->bg_object, "e.swallow.icon"))
-     {
-        o = e_client_icon_add(ec, e_comp->evas);
-        ww->icon_object = o;
-        e_comp_object_util_del_list_append(_winlist, o);
-        edje_object_part_swallow(ww->bg_object, "e.swallow.icon", o);
-        evas_object_show(o);
-     }
    if (ec->shaded)
-     edje_object_signal_emit(ww->bg_object, "e,state,shaded", "e");
+     state = E_WINLIST_WIN_STATE_SHADED;
    else if (ec->iconic)
-     edje_object_signal_emit(ww->bg_object, "e,state,iconified", "e");
+     state = E_WINLIST_WIN_STATE_ICONIFIED;
    else if (ec->desk != desk)
      {
         if (!((ec->sticky) && (ec->zone == zone)))
-          edje_object_signal_emit(ww->bg_object, "e,state,invisible", "e");
+          state = E_WINLIST_WIN_STATE_INVISIBLE;
      }
-
-   edje_object_size_min_calc(ww->bg_object, &mw, &mh);
-   E_WEIGHT(ww->bg_object, 1, 0);
-   E_FILL(ww->bg_object);
-   evas_object_size_hint_min_set(ww->bg_object, mw, mh);
-   evas_object_size_hint_max_set(ww->bg_object, 9999, mh);
-   elm_box_pack_end(_list_object, ww->bg_object);
+   ww->state = state;
+   ww->listed = 1;
+   ww->was_iconified = 0;
+   ww->was_shaded = 0;
+   _wins = eina_list_append(_wins, ww);
+   /* rows are realized on demand by _e_winlist_rows_update(), cached ones
+    * only need to catch up with what changed since the last show */
+   if (ww->bg_object) _e_winlist_win_update(ww);
+   _row_first = -1;
    e_object_ref(E_OBJECT(ww->client));
    return EINA_TRUE;
 }
@@ -705,7 +1087,6 @@ _e_winlist_client_del(E_Client *ec)
      {
         if (ww->client == ec)
           {
-             e_object_unref(E_OBJECT(ww->client));
              if (l == _win_selected)
                {
                   _win_selected = l->next;
@@ -713,15 +1094,11 @@ _e_winlist_client_del(E_Client *ec)
                   _e_winlist_show_active();
                   _e_winlist_activate();
                }
-             e_comp_object_util_del_list_remove(_winlist, ww->bg_object);
-             evas_object_del(ww->bg_object);
-             if (ww->icon_object)
-               {
-                  e_comp_object_util_del_list_remove(_winlist, ww->icon_object);
-                  evas_object_del(ww->icon_object);
-               }
-             E_FREE(ww);
              _wins = eina_list_remove_list(_wins, l);
+             _row_first = -1;
+             /* the client is going away, no point in caching its row */
+             eina_hash_del_by_key(_win_cache, &ec);
+             e_object_unref(E_OBJECT(ec));
              return;
           }
      }
@@ -737,15 +1114,13 @@ _e_winlist_client_replace(E_Client *ec, E_Client *ec_new)
      {
         if (ww->client == ec)
           {
-             Evas_Coord mw, mh;
-
-             edje_object_part_text_set(ww->bg_object, "e.text.label",
-                                       e_client_util_name_get(ec_new));
-             edje_object_size_min_calc(ww->bg_object, &mw, &mh);
-             E_WEIGHT(ww->bg_object, 1, 0);
-             E_FILL(ww->bg_object);
-             evas_object_size_hint_min_set(ww->bg_object, mw, mh);
-             evas_object_size_hint_max_set(ww->bg_object, 9999, mh);
+             /* unrealized rows pick up the new name when realized */
+             if (!ww->bg_object) return;
+             if (_e_winlist_win_title_set(ww, e_client_util_name_get(ec_new)))
+               {
+                  _e_winlist_win_size_calc(ww);
+                  _row_first = -1;
+               }
              return;
           }
      }
@@ -777,9 +1152,9 @@ _e_winlist_activate(void)
 
    if (!_win_selected) return;
    ww = _win_selected->data;
-   edje_object_signal_emit(ww->bg_object, "e,state,selected", "e");
-   if (ww->icon_object && e_icon_edje_get(ww->icon_object))
-     e_icon_edje_emit(ww->icon_object, "e,state,selected", "e");
+   /* the row may still be out of view while scrolling catches up */
+   _e_winlist_win_realize(ww);
+   _e_winlist_win_selected_set(ww, EINA_TRUE);
 
    if ((ww->client->iconic) &&
        (e_config->winlist_list_uncover_while_selecting))
@@ -871,9 +1246,7 @@ _e_winlist_deactivate(void)
    ww->was_shaded = 0;
    ww->was_iconified = 0;
    edje_object_part_text_set(_bg_object, "e.text.label", "");
-   edje_object_signal_emit(ww->bg_object, "e,state,unselected", "e");
-   if (ww->icon_object && e_icon_edje_get(ww->icon_object))
-     e_icon_edje_emit(ww->icon_object, "e,state,unselected", "e");
+   _e_winlist_win_selected_set(ww, EINA_FALSE);
    if (!ww->client->lock_focus_in)
      evas_object_focus_set(ww->client->frame, 0);
 }
@@ -890,7 +1263,11 @@ _e_winlist_show_active(void)
      if (l == _win_selected) break;
 
    n = eina_list_count(_wins);
-   if (n <= 1) return;
+   if (n <= 1)
+     {
+        _e_winlist_rows_update();
+        return;
+     }
    _scroll_align_to = (double)i / (double)(n - 1);
    if (e_config->winlist_scroll_animate)
      {
@@ -904,6 +1281,7 @@ _e_winlist_show_active(void)
      {
         _scroll_align = _scroll_align_to;
         elm_box_align_set(_list_object, 0.5, fabs(1.0 - _scroll_align));
+        _e_winlist_rows_update();
      }
 }
 
@@ -954,6 +1332,22 @@ done:
    return ECORE_CALLBACK_PASS_ON;
 }
 
+static Eina_Bool
+_e_winlist_cb_event_client_property(void *data EINA_UNUSED, int type EINA_UNUSED,
+                                    void *event)
+{
+   E_Event_Client_Property *ev = event;
+   E_Winlist_Win *ww;
+
+   if (!(ev->property & E_CLIENT_PROPERTY_ICON)) return ECORE_CALLBACK_PASS_ON;
+   ww = eina_hash_find(_win_cache, &ev->ec);
+   if ((!ww) || (!ww->bg_object) || (ww->preview)) return ECORE_CALLBACK_PASS_ON;
+   /* cached rows pick the new icon up on the next show */
+   if (ww->listed) _e_winlist_win_icon_set(ww);
+   else ww->icon_dirty = 1;
+   return ECORE_CALLBACK_PASS_ON;
+}
+
 static Eina_Bool
 _e_winlist_cb_event_border_remove(void *data EINA_UNUSED, int type EINA_UNUSED,
                                   void *event)
@@ -1209,6 +1603,7 @@ _e_winlist_animator(void *data EINA_UNUSED)
              _scroll_to = 0;
           }
         elm_box_align_set(_list_object, 0.5, fabs(1.0 - _scroll_align));
+        _e_winlist_rows_update();
      }
    if (!_scroll_to) _animator = NULL;
    return _scroll_to;